@@ -1,99 +1,333 @@
 #include "applicationmanager.hpp"
 
-#include <algorithm>
-#include <fstream>
-#include <random>
-#include <ranges>
+#include <iterator>
 
+#include "profiler.hpp"
 #include "scalemanager.hpp"
 
+void ApplicationManager::load_scales(const std::string& path)
+{
+    auto sm = std::make_shared<ScaleManager>();
+    sm->load_scales_from_file(path);
+    _sm = std::move(sm);
+}
+
+void ApplicationManager::load_default_scales()
+{
+    auto sm = std::make_shared<ScaleManager>();
+    sm->load_default_scales();
+    _sm = std::move(sm);
+}
+
+void ApplicationManager::set_seed(std::uint64_t seed)
+{
+    _sampling_engine = make_stream(seed, 0);
+    _engine = make_stream(seed, 1);
+}
+
+void ApplicationManager::set_learner(LearnerModel::State* learner)
+{
+    _learner = learner;
+    _learner_model.reset();
+}
+
 void ApplicationManager::generate_session(size_t number_of_questions,
                                           ScaleManager::Difficulty difficulty)
 {
-    if (_sm._entries.size() == 0)
+    if (_lazy.has_value())
+    {
+        if (can_print_more())
+        {
+            throw std::runtime_error(LAZY_SESSION_CANNOT_GROW);
+        }
+        // A finished lazy session is replaced, as it only holds its last question
+        _lazy.reset();
+        _session.clear();
+        _answers.clear();
+        _number_of_questions = 0;
+        _first_question = 0;
+        _question_index = 0;
+        _correct = 0;
+    }
+    // Questions added to a session come from the same scales as those already in it
+    if (_session.empty()) _snapshot = _sm->snapshot();
+    if (_snapshot->number_of_scales() == 0)
     {
         throw std::runtime_error(FORGOT_TO_LOAD_SCALES);
     }
 
-    auto generated_scales =
-        _sm.generate_realised_scales_by_difficulty(number_of_questions, difficulty);
+    std::vector<size_t> scales;
+    std::vector<size_t> roots;
+    if (_learner != nullptr)
+    {
+        _learner_model.emplace(*_learner, _snapshot, difficulty);
+        scales = _learner_model->sample_scale_indices(number_of_questions, _sampling_engine);
+        roots = _learner_model->sample_root_indices(number_of_questions, _sampling_engine);
+    }
+    else
+    {
+        scales = _snapshot->sample_scale_indices_by_difficulty(number_of_questions, difficulty,
+                                                               _sampling_engine);
+        roots = _snapshot->sample_root_indices_by_difficulty(number_of_questions, difficulty,
+                                                             _sampling_engine);
+    }
 
-    auto rd = std::mt19937{std::random_device{}()};
+    _session.reserve(_session.size() + number_of_questions);
+    for (size_t i = 0; i < number_of_questions; ++i)
+    {
+        // Options are picked by index, so no names get compared or copied
+        std::array<std::uint32_t, NUMBER_OF_CHOICES> options;
+        size_t correct_index = _snapshot->sample_options(scales[i], options, _engine);
 
-    for (auto&& scale : generated_scales)
+        // Realised straight into the session's memory resource, so emplacing it copies nothing
+        _session.emplace_back(
+            _snapshot->realise_entry(scales[i], roots[i], _session.get_allocator()),
+            static_cast<std::uint32_t>(roots[i]), options, correct_index);
+    }
+    _number_of_questions += number_of_questions;
+}
+
+void ApplicationManager::generate_lazy_session(size_t number_of_questions,
+                                               ScaleManager::Difficulty difficulty)
+{
+    _snapshot = _sm->snapshot();
+    if (_snapshot->number_of_scales() == 0)
+    {
+        throw std::runtime_error(FORGOT_TO_LOAD_SCALES);
+    }
+    if (_learner != nullptr)
     {
-        // Need to copy because of std::ranges::shuffle
-        std::vector<std::string> possible_names{scale.get_name()};
+        _learner_model.emplace(*_learner, _snapshot, difficulty);
+    }
+    else
+    {
+        _learner_model.reset();
+    }
 
-        auto not_same_names = std::views::filter(
-            _sm._scale_names, [scale](std::string& name) { return name != scale.get_name(); });
+    _session.clear();
+    _answers.clear();
+    _number_of_questions = number_of_questions;
+    _first_question = 0;
+    _question_index = 0;
+    _correct = 0;
 
-        std::sample(not_same_names.begin(), not_same_names.end(),
-                    std::back_inserter(possible_names), NUMBER_OF_CHOICES - 1, rd);
+    // An eager session draws every scale before the first root, and a draw doesn't always use up
+    // the same amount of the engine, so the roots' engine is found by drawing (and dropping) every
+    // scale once. That takes time linear in the number of questions, but no memory. A learner's
+    // draws depend on their answers so they can't match anyway, but the roots still get an engine
+    // of their own this way.
+    RandomEngine root_engine = _sampling_engine;
+    {
+        SCALES_PROFILE_PHASE(SCALE_SAMPLING);
+        for (size_t i = 0; i < number_of_questions; ++i)
+        {
+            _snapshot->sample_scale_index(difficulty, root_engine);
+        }
+    }
+    _lazy = LazySession{difficulty, root_engine};
 
-        std::ranges::shuffle(possible_names, rd);
-        auto comp = [scale](std::string& str) { return str == scale.get_name(); };
+    if (number_of_questions > 0)
+    {
+        generate_lazy_question();
+    }
+    else
+    {
+        _sampling_engine = _lazy->_root_engine;
+    }
+}
+
+void ApplicationManager::generate_lazy_question()
+{
+    size_t scale_index;
+    size_t root_index;
+    {
+        SCALES_PROFILE_PHASE(SCALE_SAMPLING);
+        scale_index = _learner_model.has_value()
+                          ? _learner_model->sample_scale_index(_sampling_engine)
+                          : _snapshot->sample_scale_index(_lazy->_difficulty, _sampling_engine);
+    }
+    {
+        SCALES_PROFILE_PHASE(ROOT_SAMPLING);
+        root_index = _learner_model.has_value()
+                         ? _learner_model->sample_root_index(_lazy->_root_engine)
+                         : _snapshot->sample_root_index(_lazy->_difficulty, _lazy->_root_engine);
+    }
+    std::array<std::uint32_t, NUMBER_OF_CHOICES> options;
+    size_t correct_index = _snapshot->sample_options(scale_index, options, _engine);
 
-        auto it = std::find_if(possible_names.begin(), possible_names.end(), comp);
-        size_t index = static_cast<size_t>(it - possible_names.begin());
+    _session.clear();
+    _session.emplace_back(
+        _snapshot->realise_entry(scale_index, root_index, _session.get_allocator()),
+        static_cast<std::uint32_t>(root_index), options, correct_index);
+    _first_question = _question_index;
 
-        _session.emplace_back(std::move(scale), std::move(possible_names), index);
+    // Leaves the sampling engine where an eager session would, so later sessions match too
+    if (_question_index + 1 == _number_of_questions)
+    {
+        _sampling_engine = _lazy->_root_engine;
     }
 }
 
+void ApplicationManager::next_question()
+{
+    ++_question_index;
+    if (_lazy.has_value() && _question_index < _number_of_questions) generate_lazy_question();
+}
+
 void ApplicationManager::print_header(std::ostream& stream)
 {
+    SCALES_PROFILE_PHASE(RENDERING);
     // Not going to move all this into constants, they only appear in one method
-    stream << "On question " << _question_index + 1 << '/' << _session.size() << std::endl;
+    stream << "On question " << _question_index + 1 << '/' << _number_of_questions << '\n';
 }
 
 void ApplicationManager::print_question(std::ostream& stream)
 {
-    if (_question_index >= _session.size()) throw std::runtime_error(TOO_MANY_QUESTION_PRINTS);
-    auto& current_q = _session[_question_index];
-    stream << current_q._rs.get_scale() << std::endl;
+    SCALES_PROFILE_PHASE(RENDERING);
+    if (_question_index >= _number_of_questions)
+    {
+        throw std::runtime_error(TOO_MANY_QUESTION_PRINTS);
+    }
+    auto& current_q = current_question();
+    // Flushed once, with the last option
+    stream << current_q._rs.get_scale() << '\n';
+    for (size_t i = 0; i < NUMBER_OF_CHOICES; ++i)
+    {
+        stream << i + 1 << ": " << _snapshot->get_scale_name(current_q._options[i]) << '\n';
+    }
+    stream.flush();
+    _question_shown = std::chrono::steady_clock::now();
+}
+
+void ApplicationManager::compose_question_frame(std::vector<std::string>& lines)
+{
+    SCALES_PROFILE_PHASE(RENDERING);
+    if (_question_index >= _number_of_questions)
+    {
+        throw std::runtime_error(TOO_MANY_QUESTION_PRINTS);
+    }
+    auto& current_q = current_question();
+    lines.resize(2 + NUMBER_OF_CHOICES);
+    for (auto& line : lines) line.clear();
+
+    auto header = std::back_inserter(lines[0]);
+    header = format_string_to(header, "On question ");
+    header = format_integer_to(header, _question_index + 1);
+    *header++ = '/';
+    format_integer_to(header, _number_of_questions);
+
+    current_q._rs.get_scale().format_to(std::back_inserter(lines[1]));
     for (size_t i = 0; i < NUMBER_OF_CHOICES; ++i)
     {
-        stream << i + 1 << ": " << current_q._options[i] << std::endl;
+        auto option = std::back_inserter(lines[2 + i]);
+        option = format_integer_to(option, i + 1);
+        option = format_string_to(option, ": ");
+        format_string_to(option, _snapshot->get_scale_name(current_q._options[i]));
     }
+    _question_shown = std::chrono::steady_clock::now();
 }
 
 void ApplicationManager::load_answer(std::istream& stream)
 {
     size_t answer;
     stream >> answer;
+    submit_answer(answer);
+}
+
+bool ApplicationManager::submit_answer(size_t answer)
+{
+    auto latency = std::chrono::steady_clock::now() - _question_shown;
+    auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(latency);
     size_t guessed_index = answer - 1;
-    if (guessed_index == _session[_question_index]._correct_index)
+    const Question& question = current_question();
+    size_t scale_index = question._options[question._correct_index];
+    Answer submitted{guessed_index == question._correct_index,
+                     static_cast<std::uint32_t>(milliseconds.count())};
+    if (submitted._correct) ++_correct;
+    if (!_lazy.has_value()) _answers.push_back(submitted);
+    if (_learner_model.has_value())
     {
-        ++_correct;
-        _correct_questions.emplace_back(true);
+        _learner_model->record(scale_index, question._root_index, submitted._correct,
+                               milliseconds);
     }
-    else
+    if (_latency_stats != nullptr) _latency_stats->record(*_snapshot, scale_index, latency);
+    if (_results != nullptr)
     {
-        _correct_questions.emplace_back(false);
+        SCALES_PROFILE_PHASE(RESULTS_SAVING);
+        _results->write(result_of(question, submitted));
     }
+    return submitted._correct;
+}
+
+void ApplicationManager::write_question_line(std::string& out)
+{
+    SCALES_PROFILE_PHASE(RENDERING);
+    if (_question_index >= _number_of_questions)
+    {
+        throw std::runtime_error(TOO_MANY_QUESTION_PRINTS);
+    }
+    auto& current_q = current_question();
+    auto it = std::back_inserter(out);
+    it = format_integer_to(it, _question_index + 1);
+    *it++ = '/';
+    it = format_integer_to(it, _number_of_questions);
+    *it++ = CSV_SEPERATOR;
+    it = current_q._rs.get_scale().format_to(it);
+    for (size_t i = 0; i < NUMBER_OF_CHOICES; ++i)
+    {
+        *it++ = CSV_SEPERATOR;
+        it = format_string_to(it, _snapshot->get_scale_name(current_q._options[i]));
+    }
+    _question_shown = std::chrono::steady_clock::now();
 }
 
 // Uses ANSI characters to wipe the terminal. Should work cross-platform to some extent
 void ApplicationManager::clear_stream(std::ostream& stream) { stream << "\033[2J\033[H"; }
 
-void ApplicationManager::save_session_results(const std::string& file_path)
+void ApplicationManager::save_session_results(const std::string& file_path,
+                                              const ResultsSink::Options& options)
 {
-    std::ofstream file(file_path);
-    if (!file.good())
+    SCALES_PROFILE_PHASE(RESULTS_SAVING);
+    if (_lazy.has_value())
     {
-        throw std::runtime_error(BAD_FILE_OPEN);
+        throw std::runtime_error(LAZY_SESSION_KEEPS_NO_RESULTS);
     }
+    ResultsSink sink{file_path, options};
+    write_session_results(sink);
+    sink.close();
+}
 
-    file << RESULTS_FILE_HEADER << std::endl;
-
+void ApplicationManager::write_session_results(ResultsSink& sink) const
+{
+    if (_lazy.has_value())
+    {
+        throw std::runtime_error(LAZY_SESSION_KEEPS_NO_RESULTS);
+    }
     for (size_t i = 0; i < _session.size(); ++i)
     {
-        file << _session[i]._rs.get_scale().get_root().get_name() << ' '
-             << _session[i]._rs.get_name() << CSV_SEPERATOR
-             << (size_t)_session[i]._rs.get_difficulty() << CSV_SEPERATOR
-             << (_correct_questions[i] ? CORRECT : INCORRECT) << std::endl;
+        sink.write(result_of(_session[i], _answers[i]));
     }
+}
+
+void ApplicationManager::open_session_results(const std::string& file_path,
+                                              const ResultsSink::Options& options)
+{
+    SCALES_PROFILE_PHASE(RESULTS_SAVING);
+    _results = std::make_unique<ResultsSink>(file_path, options);
+}
 
-    file.close();
+void ApplicationManager::close_session_results()
+{
+    SCALES_PROFILE_PHASE(RESULTS_SAVING);
+    if (_results == nullptr) return;
+    _results->close();
+    _results.reset();
+}
+
+ResultsSink::Result ApplicationManager::result_of(const Question& question,
+                                                  const Answer& answer) const
+{
+    return {_sm->get_root_name(question._root_index), question._rs.get_name(),
+            static_cast<std::uint8_t>(question._rs.get_difficulty()), answer._correct,
+            answer._milliseconds};
 }
\ No newline at end of file
@@ -1,40 +1,66 @@
 #ifndef APPLICATIONMANAGER
 #define APPLICATIONMANAGER
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "constants.hpp"
+#include "latencyhistogram.hpp"
+#include "learnermodel.hpp"
 #include "musiclibrary.hpp"
+#include "randomengine.hpp"
+#include "resultssink.hpp"
 #include "scalemanager.hpp"
 
-constexpr size_t NUMBER_OF_CHOICES = 4;
-constexpr char RESULTS_FILE_HEADER[] = "Name;Difficulty;Correctness";
-
 /**
  * @brief Class handling the entire application logic
  *
- * This class is expected to live from start of main till the very end of main
+ * In the interactive mode, this class is expected to live from start of main till the very end of
+ * main. In serve mode, every connection gets its own ApplicationManager, and they all share one
+ * loaded ScaleManager.
  *
  */
 class ApplicationManager
 {
    private:
     /**
-     * @brief Scale-related things are delegated to the contained ScaleManager.
+     * @brief Scale-related things are delegated to the ScaleManager. It is only ever read, so
+     * many ApplicationManagers can share the same one; load_scales replaces it with a new one.
      *
      */
-    ScaleManager _sm;
+    std::shared_ptr<const ScaleManager> _sm = std::make_shared<const ScaleManager>();
 
     /**
-     * @brief
+     * @brief The scales the current session is drawn from, taken from _sm when it starts. Its
+     * questions refer to these scales by index (and name), so the session holds on to them even if
+     * _sm reloads its scales in the meantime.
+     *
+     */
+    std::shared_ptr<const ScaleManager::Snapshot> _snapshot = _sm->snapshot();
+
+    /**
+     * @brief A single question of the session. Allocator-aware, so that a session built in a
+     * memory resource has its realised scales there as well.
      *
      */
     struct Question
     {
+       public:
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
        private:
         // Each question owns the ScaleEntry
         ScaleManager::ScaleEntry<RealisedScale> _rs;
-        // And a vector of strings of multiple choice names
-        // These are copied - again, not a huge problem for reasonable lenghts of a session
-        std::vector<std::string> _options;
+        // Which of the possible roots the scale is realised on, so its name is never regenerated
+        std::uint32_t _root_index;
+        // And the multiple choice options, as indices of the loaded scales
+        std::array<std::uint32_t, NUMBER_OF_CHOICES> _options;
         size_t _correct_index;
 
        public:
@@ -42,39 +68,165 @@ class ApplicationManager
          * @brief Construct a new Question object (copying)
          *
          * @param rs - reference to the ScaleEntry containing information about the RealisedScale
-         * @param options - reference to the vector of multiple choice options
+         * @param root_index - index of the root of the RealisedScale among the possible roots
+         * @param options - reference to the scale indices of the multiple choice options
          * @param correct_index - the index to the correct answer in options
          */
-        Question(const ScaleManager::ScaleEntry<RealisedScale>& rs,
-                 const std::vector<std::string>& options, size_t correct_index)
-            : _rs(rs), _options(options), _correct_index(correct_index)
+        Question(const ScaleManager::ScaleEntry<RealisedScale>& rs, std::uint32_t root_index,
+                 const std::array<std::uint32_t, NUMBER_OF_CHOICES>& options, size_t correct_index)
+            : _rs(rs), _root_index(root_index), _options(options), _correct_index(correct_index)
         {
         }
 
         /**
-         * @brief Construct a new Question object (stealing)
+         * @brief Construct a new Question object (stealing the ScaleEntry)
          *
          * @param rs - ScaleEntry containing information about the RealisedScale
-         * @param options - vector of multiple choice options
+         * @param root_index - index of the root of the RealisedScale among the possible roots
+         * @param options - reference to the scale indices of the multiple choice options
+         * @param correct_index - the index to the correct answer in options
+         */
+        Question(ScaleManager::ScaleEntry<RealisedScale>&& rs, std::uint32_t root_index,
+                 const std::array<std::uint32_t, NUMBER_OF_CHOICES>& options, size_t correct_index)
+            : _rs(std::move(rs)),
+              _root_index(root_index),
+              _options(options),
+              _correct_index(correct_index)
+        {
+        }
+
+        /**
+         * @brief Construct a new Question object (copying the ScaleEntry), allocating with alloc
+         *
+         * @param rs - reference to the ScaleEntry containing information about the RealisedScale
+         * @param root_index - index of the root of the RealisedScale among the possible roots
+         * @param options - reference to the scale indices of the multiple choice options
          * @param correct_index - the index to the correct answer in options
+         * @param alloc - allocator for the RealisedScale
          */
-        Question(ScaleManager::ScaleEntry<RealisedScale>&& rs, std::vector<std::string>&& options,
-                 size_t correct_index)
-            : _rs(std::move(rs)), _options(std::move(options)), _correct_index(correct_index)
+        Question(const ScaleManager::ScaleEntry<RealisedScale>& rs, std::uint32_t root_index,
+                 const std::array<std::uint32_t, NUMBER_OF_CHOICES>& options, size_t correct_index,
+                 const allocator_type& alloc)
+            : _rs(rs, alloc),
+              _root_index(root_index),
+              _options(options),
+              _correct_index(correct_index)
+        {
+        }
+
+        /**
+         * @brief Construct a new Question object (stealing the ScaleEntry), allocating with alloc.
+         * Nothing is copied if the ScaleEntry already uses alloc's memory resource.
+         *
+         * @param rs - ScaleEntry containing information about the RealisedScale
+         * @param root_index - index of the root of the RealisedScale among the possible roots
+         * @param options - reference to the scale indices of the multiple choice options
+         * @param correct_index - the index to the correct answer in options
+         * @param alloc - allocator for the RealisedScale
+         */
+        Question(ScaleManager::ScaleEntry<RealisedScale>&& rs, std::uint32_t root_index,
+                 const std::array<std::uint32_t, NUMBER_OF_CHOICES>& options, size_t correct_index,
+                 const allocator_type& alloc)
+            : _rs(std::move(rs), alloc),
+              _root_index(root_index),
+              _options(options),
+              _correct_index(correct_index)
+        {
+        }
+
+        Question(const Question&) = default;
+        Question(Question&&) = default;
+        Question& operator=(const Question&) = default;
+        Question& operator=(Question&&) = default;
+
+        Question(const Question& other, const allocator_type& alloc)
+            : Question(other._rs, other._root_index, other._options, other._correct_index, alloc)
+        {
+        }
+
+        Question(Question&& other, const allocator_type& alloc)
+            : Question(std::move(other._rs), other._root_index, other._options,
+                       other._correct_index, alloc)
         {
         }
 
         friend ApplicationManager;
     };
 
-    // AP owns the vector of Questions
-    std::vector<Question> _session;
+    /**
+     * @brief How a single question was answered.
+     *
+     */
+    struct Answer
+    {
+        bool _correct;
+        // From when the question was shown until the answer was submitted
+        std::uint32_t _milliseconds;
+    };
+
+    /**
+     * @brief What a lazy session draws its next question from.
+     *
+     */
+    struct LazySession
+    {
+        ScaleManager::Difficulty _difficulty;
+        // The roots of an eager session are drawn after all of its scales, so they get their own
+        // engine, started where the scales will have left _sampling_engine
+        RandomEngine _root_engine;
+    };
+
+    // AP owns the vector of Questions, allocated (along with everything in them) from the memory
+    // resource given at construction. A lazy session only holds its current question here.
+    std::pmr::vector<Question> _session;
+    // Questions in the whole session, and the index (in the whole session) of _session[0]
+    size_t _number_of_questions = 0;
+    size_t _first_question = 0;
+    // Only present while a lazy session is in progress
+    std::optional<LazySession> _lazy;
     // Stores the index of the current question
     size_t _question_index = 0;
-    // We store which questions were answered correctly or not
-    std::vector<bool> _correct_questions;
+    // We store how every question was answered (not in a lazy session)
+    std::pmr::vector<Answer> _answers;
+    // If open, every answer is written here as soon as it is submitted
+    std::unique_ptr<ResultsSink> _results;
     // And we keep a running sum
     size_t _correct = 0;
+    // Used for sampling the scales and roots of the questions
+    RandomEngine _sampling_engine{random_seed()};
+    // Used for picking and shuffling the multiple choice options
+    RandomEngine _engine{random_seed()};
+    // If set, sessions are adapted to this learner, whose state every answer updates
+    LearnerModel::State* _learner = nullptr;
+    // Made from _learner for every session, over the session's snapshot and difficulty
+    std::optional<LearnerModel> _learner_model;
+    // When the current question was last shown, to measure how long answering it took
+    std::chrono::steady_clock::time_point _question_shown = std::chrono::steady_clock::now();
+    // If set, every answer's time is counted here as well
+    LatencyStats* _latency_stats = nullptr;
+
+    /**
+     * @brief Returns the current question.
+     *
+     * @return Question&
+     */
+    inline Question& current_question() { return _session[_question_index - _first_question]; }
+
+    /**
+     * @brief Draws question number _question_index of the lazy session into _session, replacing
+     * the previous one.
+     *
+     */
+    void generate_lazy_question();
+
+    /**
+     * @brief Returns the row of the results for an answered question.
+     *
+     * @param question - reference to the question
+     * @param answer - reference to how it was answered
+     * @return ResultsSink::Result
+     */
+    ResultsSink::Result result_of(const Question& question, const Answer& answer) const;
 
    public:
     /**
@@ -83,6 +235,32 @@ class ApplicationManager
      */
     ApplicationManager() = default;
 
+    /**
+     * @brief Construct a new Application Manager object sharing an already loaded ScaleManager.
+     *
+     * @param sm - the ScaleManager to generate sessions from
+     */
+    inline explicit ApplicationManager(std::shared_ptr<const ScaleManager> sm) : _sm(std::move(sm))
+    {
+    }
+
+    /**
+     * @brief Construct a new Application Manager object sharing an already loaded ScaleManager,
+     * which allocates its sessions from a memory resource.
+     *
+     * The questions, their realised scales and the names of their notes all come from resource, so
+     * e.g. a std::pmr::monotonic_buffer_resource frees a whole session in one go. resource must
+     * outlive the ApplicationManager.
+     *
+     * @param sm - the ScaleManager to generate sessions from
+     * @param resource - the memory resource sessions are allocated from
+     */
+    inline ApplicationManager(std::shared_ptr<const ScaleManager> sm,
+                              std::pmr::memory_resource* resource)
+        : _sm(std::move(sm)), _session(resource), _answers(resource)
+    {
+    }
+
     /**
      * @brief Destroy the Application Manager object
      *
@@ -92,20 +270,83 @@ class ApplicationManager
     /**
      * @brief Loads the scales from the scales .csv file.
      *
-     * This is simply a wrapper for the contained ScaleManager.
+     * This loads a new ScaleManager, so other ApplicationManagers sharing the current one are not
+     * affected.
      *
      * @param path - string representation of the file path to the scales csv
      */
-    inline void load_scales(std::string path) { _sm.load_scales_from_file(path); }
+    void load_scales(const std::string& path);
+
+    /**
+     * @brief Loads the built-in scales instead of a file, see ScaleManager::load_default_scales.
+     *
+     * Same as load_scales, this loads a new ScaleManager.
+     */
+    void load_default_scales();
+
+    /**
+     * @brief Seeds all random generation, so that the same seed always produces the same session.
+     *
+     * Sampling the questions and picking their options each get their own stream of the seed.
+     *
+     * @param seed - the seed to use
+     */
+    void set_seed(std::uint64_t seed);
+
+    /**
+     * @brief Adapts the sessions generated from now on to a learner, see LearnerModel: scales and
+     * roots they struggle with are asked more often, and every answer updates their state.
+     *
+     * An eager session is weighted by the state as it was when the session was generated, a lazy
+     * one is re-weighted after every answer. Seeded sessions are only reproducible for the same
+     * state. learner must outlive the sessions; nullptr goes back to the plain weights.
+     *
+     * @param learner - pointer to the learner's state, or nullptr
+     */
+    void set_learner(LearnerModel::State* learner);
+
+    /**
+     * @brief Counts the time of every answer from now on in stats as well, see LatencyStats.
+     * Answers are timed from when their question was printed (or written as a line). stats must
+     * outlive the sessions; nullptr stops counting.
+     *
+     * @param stats - pointer to where to count answer times, or nullptr
+     */
+    inline void set_latency_stats(LatencyStats* stats) { _latency_stats = stats; }
+
+    /**
+     * @brief Get the scales the current session is drawn from.
+     *
+     * @return std::shared_ptr<const ScaleManager::Snapshot>
+     */
+    inline std::shared_ptr<const ScaleManager::Snapshot> snapshot() const { return _snapshot; }
 
     /**
      * @brief Generates the list of questions for this given session.
      *
+     * The questions are added to those of the session so far. A lazy session can't be added to;
+     * once it is finished it is replaced by a new session instead, and while it is still in
+     * progress this throws an std::runtime_error exception.
+     *
      * @param number_of_questions
      * @param difficulty - ScaleManager::Difficulty for which difficulty the session should be
      */
     void generate_session(size_t number_of_questions, ScaleManager::Difficulty difficulty);
 
+    /**
+     * @brief Starts a session whose questions are only generated one at a time, as next_question
+     * gets to them, so even endless sessions take the same (constant) amount of memory.
+     *
+     * Replaces any questions generated so far. For the same seed, the questions are the same as
+     * those of generate_session. Answers are not kept either, so open_session_results has to be
+     * called for them to be saved. A monotonic memory resource never reuses what the replaced
+     * questions freed, so lazy sessions should not be built in one.
+     *
+     * @param number_of_questions - how many questions the session has
+     * @param difficulty - ScaleManager::Difficulty for which difficulty the session should be
+     */
+    void generate_lazy_session(size_t number_of_questions, ScaleManager::Difficulty difficulty);
+
     /**
      * @brief Used for printing the command line header to a stream.
      *
@@ -120,6 +361,14 @@ class ApplicationManager
      */
     void print_question(std::ostream& stream);
 
+    /**
+     * @brief Writes what print_header and print_question print as the lines of a frame for a
+     * TerminalRenderer, reusing the strings already in lines.
+     *
+     * @param lines - reference to the lines to replace
+     */
+    void compose_question_frame(std::vector<std::string>& lines);
+
     /**
      * @brief Parses the current question's submitted answer from a stream.
      *
@@ -128,10 +377,27 @@ class ApplicationManager
     void load_answer(std::istream& stream);
 
     /**
-     * @brief Moves to the next question
+     * @brief Records the answer to the current question.
+     *
+     * @param answer - the chosen option, 1-based as printed (anything out of range is incorrect)
+     * @return true - if the answer was correct
+     * @return false - otherwise
+     */
+    bool submit_answer(size_t answer);
+
+    /**
+     * @brief Writes the current question as a single line (without the newline), for the serve mode
+     * protocol: "{question number}/{questions};{realised scale};{option 1};...;{option N}".
      *
+     * @param out - the string to append the line to
      */
-    inline void next_question() { ++_question_index; }
+    void write_question_line(std::string& out);
+
+    /**
+     * @brief Moves to the next question, generating it in a lazy session.
+     *
+     */
+    void next_question();
 
     /**
      * @brief 'Clears' the stream (used for the terminal here).
@@ -146,9 +412,9 @@ class ApplicationManager
      *
      * @return size_t
      */
-    inline size_t get_success_percentage()
+    inline size_t get_success_percentage() const
     {
-        return (size_t)(((double)_correct / _session.size()) * 100);
+        return (size_t)(((double)_correct / _number_of_questions) * 100);
     }
 
     /**
@@ -156,7 +422,41 @@ class ApplicationManager
      *
      * @param file_path - file path to where the results .csv file should be saved
      */
-    void save_session_results(const std::string& file_path);
+    inline void save_session_results(const std::string& file_path)
+    {
+        save_session_results(file_path, {});
+    }
+
+    /**
+     * @brief Used to save the results of this session through a ResultsSink.
+     *
+     * @param file_path - file path to where the results should be saved
+     * @param options - reference to how the ResultsSink writes (format, appending, ...)
+     */
+    void save_session_results(const std::string& file_path, const ResultsSink::Options& options);
+
+    /**
+     * @brief Writes the results of this session into a ResultsSink that is already open, such as
+     * one shared by many sessions.
+     *
+     * @param sink - reference to the sink to write to
+     */
+    void write_session_results(ResultsSink& sink) const;
+
+    /**
+     * @brief Opens a ResultsSink that every answer from now on is written to as it is submitted,
+     * instead of saving them all at the end. Needed to keep the results of a lazy session.
+     *
+     * @param file_path - file path to where the results should be saved
+     * @param options - reference to how the ResultsSink writes (format, appending, ...)
+     */
+    void open_session_results(const std::string& file_path, const ResultsSink::Options& options);
+
+    /**
+     * @brief Writes out and closes the results opened by open_session_results, if any.
+     *
+     */
+    void close_session_results();
 
     /**
      * @brief Returns if there are still questions left to answer.
@@ -164,7 +464,21 @@ class ApplicationManager
      * @return true
      * @return false
      */
-    inline bool can_print_more() { return _question_index < _session.size(); }
+    inline bool can_print_more() const { return _question_index < _number_of_questions; }
+
+    /**
+     * @brief Returns the number of correctly answered questions so far.
+     *
+     * @return size_t
+     */
+    inline size_t get_correct() const { return _correct; }
+
+    /**
+     * @brief Returns the number of questions in the session.
+     *
+     * @return size_t
+     */
+    inline size_t number_of_questions() const { return _number_of_questions; }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "batchrealiser.hpp"
+
+#include <stdexcept>
+
+#include "constants.hpp"
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#endif
+
+#if defined(__cpp_lib_experimental_parallel_simd) && !defined(SCALES_NO_SIMD)
+#define SCALES_BATCH_SIMD
+#endif
+
+namespace
+{
+/**
+ * @brief scale_degree_to_midi_diff written as arithmetic (whole steps, less the half step between
+ * E and F), so it can be evaluated lane-wise without a gather.
+ *
+ * @param base_degree - note name root (0-based)
+ * @return std::int32_t
+ */
+constexpr std::int32_t midi_diff_of_base_degree(std::int32_t base_degree)
+{
+    return 2 * base_degree - (base_degree >= 3);
+}
+
+constexpr bool matches_midi_diff_table()
+{
+    for (size_t i = 0; i < NUMBER_OF_SCALE_DEGREES; ++i)
+    {
+        if (midi_diff_of_base_degree(static_cast<std::int32_t>(i)) != scale_degree_to_midi_diff[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(matches_midi_diff_table());
+
+/**
+ * @brief The per-degree values of the kernel that are the same for every root.
+ *
+ */
+struct DegreeTerms
+{
+    std::int32_t _base_degree_step;  // added to the root's note name root, 0 to 6
+    std::int32_t _midi_offset;       // added to the root's MIDI value
+    std::int32_t _expected_midi_diff;
+};
+
+inline DegreeTerms degree_terms(Scale::scale_degree degree)
+{
+    scale_degree_value zero_based = degree.first - 1;
+    auto step = static_cast<std::int32_t>(zero_based % NUMBER_OF_SCALE_DEGREES);
+    return {step, scale_degree_midi_offset(zero_based) + degree.second,
+            midi_diff_of_base_degree(step) + degree.second};
+}
+
+// The same arithmetic as spell_scale_degree, kept branch-free so the loop vectorises
+void realise_lanes_scalar(const DegreeTerms& terms, const std::int32_t* root_midi,
+                          const std::int32_t* root_base_degrees,
+                          const std::int32_t* root_offsets_from_c, size_t count, std::int32_t* midi,
+                          std::int32_t* base_degrees, std::int32_t* accidentals)
+{
+    constexpr auto degrees = static_cast<std::int32_t>(NUMBER_OF_SCALE_DEGREES);
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::int32_t base_degree = root_base_degrees[i] + terms._base_degree_step;
+        std::int32_t wraps = base_degree >= degrees;
+        base_degree -= degrees * wraps;
+        std::int32_t unaccidented =
+            midi_diff_of_base_degree(base_degree) + NOTES_PER_OCTAVE * wraps;
+
+        midi[i] = root_midi[i] + terms._midi_offset;
+        base_degrees[i] = base_degree;
+        accidentals[i] = terms._expected_midi_diff - (unaccidented - root_offsets_from_c[i]);
+    }
+}
+
+#ifdef SCALES_BATCH_SIMD
+namespace stdx = std::experimental;
+using lanes = stdx::native_simd<std::int32_t>;
+constexpr size_t NUMBER_OF_LANES = lanes::size();
+
+// The same arithmetic as spell_scale_degree, with the branches as masked operations
+void realise_lanes_simd(const DegreeTerms& terms, const std::int32_t* root_midi,
+                        const std::int32_t* root_base_degrees,
+                        const std::int32_t* root_offsets_from_c, size_t count, std::int32_t* midi,
+                        std::int32_t* base_degrees, std::int32_t* accidentals)
+{
+    for (size_t i = 0; i < count; i += NUMBER_OF_LANES)
+    {
+        lanes root_offset{root_offsets_from_c + i, stdx::element_aligned};
+
+        lanes base_degree{root_base_degrees + i, stdx::element_aligned};
+        base_degree += terms._base_degree_step;
+        auto wraps = base_degree >= static_cast<std::int32_t>(NUMBER_OF_SCALE_DEGREES);
+        stdx::where(wraps, base_degree) -= static_cast<std::int32_t>(NUMBER_OF_SCALE_DEGREES);
+
+        lanes unaccidented = base_degree * 2;
+        stdx::where(base_degree >= 3, unaccidented) -= 1;
+        stdx::where(wraps, unaccidented) += NOTES_PER_OCTAVE;
+
+        lanes note_midi{root_midi + i, stdx::element_aligned};
+        note_midi += terms._midi_offset;
+        lanes note_accidentals = terms._expected_midi_diff - (unaccidented - root_offset);
+
+        note_midi.copy_to(midi + i, stdx::element_aligned);
+        base_degree.copy_to(base_degrees + i, stdx::element_aligned);
+        note_accidentals.copy_to(accidentals + i, stdx::element_aligned);
+    }
+}
+#else
+constexpr size_t NUMBER_OF_LANES = 1;
+#endif
+}  // namespace
+
+const size_t BatchRealiser::LANES = NUMBER_OF_LANES;
+
+BatchRealiser::BatchRealiser(std::span<const PackedNote> roots, Kernel kernel)
+    : _roots(roots.begin(), roots.end()),
+      _kernel(kernel),
+      _padded_roots((roots.size() + LANES - 1) / LANES * LANES),
+      _root_midi(_padded_roots, 0),
+      _root_base_degrees(_padded_roots, 0),
+      _root_offsets_from_c(_padded_roots, 0)
+{
+    for (size_t r = 0; r < _roots.size(); ++r)
+    {
+        const PackedNote& root = _roots[r];
+        if (!root.has_midi() || !root.has_name() || root.has_enharmonic())
+        {
+            throw std::invalid_argument(BATCH_ROOT_NOT_SPELLED);
+        }
+        _root_midi[r] = root.get_midi();
+        _root_base_degrees[r] = static_cast<std::int32_t>(root.get_base_degree());
+        _root_offsets_from_c[r] =
+            scale_degree_to_midi_diff[root.get_base_degree()] + root.get_accidentals();
+    }
+}
+
+void BatchRealiser::realise(std::span<const Scale::scale_degree> degrees)
+{
+    for (auto&& degree : degrees)
+    {
+        if (degree.first == 0) throw std::invalid_argument(INDEX_BASE_ERROR);
+    }
+
+    _degrees.assign(degrees.begin(), degrees.end());
+    _midi.resize(_degrees.size() * _padded_roots);
+    _base_degrees.resize(_midi.size());
+    _accidentals.resize(_midi.size());
+
+    auto realise_lanes = realise_lanes_scalar;
+#ifdef SCALES_BATCH_SIMD
+    if (_kernel == Kernel::BEST) realise_lanes = realise_lanes_simd;
+#endif
+    for (size_t d = 0; d < _degrees.size(); ++d)
+    {
+        size_t row = lane(0, d);
+        realise_lanes(degree_terms(_degrees[d]), _root_midi.data(), _root_base_degrees.data(),
+                      _root_offsets_from_c.data(), _padded_roots, _midi.data() + row,
+                      _base_degrees.data() + row, _accidentals.data() + row);
+    }
+}
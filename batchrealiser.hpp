@@ -0,0 +1,214 @@
+#ifndef BATCHREALISER
+#define BATCHREALISER
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "musiclibrary.hpp"
+
+/**
+ * @brief Realises one scale on many roots in a single pass.
+ *
+ * Realising a scale degree is the same arithmetic for every root: pick the note name root the
+ * degree lands on, add the degree's MIDI offset and correct the accidentals. BatchRealiser keeps
+ * the roots as structure-of-arrays lanes and runs that arithmetic for one scale degree across all
+ * roots at once, using std::experimental::simd where the standard library has it and a plain loop
+ * (which compilers vectorise well on their own) otherwise. The plain loop is always built, and can
+ * be asked for with Kernel::SCALAR.
+ *
+ * Results are laid out degree-major, so a scale degree's MIDI values and spellings for every root
+ * are contiguous. The notes it gives out are the same as PackedRealisedScale::realise_scale would
+ * give for the same root and degrees.
+ */
+class BatchRealiser
+{
+   public:
+    /**
+     * @brief Amount of roots processed by a single vector operation. Lanes are padded to a multiple
+     * of this, so the kernel never needs a scalar tail.
+     *
+     */
+    static const size_t LANES;
+
+    /**
+     * @brief Which kernel realise runs.
+     *
+     */
+    enum class Kernel
+    {
+        // The SIMD kernel where it was built (it isn't with SCALES_NO_SIMD), the plain loop
+        // otherwise
+        BEST = 0,
+        SCALAR
+    };
+
+   private:
+    /**
+     * @brief The roots, in the order they were given.
+     *
+     */
+    std::vector<PackedNote> _roots;
+
+    Kernel _kernel = Kernel::BEST;
+
+    /**
+     * @brief _roots.size() rounded up to a multiple of LANES.
+     *
+     */
+    size_t _padded_roots = 0;
+
+    /**
+     * @brief MIDI values of the roots, one lane per root.
+     *
+     */
+    std::vector<std::int32_t> _root_midi;
+
+    /**
+     * @brief Note name roots (0-based) of the roots, one lane per root.
+     *
+     */
+    std::vector<std::int32_t> _root_base_degrees;
+
+    /**
+     * @brief MIDI offsets of the roots' spellings from C (i.e. including their accidentals), one
+     * lane per root.
+     *
+     */
+    std::vector<std::int32_t> _root_offsets_from_c;
+
+    /**
+     * @brief The scale degrees of the last realised scale.
+     *
+     */
+    std::vector<Scale::scale_degree> _degrees;
+
+    /**
+     * @brief Results of the last realised scale; _degrees.size() rows of _padded_roots lanes.
+     *
+     */
+    std::vector<std::int32_t> _midi;
+    std::vector<std::int32_t> _base_degrees;
+    std::vector<std::int32_t> _accidentals;
+
+    /**
+     * @brief Returns where a (root, degree) pair lives in the result lanes.
+     *
+     * @param root_index - index of the root (in the order the roots were given)
+     * @param degree_index - 0-based index into the realised scale degrees
+     * @return size_t
+     */
+    inline size_t lane(size_t root_index, size_t degree_index) const
+    {
+        return degree_index * _padded_roots + root_index;
+    }
+
+   public:
+    /**
+     * @brief Construct a new Batch Realiser object without any roots.
+     *
+     */
+    BatchRealiser() = default;
+
+    /**
+     * @brief Construct a new Batch Realiser object that realises scales on the given roots.
+     *
+     * Every root needs a MIDI value and a single spelling (i.e. no enharmonic), so that its
+     * realisations have both; throws std::invalid_argument otherwise.
+     *
+     * @param roots - the roots every scale is realised on
+     * @param kernel - which kernel realises the scales; both give the same notes
+     */
+    explicit BatchRealiser(std::span<const PackedNote> roots, Kernel kernel = Kernel::BEST);
+
+    /**
+     * @brief Realises scale degrees on every root, replacing the previous results.
+     *
+     * Throws std::invalid_argument for a 0th scale degree, like the PackedNote constructor.
+     *
+     * @param degrees - the scale degrees, which act as a template for generating the scale
+     */
+    void realise(std::span<const Scale::scale_degree> degrees);
+
+    /**
+     * @brief Realises a scale on every root, replacing the previous results.
+     *
+     * @param scale - reference to Scale, which acts as a template for generating the scale
+     */
+    inline void realise(const Scale& scale) { realise(scale.degrees()); }
+
+    /**
+     * @brief Returns the amount of roots.
+     *
+     * @return size_t
+     */
+    inline size_t number_of_roots() const { return _roots.size(); }
+
+    /**
+     * @brief Returns the amount of scale degrees of the last realised scale.
+     *
+     * @return size_t
+     */
+    inline size_t number_of_degrees() const { return _degrees.size(); }
+
+    /**
+     * @brief Returns the MIDI value of a scale degree realised on a root.
+     *
+     * @param root_index - index of the root (in the order the roots were given)
+     * @param degree_index - 0-based index into the realised scale degrees
+     * @return midi_value
+     */
+    inline midi_value midi(size_t root_index, size_t degree_index) const
+    {
+        return _midi[lane(root_index, degree_index)];
+    }
+
+    /**
+     * @brief Returns the spelling of a scale degree realised on a root.
+     *
+     * @param root_index - index of the root (in the order the roots were given)
+     * @param degree_index - 0-based index into the realised scale degrees
+     * @return Spelling
+     */
+    inline Spelling spelling(size_t root_index, size_t degree_index) const
+    {
+        size_t index = lane(root_index, degree_index);
+        return {static_cast<scale_degree_value>(_base_degrees[index]),
+                static_cast<accidentals_value>(_accidentals[index])};
+    }
+
+    /**
+     * @brief Returns a scale degree realised on a root as a PackedNote.
+     *
+     * @param root_index - index of the root (in the order the roots were given)
+     * @param degree_index - 0-based index into the realised scale degrees
+     * @return PackedNote
+     */
+    inline PackedNote note(size_t root_index, size_t degree_index) const
+    {
+        // Same as PackedRealisedScale::realise_scale, the 1st degree is the root itself
+        if (_degrees[degree_index].first == 1) return _roots[root_index];
+        return {spelling(root_index, degree_index), midi(root_index, degree_index)};
+    }
+
+    /**
+     * @brief Writes the PackedNotes of the last realised scale on a root to an output iterator.
+     *
+     * @tparam OutputIt - output iterator accepting PackedNote
+     * @param root_index - index of the root (in the order the roots were given)
+     * @param out - where to write the notes
+     * @return OutputIt - iterator past the last written note
+     */
+    template <typename OutputIt>
+    OutputIt write_scale(size_t root_index, OutputIt out) const
+    {
+        for (size_t d = 0; d < _degrees.size(); ++d)
+        {
+            *out++ = note(root_index, d);
+        }
+        return out;
+    }
+};
+
+#endif
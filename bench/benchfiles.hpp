@@ -0,0 +1,97 @@
+#ifndef BENCHFILES
+#define BENCHFILES
+
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "constants.hpp"
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+/*
+ * Input files the benchmarks generate once and then reuse between runs, in the temp directory.
+ *
+ * A file is named after everything that decides its contents (what wrote it, the version of the
+ * generator, the size and the seed), so a file from another generator version is never picked
+ * up. It is written to a temporary file first and only renamed to its name once it is complete,
+ * so a run that was interrupted (or a benchmark writing the same file at once) never leaves a
+ * truncated file behind under that name.
+ */
+
+/**
+ * @brief Returns the temp directory path of a generated bench file.
+ *
+ * @param stem - what generates the file, e.g. "scales_bench"
+ * @param version - version of the generator, bumped whenever its output for the same size and
+ * seed changes
+ * @param size - size of the file, in whatever the generator counts in
+ * @param seed - seed the generator is given
+ * @param extension - extension of the file, including the dot
+ * @return std::filesystem::path
+ */
+inline std::filesystem::path bench_file_path(std::string_view stem, std::uint32_t version,
+                                             std::uint64_t size, std::uint64_t seed,
+                                             std::string_view extension)
+{
+    std::string name{stem};
+    name += "_v" + std::to_string(version) + "_n" + std::to_string(size) + "_seed" +
+            std::to_string(seed);
+    name += extension;
+    return std::filesystem::temp_directory_path() / name;
+}
+
+/**
+ * @brief Writes a bench file unless it already exists and returns its path.
+ *
+ * write is called with the path of a temporary file to write the contents to, and has to throw
+ * if writing fails; the temporary file is removed then.
+ *
+ * @tparam Write - callable taking const std::string&
+ * @param path - reference to the path of the file, see bench_file_path
+ * @param write - writes the contents of the file
+ * @return std::string - the path of the file
+ */
+template <typename Write>
+std::string cached_bench_file(const std::filesystem::path& path, Write&& write)
+{
+    if (std::filesystem::exists(path)) return path.string();
+
+    std::string temporary = path.string() + ".tmp";
+#ifdef __unix__
+    // Benchmarks of other processes may be writing the same file
+    temporary += std::to_string(::getpid());
+#endif
+    try
+    {
+        write(temporary);
+    }
+    catch (...)
+    {
+        std::error_code ignored;
+        std::filesystem::remove(temporary, ignored);
+        throw;
+    }
+    // Atomic on POSIX, so the file is either missing or complete under its name
+    std::filesystem::rename(temporary, path);
+    return path.string();
+}
+
+/**
+ * @brief Throws if a stream a bench file was written with failed.
+ *
+ * @tparam Stream - output file stream
+ * @param file - reference to the stream, which is closed
+ */
+template <typename Stream>
+void close_bench_file(Stream& file)
+{
+    file.close();
+    if (!file.good()) throw std::runtime_error(BAD_FILE_OPEN);
+}
+
+#endif
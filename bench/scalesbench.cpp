@@ -0,0 +1,375 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "applicationmanager.hpp"
+#include "benchfiles.hpp"
+#include "batchrealiser.hpp"
+#include "defaultcatalogue.hpp"
+#include "musiclibrary.hpp"
+#include "randomengine.hpp"
+#include "scaleindex.hpp"
+#include "scalemanager.hpp"
+
+/*
+ * Microbenchmarks of the music library and ScaleManager hot paths.
+ *
+ * Prints JSON unless another --benchmark_format is asked for, so runs of different releases can
+ * be compared with Google Benchmark's tools/compare.py.
+ */
+
+namespace
+{
+constexpr std::string_view SCALE_STRING = "1,2,b3,4,5,b6,b7";
+
+const std::vector<std::string> NOTE_NAMES{"C4", "Eb3", "F#5", "Bb2", "G4", "Abb1", "D##6"};
+
+/**
+ * @brief Writes number_of_scales random seven note scales as a scales file.
+ *
+ */
+void write_generated_catalogue(const std::string& path, size_t number_of_scales,
+                               std::uint64_t seed)
+{
+    static constexpr std::array<std::string_view, 3> difficulties{"Easy", "Medium", "Hard"};
+    static constexpr std::array<std::string_view, 3> seconds{"b2", "2", "#2"};
+    static constexpr std::array<std::string_view, 2> thirds{"b3", "3"};
+    static constexpr std::array<std::string_view, 2> fourths{"4", "#4"};
+    static constexpr std::array<std::string_view, 2> sixths{"b6", "6"};
+    static constexpr std::array<std::string_view, 2> sevenths{"b7", "7"};
+
+    RandomEngine gen{seed};
+    auto pick = [&gen](const auto& options) { return options[gen() % options.size()]; };
+
+    std::ofstream file{path, std::ios::trunc};
+    file << "Name;Difficulty;Scale\n";
+    for (size_t i = 0; i < number_of_scales; ++i)
+    {
+        file << "Scale " << i << CSV_SEPERATOR << pick(difficulties) << CSV_SEPERATOR << "1,"
+             << pick(seconds) << ',' << pick(thirds) << ',' << pick(fourths) << ",5,"
+             << pick(sixths) << ',' << pick(sevenths) << '\n';
+    }
+    close_bench_file(file);
+}
+
+/**
+ * @brief Version of generated_catalogue's output; bump it whenever the same size gives other
+ * scales, so files of the old version are not reused.
+ *
+ */
+constexpr std::uint32_t GENERATED_CATALOGUE_VERSION = 1;
+
+/**
+ * @brief Writes a scales file of number_of_scales random seven note scales, once per size (see
+ * cached_bench_file), and returns its path.
+ *
+ */
+std::string generated_catalogue(size_t number_of_scales)
+{
+    // Every size has a seed of its own
+    std::uint64_t seed = number_of_scales;
+    auto path = bench_file_path("scales_bench", GENERATED_CATALOGUE_VERSION, number_of_scales,
+                                seed, ".csv");
+    return cached_bench_file(path, [number_of_scales, seed](const std::string& temporary)
+                             { write_generated_catalogue(temporary, number_of_scales, seed); });
+}
+}  // namespace
+
+// ====MUSICLIBRARY====
+
+static void BM_NoteFromString(benchmark::State& state)
+{
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        Note note{NOTE_NAMES[i++ % NOTE_NAMES.size()]};
+        benchmark::DoNotOptimize(note);
+    }
+}
+BENCHMARK(BM_NoteFromString);
+
+static void BM_NoteFromScaleDegree(benchmark::State& state)
+{
+    Note root{"Eb4"};
+    scale_degree_value scale_degree = 0;
+    for (auto _ : state)
+    {
+        Note note{root, scale_degree++ % NUMBER_OF_SCALE_DEGREES + 1, -1};
+        benchmark::DoNotOptimize(note);
+    }
+}
+BENCHMARK(BM_NoteFromScaleDegree);
+
+static void BM_ScaleStreamParse(benchmark::State& state)
+{
+    std::string input{SCALE_STRING};
+    for (auto _ : state)
+    {
+        std::istringstream stream{input};
+        Scale scale;
+        stream >> scale;
+        benchmark::DoNotOptimize(scale);
+    }
+}
+BENCHMARK(BM_ScaleStreamParse);
+
+static void BM_RealisedScaleConstruction(benchmark::State& state)
+{
+    Note root{"F#4"};
+    Scale scale{SCALE_STRING};
+    for (auto _ : state)
+    {
+        RealisedScale realised{root, scale};
+        benchmark::DoNotOptimize(realised);
+    }
+}
+BENCHMARK(BM_RealisedScaleConstruction);
+
+static void BM_RealisedScalePrint(benchmark::State& state)
+{
+    RealisedScale realised{Note{"F#4"}, Scale{SCALE_STRING}};
+    std::ostringstream stream;
+    for (auto _ : state)
+    {
+        stream.str("");
+        stream << realised;
+        benchmark::DoNotOptimize(stream);
+    }
+}
+BENCHMARK(BM_RealisedScalePrint);
+
+static void BM_RealisedScaleFormatTo(benchmark::State& state)
+{
+    RealisedScale realised{Note{"F#4"}, Scale{SCALE_STRING}};
+    std::array<char, 256> buffer;
+    for (auto _ : state)
+    {
+        char* end = realised.format_to(buffer.data());
+        benchmark::DoNotOptimize(end);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_RealisedScaleFormatTo);
+
+/**
+ * @brief Every note name root with up to one accidental, i.e. a transposition table's worth.
+ *
+ */
+static std::vector<PackedNote> all_roots()
+{
+    std::vector<PackedNote> roots;
+    Note middle_c{};
+    for (scale_degree_value degree = 1; degree <= NUMBER_OF_SCALE_DEGREES; ++degree)
+    {
+        for (accidentals_value accidentals = -1; accidentals <= 1; ++accidentals)
+        {
+            roots.emplace_back(Note{middle_c, degree, accidentals});
+        }
+    }
+    return roots;
+}
+
+static void BM_RealiseOnAllRootsPerNote(benchmark::State& state)
+{
+    std::vector<PackedNote> roots = all_roots();
+    Scale scale{SCALE_STRING};
+    std::vector<PackedNote> notes;
+    for (auto _ : state)
+    {
+        notes.clear();
+        for (auto&& root : roots)
+        {
+            PackedRealisedScale::realise_scale(root, scale, std::back_inserter(notes));
+        }
+        benchmark::DoNotOptimize(notes.data());
+    }
+}
+BENCHMARK(BM_RealiseOnAllRootsPerNote);
+
+static void BM_RealiseOnAllRootsBatched(benchmark::State& state)
+{
+    std::vector<PackedNote> roots = all_roots();
+    BatchRealiser realiser{roots};
+    Scale scale{SCALE_STRING};
+    std::vector<PackedNote> notes;
+    for (auto _ : state)
+    {
+        notes.clear();
+        realiser.realise(scale);
+        for (size_t r = 0; r < realiser.number_of_roots(); ++r)
+        {
+            realiser.write_scale(r, std::back_inserter(notes));
+        }
+        benchmark::DoNotOptimize(notes.data());
+    }
+}
+BENCHMARK(BM_RealiseOnAllRootsBatched);
+
+// ====SCALEMANAGER====
+
+static void BM_LoadScalesFromFile(benchmark::State& state)
+{
+    auto number_of_scales = static_cast<size_t>(state.range(0));
+    std::string path = generated_catalogue(number_of_scales);
+    for (auto _ : state)
+    {
+        ScaleManager sm;
+        sm.load_scales_from_file(path);
+        benchmark::DoNotOptimize(sm);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LoadScalesFromFile)
+    ->Arg(1 << 10)
+    ->Arg(1 << 14)
+    ->Arg(1 << 17)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_LoadDefaultScales(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        ScaleManager sm;
+        sm.load_default_scales();
+        benchmark::DoNotOptimize(sm);
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(DefaultCatalogue::ENTRIES.size()));
+}
+BENCHMARK(BM_LoadDefaultScales)->Unit(benchmark::kMicrosecond);
+
+static void BM_GenerateRealisedScalesByDifficulty(benchmark::State& state)
+{
+    ScaleManager sm;
+    sm.load_scales_from_file(generated_catalogue(1 << 14));
+    sm.set_seed(0);
+    auto number_of_scales = static_cast<size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        auto scales = sm.generate_realised_scales_by_difficulty(number_of_scales,
+                                                                ScaleManager::Difficulty::HARD);
+        benchmark::DoNotOptimize(scales);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GenerateRealisedScalesByDifficulty)->Arg(8)->Arg(1 << 10);
+
+static void BM_ScaleIndexFindPitchClasses(benchmark::State& state)
+{
+    ScaleManager sm;
+    sm.load_scales_from_file(generated_catalogue(1 << 14), false, 1, true);
+    const ScaleIndex& index = sm.get_scale_index();
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        auto found = index.find_pitch_classes(index.pitch_classes(i++ % index.size()));
+        benchmark::DoNotOptimize(found);
+    }
+}
+BENCHMARK(BM_ScaleIndexFindPitchClasses);
+
+static void BM_BuildScaleIndex(benchmark::State& state)
+{
+    ScaleManager sm;
+    sm.load_scales_from_file(generated_catalogue(static_cast<size_t>(state.range(0))));
+    for (auto _ : state)
+    {
+        sm.build_scale_index();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BuildScaleIndex)->Arg(1 << 10)->Arg(1 << 14)->Unit(benchmark::kMillisecond);
+
+static void BM_ScaleIndexFindSupersets(benchmark::State& state)
+{
+    ScaleManager sm;
+    sm.load_scales_from_file(generated_catalogue(1 << 14), false, 1, true);
+    const ScaleIndex& index = sm.get_scale_index();
+    // C, E and G
+    constexpr ScaleIndex::pitch_class_mask triad = 0b000010010001;
+    for (auto _ : state)
+    {
+        auto found = index.find_supersets_of(triad);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(index.size()));
+}
+BENCHMARK(BM_ScaleIndexFindSupersets)->Unit(benchmark::kMicrosecond);
+
+// ====APPLICATIONMANAGER====
+
+static void BM_GenerateSession(benchmark::State& state)
+{
+    std::string path = generated_catalogue(1 << 14);
+    auto number_of_questions = static_cast<size_t>(state.range(0));
+    std::unique_ptr<ApplicationManager> am;
+    for (auto _ : state)
+    {
+        // Sessions only ever grow, so every iteration needs a fresh manager, which is also
+        // destroyed outside of the timing
+        state.PauseTiming();
+        am.reset();
+        am = std::make_unique<ApplicationManager>();
+        am->set_seed(0);
+        am->load_scales(path);
+        state.ResumeTiming();
+
+        am->generate_session(number_of_questions, ScaleManager::Difficulty::HARD);
+        benchmark::DoNotOptimize(*am);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GenerateSession)->Arg(8)->Arg(1 << 10);
+
+static void BM_GenerateSessionInArena(benchmark::State& state)
+{
+    std::string path = generated_catalogue(1 << 14);
+    auto number_of_questions = static_cast<size_t>(state.range(0));
+    auto sm = std::make_shared<ScaleManager>();
+    sm->load_scales_from_file(path);
+    std::pmr::monotonic_buffer_resource arena;
+    std::unique_ptr<ApplicationManager> am;
+    for (auto _ : state)
+    {
+        // Same as BM_GenerateSession, but the whole session lives in (and is freed with) the arena
+        state.PauseTiming();
+        am.reset();
+        arena.release();
+        am = std::make_unique<ApplicationManager>(sm, &arena);
+        am->set_seed(0);
+        state.ResumeTiming();
+
+        am->generate_session(number_of_questions, ScaleManager::Difficulty::HARD);
+        benchmark::DoNotOptimize(*am);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GenerateSessionInArena)->Arg(8)->Arg(1 << 10);
+
+int main(int argc, char** argv)
+{
+    // JSON output by default, any explicit --benchmark_format still wins
+    std::vector<char*> arguments{argv, argv + argc};
+    std::string json_format{"--benchmark_format=json"};
+    auto is_format = [](char* argument)
+    { return std::string_view{argument}.starts_with("--benchmark_format"); };
+    bool has_format = std::any_of(arguments.begin(), arguments.end(), is_format);
+    if (!has_format) arguments.insert(arguments.begin() + 1, json_format.data());
+
+    int number_of_arguments = static_cast<int>(arguments.size());
+    benchmark::Initialize(&number_of_arguments, arguments.data());
+    if (benchmark::ReportUnrecognizedArguments(number_of_arguments, arguments.data())) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+}
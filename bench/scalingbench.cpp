@@ -0,0 +1,283 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "benchfiles.hpp"
+#include "randomengine.hpp"
+#include "scalecatalogue.hpp"
+#include "scalemanager.hpp"
+#include "syntheticcatalogue.hpp"
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+/*
+ * How ScaleManager scales with the size of the catalogue: loading (.csv and compiled), building
+ * the samplers (build_maps), the memory a loaded catalogue takes, and sampling scales and
+ * distractors, on synthetic catalogues (see SyntheticCatalogue) of 10^3 scales up and on 1 to 8
+ * threads. Every benchmark and thread count is a family of its own, so Google Benchmark fits and
+ * prints the complexity (BigO and RMS rows) of each.
+ *
+ * The largest catalogue has 10^6 scales unless SCALES_BENCH_MAX_SCALES says otherwise; 10^7 scales
+ * need a few GB of memory and a few minutes per benchmark.
+ */
+
+namespace
+{
+constexpr std::int64_t MIN_SCALES = 1000;
+constexpr std::int64_t DEFAULT_MAX_SCALES = 1000000;
+constexpr std::array<int, 4> THREAD_COUNTS{1, 2, 4, 8};
+
+/**
+ * @brief The largest catalogue to benchmark, from SCALES_BENCH_MAX_SCALES if it is set.
+ *
+ */
+std::int64_t max_scales()
+{
+    const char* variable = std::getenv("SCALES_BENCH_MAX_SCALES");
+    if (variable == nullptr) return DEFAULT_MAX_SCALES;
+    std::int64_t max = std::strtoll(variable, nullptr, 10);
+    return max >= MIN_SCALES ? max : DEFAULT_MAX_SCALES;
+}
+
+SyntheticCatalogue::Options synthetic_options(size_t number_of_scales)
+{
+    SyntheticCatalogue::Options options;
+    options._number_of_scales = number_of_scales;
+    options._seed = number_of_scales;
+    return options;
+}
+
+/**
+ * @brief Writes the synthetic catalogue of number_of_scales scales as a .csv file or a compiled
+ * catalogue, once per size (see cached_bench_file), and returns its path.
+ *
+ */
+std::string synthetic_file(size_t number_of_scales, bool compiled)
+{
+    SyntheticCatalogue::Options options = synthetic_options(number_of_scales);
+    // A compiled catalogue also depends on the version of the compiled format
+    std::string stem = compiled ? "scales_synthetic_compiled" +
+                                      std::to_string(ScaleCatalogue::COMPILED_VERSION)
+                                : "scales_synthetic";
+    auto path = bench_file_path(stem, SyntheticCatalogue::VERSION, number_of_scales,
+                                options._seed, compiled ? ".bin" : ".csv");
+    return cached_bench_file(path,
+                             [&options, compiled](const std::string& temporary)
+                             {
+                                 ScaleCatalogue catalogue = SyntheticCatalogue::generate(options);
+                                 if (compiled)
+                                 {
+                                     ScaleManager sm;
+                                     sm.load_catalogue(std::move(catalogue));
+                                     sm.save_compiled_catalogue(temporary);
+                                     return;
+                                 }
+                                 std::ofstream file{temporary, std::ios::trunc};
+                                 SyntheticCatalogue::write_csv(catalogue, file);
+                                 close_bench_file(file);
+                             });
+}
+
+/**
+ * @brief Returns the synthetic catalogue of number_of_scales scales, generated once until another
+ * size is asked for, so only one is kept in memory.
+ *
+ */
+const ScaleCatalogue& synthetic_catalogue(size_t number_of_scales)
+{
+    static std::unique_ptr<ScaleCatalogue> catalogue;
+    if (catalogue == nullptr || catalogue->size() != number_of_scales)
+    {
+        catalogue.reset();
+        catalogue = std::make_unique<ScaleCatalogue>(
+            SyntheticCatalogue::generate(synthetic_options(number_of_scales)));
+    }
+    return *catalogue;
+}
+
+/**
+ * @brief Returns a snapshot of the synthetic catalogue of number_of_scales scales, loaded once
+ * until another size is asked for. Safe to call from the threads of a multithreaded benchmark.
+ *
+ */
+std::shared_ptr<const ScaleManager::Snapshot> synthetic_snapshot(size_t number_of_scales)
+{
+    static std::mutex mutex;
+    static std::shared_ptr<const ScaleManager::Snapshot> snapshot;
+    std::lock_guard lock{mutex};
+    if (snapshot == nullptr || snapshot->number_of_scales() != number_of_scales)
+    {
+        snapshot.reset();
+        ScaleManager sm;
+        sm.load_scales_from_file(synthetic_file(number_of_scales, true));
+        snapshot = sm.snapshot();
+    }
+    return snapshot;
+}
+
+#ifdef __GLIBC__
+/**
+ * @brief Bytes allocated on the heap and not freed yet.
+ *
+ */
+std::int64_t allocated_bytes()
+{
+    struct mallinfo2 info = ::mallinfo2();
+    // Large blocks are mapped on their own and not counted as part of the heap
+    return static_cast<std::int64_t>(info.uordblks + info.hblkhd);
+}
+#endif
+
+void BM_ScalingLoad(benchmark::State& state, bool compiled, int number_of_threads)
+{
+    auto number_of_scales = static_cast<size_t>(state.range(0));
+    std::string path = synthetic_file(number_of_scales, compiled);
+    for (auto _ : state)
+    {
+        ScaleManager sm;
+        sm.load_scales_from_file(path, false, static_cast<size_t>(number_of_threads));
+        benchmark::DoNotOptimize(sm);
+    }
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(std::filesystem::file_size(path)));
+}
+
+void BM_ScalingBuildMaps(benchmark::State& state, int number_of_threads)
+{
+    auto number_of_scales = static_cast<size_t>(state.range(0));
+    const ScaleCatalogue& catalogue = synthetic_catalogue(number_of_scales);
+    std::unique_ptr<ScaleManager> sm;
+    for (auto _ : state)
+    {
+        // Loading a catalogue into an empty manager moves it in, so all that is timed is
+        // build_maps; the copy and the previous manager are made and freed outside of the timing
+        state.PauseTiming();
+        sm.reset();
+        sm = std::make_unique<ScaleManager>();
+        ScaleCatalogue copy;
+        copy.append(catalogue);
+        state.ResumeTiming();
+
+        sm->load_catalogue(std::move(copy), false, static_cast<size_t>(number_of_threads));
+        benchmark::DoNotOptimize(*sm);
+    }
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ScalingFootprint(benchmark::State& state)
+{
+#ifdef __GLIBC__
+    auto number_of_scales = static_cast<size_t>(state.range(0));
+    std::string path = synthetic_file(number_of_scales, true);
+    std::int64_t bytes = 0;
+    for (auto _ : state)
+    {
+        std::int64_t before = allocated_bytes();
+        auto sm = std::make_unique<ScaleManager>();
+        sm->load_scales_from_file(path);
+        bytes = allocated_bytes() - before;
+        benchmark::DoNotOptimize(*sm);
+    }
+    state.counters["bytes"] = static_cast<double>(bytes);
+    state.counters["bytes_per_scale"] =
+        static_cast<double>(bytes) / static_cast<double>(number_of_scales);
+#else
+    state.SkipWithError("Measuring the footprint needs glibc's mallinfo2");
+#endif
+}
+
+void BM_ScalingSampleScale(benchmark::State& state)
+{
+    auto snapshot = synthetic_snapshot(static_cast<size_t>(state.range(0)));
+    RandomEngine gen = make_stream(0, static_cast<std::uint64_t>(state.thread_index()));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(snapshot->sample_scale_index(ScaleManager::Difficulty::HARD, gen));
+    }
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ScalingSampleOptions(benchmark::State& state)
+{
+    auto snapshot = synthetic_snapshot(static_cast<size_t>(state.range(0)));
+    RandomEngine gen = make_stream(0, static_cast<std::uint64_t>(state.thread_index()));
+    std::array<std::uint32_t, NUMBER_OF_CHOICES> options;
+    for (auto _ : state)
+    {
+        size_t correct = snapshot->sample_scale_index(ScaleManager::Difficulty::HARD, gen);
+        benchmark::DoNotOptimize(snapshot->sample_options(correct, options, gen));
+    }
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Registers every scaling benchmark over the catalogue sizes, once per thread count.
+ *
+ * Threads are where the load itself may use them (parsing and sorting); sampling reads a shared
+ * snapshot, so there they are the benchmark's own threads drawing at once.
+ */
+bool register_scaling_benchmarks()
+{
+    std::int64_t max = max_scales();
+    auto sizes = [max](benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->RangeMultiplier(10)->Range(MIN_SCALES, max);
+        return benchmark;
+    };
+
+    for (int threads : THREAD_COUNTS)
+    {
+        std::string suffix = "/threads:" + std::to_string(threads);
+        sizes(benchmark::RegisterBenchmark(("BM_ScalingLoadCsv" + suffix).c_str(), BM_ScalingLoad,
+                                           false, threads))
+            ->Complexity(benchmark::oN)
+            ->UseRealTime()
+            ->Unit(benchmark::kMillisecond);
+        sizes(benchmark::RegisterBenchmark(("BM_ScalingLoadCompiled" + suffix).c_str(),
+                                           BM_ScalingLoad, true, threads))
+            ->Complexity(benchmark::oN)
+            ->UseRealTime()
+            ->Unit(benchmark::kMillisecond);
+        sizes(benchmark::RegisterBenchmark(("BM_ScalingBuildMaps" + suffix).c_str(),
+                                           BM_ScalingBuildMaps, threads))
+            ->Complexity(benchmark::oN)
+            ->UseRealTime()
+            ->Unit(benchmark::kMillisecond);
+    }
+
+    sizes(benchmark::RegisterBenchmark("BM_ScalingFootprint", BM_ScalingFootprint))
+        ->Iterations(1)
+        ->Unit(benchmark::kMillisecond);
+
+    // Threads() names these ".../threads:N" on its own
+    for (int threads : THREAD_COUNTS)
+    {
+        sizes(benchmark::RegisterBenchmark("BM_ScalingSampleScale", BM_ScalingSampleScale))
+            ->Threads(threads)
+            ->Complexity(benchmark::o1)
+            ->UseRealTime();
+        sizes(benchmark::RegisterBenchmark("BM_ScalingSampleOptions", BM_ScalingSampleOptions))
+            ->Threads(threads)
+            ->Complexity(benchmark::o1)
+            ->UseRealTime();
+    }
+    return true;
+}
+
+[[maybe_unused]] const bool registered = register_scaling_benchmarks();
+}  // namespace
@@ -0,0 +1,143 @@
+#include "cataloguewatcher.hpp"
+
+#include <format>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "constants.hpp"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <filesystem>
+#include <string_view>
+#endif
+
+CatalogueWatcher::CatalogueWatcher(std::shared_ptr<ScaleManager> sm, std::string path,
+                                   const Options& options)
+    : _sm(std::move(sm)), _path(std::move(path)), _options(options)
+{
+}
+
+CatalogueWatcher::~CatalogueWatcher() { stop(); }
+
+void CatalogueWatcher::reload()
+{
+    try
+    {
+        _sm->reload_scales_from_file(_path, _options._build_realisation_cache, _options._threads,
+                                     _options._build_scale_index);
+        _reloads.fetch_add(1, std::memory_order_relaxed);
+        std::cout << std::format(RELOADED_SCALES, _sm->snapshot()->number_of_scales(), _path)
+                  << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        _rejected_reloads.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << std::format(RELOAD_REJECTED, _path, e.what()) << std::endl;
+    }
+}
+
+#ifdef __linux__
+namespace
+{
+// How often the watching thread checks whether it should stop
+constexpr int STOP_CHECK_MS = 250;
+constexpr size_t EVENT_BUFFER_SIZE = 4096;
+}  // namespace
+
+void CatalogueWatcher::start()
+{
+    if (_thread.joinable()) return;
+
+    std::filesystem::path directory = std::filesystem::path{_path}.parent_path();
+    if (directory.empty()) directory = ".";
+
+    _inotify = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    // Written whole and closed, or renamed into place; plain writes are left for the close
+    if (_inotify < 0 ||
+        ::inotify_add_watch(_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        if (_inotify >= 0) ::close(_inotify);
+        _inotify = -1;
+        throw std::runtime_error(std::format(CANNOT_WATCH_FILE, _path));
+    }
+
+    _thread = std::jthread{[this](std::stop_token stop) { run(std::move(stop)); }};
+}
+
+void CatalogueWatcher::stop()
+{
+    if (_thread.joinable())
+    {
+        _thread.request_stop();
+        _thread.join();
+    }
+    if (_inotify >= 0) ::close(_inotify);
+    _inotify = -1;
+}
+
+void CatalogueWatcher::run(std::stop_token stop)
+{
+    using clock = std::chrono::steady_clock;
+    std::string name = std::filesystem::path{_path}.filename().string();
+
+    alignas(inotify_event) std::array<char, EVENT_BUFFER_SIZE> buffer;
+    // Whether the file changed since it was last reloaded, and when it last did
+    bool pending = false;
+    clock::time_point changed;
+
+    while (!stop.stop_requested())
+    {
+        int timeout = STOP_CHECK_MS;
+        if (pending)
+        {
+            auto settled = changed + _options._settle_time;
+            auto remaining =
+                std::chrono::ceil<std::chrono::milliseconds>(settled - clock::now()).count();
+            timeout = static_cast<int>(std::clamp<long long>(remaining, 0, STOP_CHECK_MS));
+        }
+
+        pollfd watched{_inotify, POLLIN, 0};
+        int ready = ::poll(&watched, 1, timeout);
+        if (ready < 0 && errno != EINTR) break;
+        if (ready > 0)
+        {
+            ssize_t length;
+            while ((length = ::read(_inotify, buffer.data(), buffer.size())) > 0)
+            {
+                for (ssize_t offset = 0; offset < length;)
+                {
+                    auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                    // Events were dropped, one of them may well have been the file
+                    bool overflowed = (event->mask & IN_Q_OVERFLOW) != 0;
+                    if (overflowed || (event->len > 0 && std::string_view{event->name} == name))
+                    {
+                        pending = true;
+                        changed = clock::now();
+                    }
+                }
+            }
+        }
+
+        if (pending && clock::now() >= changed + _options._settle_time)
+        {
+            pending = false;
+            reload();
+        }
+    }
+}
+#else
+void CatalogueWatcher::start() { throw std::runtime_error(WATCH_NOT_SUPPORTED); }
+
+void CatalogueWatcher::stop() {}
+
+void CatalogueWatcher::run(std::stop_token) {}
+#endif
@@ -0,0 +1,121 @@
+#ifndef CATALOGUEWATCHER
+#define CATALOGUEWATCHER
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+#include "scalemanager.hpp"
+
+/**
+ * @brief Reloads the scales of a ScaleManager whenever their file changes, so a running server
+ * picks up an updated scales file without being restarted.
+ *
+ * The directory of the file is watched with inotify rather than the file itself, as files are
+ * usually updated by renaming a new one over them, which a watch on the old file never hears of.
+ * The file is reloaded once it has been closed after writing (or moved into place) and then left
+ * alone for Options::_settle_time. Reloading goes through ScaleManager::reload_scales_from_file,
+ * which checks the new scales before publishing them: a file that doesn't load or doesn't check
+ * out is reported on std::cerr and the scales loaded before stay in use. The reload reads the file
+ * into memory instead of mapping it, so an editor rewriting it in place mid-reload can at worst
+ * get a half-written file rejected, never crash the process.
+ *
+ * Only available on Linux; start() throws std::runtime_error elsewhere.
+ */
+class CatalogueWatcher
+{
+   public:
+    /**
+     * @brief How the file is reloaded.
+     *
+     */
+    struct Options
+    {
+        // A file written in several goes is only reloaded once it has been quiet for this long
+        std::chrono::milliseconds _settle_time{200};
+        // Passed on to ScaleManager::reload_scales_from_file
+        bool _build_realisation_cache = false;
+        size_t _threads = 1;
+        bool _build_scale_index = false;
+    };
+
+   private:
+    std::shared_ptr<ScaleManager> _sm;
+    std::string _path;
+    Options _options;
+
+    // The inotify instance watching the directory of _path, -1 while not started
+    int _inotify = -1;
+    std::jthread _thread;
+
+    std::atomic<size_t> _reloads{0};
+    std::atomic<size_t> _rejected_reloads{0};
+
+    /**
+     * @brief Waits for changes of the file and reloads it, until stopped.
+     *
+     * @param stop - stop token of the watching thread
+     */
+    void run(std::stop_token stop);
+
+    /**
+     * @brief Reloads the file once, reporting whether it was published.
+     *
+     */
+    void reload();
+
+   public:
+    /**
+     * @brief Construct a new Catalogue Watcher object, which doesn't watch until start().
+     *
+     * @param sm - the ScaleManager to reload the scales of
+     * @param path - path to the scales file (.csv or compiled) to watch
+     * @param options - reference to how the file is reloaded
+     */
+    CatalogueWatcher(std::shared_ptr<ScaleManager> sm, std::string path, const Options& options);
+
+    CatalogueWatcher(const CatalogueWatcher&) = delete;
+    CatalogueWatcher& operator=(const CatalogueWatcher&) = delete;
+
+    /**
+     * @brief Destroy the Catalogue Watcher object, stopping it first.
+     *
+     */
+    ~CatalogueWatcher();
+
+    /**
+     * @brief Starts watching the file on a thread of its own.
+     *
+     * Throws std::runtime_error if the directory of the file can't be watched.
+     */
+    void start();
+
+    /**
+     * @brief Stops watching; a reload in progress is finished first.
+     *
+     */
+    void stop();
+
+    /**
+     * @brief Returns how many times the file was reloaded and published.
+     *
+     * @return size_t
+     */
+    inline size_t reloads() const { return _reloads.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns how many times the file changed but its scales were not published.
+     *
+     * @return size_t
+     */
+    inline size_t rejected_reloads() const
+    {
+        return _rejected_reloads.load(std::memory_order_relaxed);
+    }
+};
+
+#endif
@@ -1,18 +1,71 @@
 #ifndef CONSTANTS
 #define CONSTANTS
 
+#include <cstddef>
+
 // Exception-related
 constexpr char FORGOT_TO_LOAD_SCALES[] = "No scales found while generating session!";
 constexpr char TOO_MANY_QUESTION_PRINTS[] =
     "Tried printing next question when there are none left!";
+constexpr char LAZY_SESSION_CANNOT_GROW[] = "Questions cannot be added to a lazy session!";
+constexpr char LAZY_SESSION_KEEPS_NO_RESULTS[] =
+    "A lazy session keeps no results to save; open the results before answering instead!";
 constexpr char BAD_FILE_OPEN[] = "Unable to open/write the file!";
+constexpr char RESULTS_FORMAT_MISMATCH[] =
+    "The results file to append to is in another format or version!";
 constexpr char INVALID_DIFFICULTY[] =
     "Invalid difficulty value found during parsing file! Row: {}, Column: {}";
 constexpr char TOO_MANY_SAMPLES[] = "Too many samples requested!";
 constexpr char NOT_ENOUGH_COLUMNS[] = "Didn't read the expected three columns on Row: {}";
 constexpr char FAILED_PARSING_SCALE[] = "Failed parsing the scale on Row: {}";
+constexpr char NO_REALISATION_CACHE[] = "Realisation cache was requested, but it was never built!";
+constexpr char NO_SCALE_INDEX[] = "Scale index was requested, but it was never built!";
+constexpr char EMPTY_SAMPLER[] = "Tried sampling when nothing has a positive weight!";
+constexpr char MISMATCHED_WEIGHTS[] = "Sampler needs exactly one weight per value!";
+constexpr char NEGATIVE_WEIGHT[] = "Sampler weights cannot be negative!";
+constexpr char NOT_ENOUGH_SCALES_FOR_CHOICES[] =
+    "Not enough scales loaded to fill every multiple choice option!";
+constexpr char DUPLICATE_SCALE_NAME[] =
+    "More than one scale is called {}, names have to be unique!";
+constexpr char NO_EASY_SCALES[] = "No easy scales loaded, so easy questions can't be asked!";
+constexpr char BAD_BATCH_BUFFER[] =
+    "Batch output buffer size is not a multiple of the questions per session!";
+constexpr char BAD_COMPILED_CATALOGUE[] =
+    "File is not a valid compiled scale catalogue of a supported version!";
+constexpr char CANNOT_COMPILE_CATALOGUE[] =
+    "Scale catalogue does not fit the compiled catalogue format!";
+constexpr char BATCH_ROOT_NOT_SPELLED[] =
+    "Batch realisation roots need a MIDI value and a single spelling!";
+constexpr char SERVE_NOT_SUPPORTED[] = "Serve mode is only supported on Linux!";
+constexpr char SERVE_BAD_ADDRESS[] = "Serve mode needs an IPv4 address to listen on!";
+constexpr char SERVE_CANNOT_LISTEN[] = "Unable to listen on the requested address and port!";
+constexpr char WATCH_NOT_SUPPORTED[] = "Watching the scales file is only supported on Linux!";
+constexpr char CANNOT_WATCH_FILE[] = "Unable to watch the directory of the scales file {}!";
+constexpr char BAD_LEARNER_FILE[] = "File is not a valid file of learner states!";
+constexpr char TERMINAL_WRITE_FAILED[] = "Unable to write to the terminal!";
+constexpr char SYNTHETIC_BAD_DEGREES[] =
+    "Synthetic scales need between 1 and 12 degrees, and at least as many as the minimum!";
+constexpr char SYNTHETIC_BAD_ACCIDENTALS[] = "Synthetic scale degrees allow 1 or 2 accidentals!";
+constexpr char SYNTHETIC_BAD_MIX[] = "The difficulty mix needs a share above zero!";
+
+// Serve-mode protocol replies
+constexpr char SERVE_UNKNOWN_COMMAND[] = "ERROR unknown command";
+constexpr char SERVE_BAD_ARGUMENTS[] = "ERROR bad arguments";
+constexpr char SERVE_NO_SESSION[] = "ERROR no session in progress, send START first";
+constexpr char SERVE_LINE_TOO_LONG[] = "ERROR line too long";
+constexpr char SERVE_NO_LEARNERS[] = "ERROR this server keeps no learners";
+constexpr char SERVE_NO_SUCH_LEARNER[] = "ERROR no such learner";
+constexpr char SERVE_LEARNER_IN_USE[] = "ERROR learner is connected elsewhere";
+
+// Reports of reloading a watched scales file
+constexpr char RELOADED_SCALES[] = "Reloaded {} scales from {}";
+constexpr char RELOAD_REJECTED[] = "Kept the loaded scales, as {} could not be reloaded: {}";
+
+// Session-related
+constexpr size_t NUMBER_OF_CHOICES = 4;
 
 // CSV-related
+constexpr char RESULTS_FILE_HEADER[] = "Name;Difficulty;Correctness;Milliseconds";
 constexpr char CORRECT[] = "CORRECT";
 constexpr char INCORRECT[] = "INCORRECT";
 constexpr char CSV_SEPERATOR = ';';
@@ -0,0 +1,13 @@
+#include "defaultcatalogue.hpp"
+
+ScaleCatalogue DefaultCatalogue::build()
+{
+    ScaleCatalogue catalogue;
+    for (auto&& entry : ENTRIES)
+    {
+        catalogue.add(catalogue.intern_name(entry._name),
+                      static_cast<ScaleCatalogue::difficulty_value>(entry._difficulty),
+                      entry._degrees);
+    }
+    return catalogue;
+}
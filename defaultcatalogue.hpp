@@ -0,0 +1,82 @@
+#ifndef DEFAULTCATALOGUE
+#define DEFAULTCATALOGUE
+
+#include <array>
+#include <span>
+#include <string_view>
+
+#include "musiclibrary.hpp"
+#include "scalecatalogue.hpp"
+#include "scalemanager.hpp"
+
+/**
+ * @brief The scales of the shipped scales.csv, compiled into the program.
+ *
+ * Every scale is a _scale literal, so the whole table is parsed and checked at compile time and
+ * loading it (see ScaleManager::load_default_scales) involves no file I/O and no parsing.
+ */
+class DefaultCatalogue
+{
+   public:
+    /**
+     * @brief A single built-in scale, pointing at its compile-time scale degrees.
+     *
+     */
+    struct Entry
+    {
+        std::string_view _name;
+        ScaleManager::Difficulty _difficulty;
+        std::span<const Scale::scale_degree> _degrees;
+    };
+
+    static constexpr auto MAJOR = "1,2,3,4,5,6,7"_scale;
+    static constexpr auto NATURAL_MINOR = "1,2,b3,4,5,b6,b7"_scale;
+    static constexpr auto MELODIC_MINOR = "1,2,b3,4,5,6,b7"_scale;
+    static constexpr auto HARMONIC_MINOR = "1,2,b3,4,5,b6,7"_scale;
+    static constexpr auto LYDIAN = "1,2,3,#4,5,6,7"_scale;
+    static constexpr auto MIXOLYDIAN = "1,2,3,4,5,6,b7"_scale;
+    static constexpr auto DORIAN = "1,2,b3,4,5,6,7"_scale;
+    static constexpr auto PHRYGIAN = "1,b2,b3,4,5,b6,b7"_scale;
+    static constexpr auto LOCRIAN = "1,b2,b3,b4,5,b6,b7"_scale;
+    static constexpr auto BLUES = "1,b3,4,#4,5,b7"_scale;
+    static constexpr auto MAJOR_PENTATONIC = "1,2,3,5,6"_scale;
+    static constexpr auto MINOR_PENTATONIC = "1,b3,4,5,b7"_scale;
+    static constexpr auto BEBOP = "1,2,3,4,5,6,b7,7"_scale;
+    static constexpr auto LYDIAN_DOMINANT = "1,2,3,#4,5,6,b7"_scale;
+    static constexpr auto MIXOLYDIAN_FLAT_6 = "1,2,3,4,5,b6,b7"_scale;
+    static constexpr auto PHRYGIAN_SHARP_6 = "1,b2,b3,4,5,6,b7"_scale;
+    static constexpr auto LOCRIAN_SHARP_2 = "1,2,b3,b4,5,b6,b7"_scale;
+
+    /**
+     * @brief Every built-in scale, in the order of scales.csv.
+     *
+     */
+    static constexpr std::array<Entry, 17> ENTRIES{{
+        {"Major", ScaleManager::Difficulty::EASY, MAJOR.degrees()},
+        {"Natural Minor", ScaleManager::Difficulty::EASY, NATURAL_MINOR.degrees()},
+        {"Melodic Minor", ScaleManager::Difficulty::EASY, MELODIC_MINOR.degrees()},
+        {"Harmonic Minor", ScaleManager::Difficulty::EASY, HARMONIC_MINOR.degrees()},
+        {"Lydian", ScaleManager::Difficulty::MEDIUM, LYDIAN.degrees()},
+        {"Mixolydian", ScaleManager::Difficulty::MEDIUM, MIXOLYDIAN.degrees()},
+        {"Dorian", ScaleManager::Difficulty::MEDIUM, DORIAN.degrees()},
+        {"Phrygian", ScaleManager::Difficulty::MEDIUM, PHRYGIAN.degrees()},
+        {"Locrian", ScaleManager::Difficulty::MEDIUM, LOCRIAN.degrees()},
+        {"Blues", ScaleManager::Difficulty::MEDIUM, BLUES.degrees()},
+        {"Major pentatonic", ScaleManager::Difficulty::MEDIUM, MAJOR_PENTATONIC.degrees()},
+        {"Minor pentatonic", ScaleManager::Difficulty::MEDIUM, MINOR_PENTATONIC.degrees()},
+        {"Bebop", ScaleManager::Difficulty::HARD, BEBOP.degrees()},
+        {"Lydian dominant", ScaleManager::Difficulty::HARD, LYDIAN_DOMINANT.degrees()},
+        {"Mixolydian b6", ScaleManager::Difficulty::HARD, MIXOLYDIAN_FLAT_6.degrees()},
+        {"Phrygian #6", ScaleManager::Difficulty::HARD, PHRYGIAN_SHARP_6.degrees()},
+        {"Locrian #2", ScaleManager::Difficulty::HARD, LOCRIAN_SHARP_2.degrees()},
+    }};
+
+    /**
+     * @brief Builds a ScaleCatalogue of every built-in scale, in the order of ENTRIES.
+     *
+     * @return ScaleCatalogue
+     */
+    static ScaleCatalogue build();
+};
+
+#endif
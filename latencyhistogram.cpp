@@ -0,0 +1,188 @@
+#include "latencyhistogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace
+{
+constexpr std::uint64_t SUB_BUCKETS = std::uint64_t{1} << LatencyHistogram::SUB_BUCKET_BITS;
+constexpr std::uint64_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+constexpr std::uint64_t MAX_VALUE = (std::uint64_t{1} << LatencyHistogram::MAX_VALUE_BITS) - 1;
+
+constexpr std::array<std::string_view, ScaleManager::NUMBER_OF_DIFFICULTIES> difficulty_names{
+    "Easy", "Medium", "Hard"};
+
+double to_milliseconds(std::chrono::nanoseconds duration)
+{
+    return static_cast<double>(duration.count()) / 1e6;
+}
+}  // namespace
+
+size_t LatencyHistogram::bucket_of(std::uint64_t nanoseconds)
+{
+    std::uint64_t value = std::min(nanoseconds, MAX_VALUE);
+    if (value < SUB_BUCKETS) return static_cast<size_t>(value);
+
+    // Keeps the top SUB_BUCKET_BITS bits, of which the highest is always set
+    unsigned magnitude = static_cast<unsigned>(std::bit_width(value)) - 1;
+    unsigned shift = magnitude - SUB_BUCKET_BITS + 1;
+    std::uint64_t mantissa = value >> shift;
+    return static_cast<size_t>(SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS +
+                               (mantissa - HALF_SUB_BUCKETS));
+}
+
+std::uint64_t LatencyHistogram::highest_value_of(size_t bucket)
+{
+    if (bucket < SUB_BUCKETS) return bucket;
+    std::uint64_t shift = (bucket - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+    std::uint64_t mantissa = (bucket - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds duration)
+{
+    auto nanoseconds = static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0));
+    _buckets[bucket_of(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _total_nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    std::uint64_t max = _max_nanoseconds.load(std::memory_order_relaxed);
+    while (nanoseconds > max &&
+           !_max_nanoseconds.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (size_t b = 0; b < NUMBER_OF_BUCKETS; ++b)
+    {
+        std::uint64_t count = other._buckets[b].load(std::memory_order_relaxed);
+        if (count != 0) _buckets[b].fetch_add(count, std::memory_order_relaxed);
+    }
+    _count.fetch_add(other.count(), std::memory_order_relaxed);
+    _total_nanoseconds.fetch_add(other._total_nanoseconds.load(std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+
+    std::uint64_t other_max = other._max_nanoseconds.load(std::memory_order_relaxed);
+    std::uint64_t max = _max_nanoseconds.load(std::memory_order_relaxed);
+    while (other_max > max &&
+           !_max_nanoseconds.compare_exchange_weak(max, other_max, std::memory_order_relaxed))
+    {
+    }
+}
+
+std::chrono::nanoseconds LatencyHistogram::percentile(double percent) const
+{
+    std::uint64_t count = this->count();
+    if (count == 0) return std::chrono::nanoseconds{0};
+
+    double share = std::clamp(percent, 0.0, 100.0) / 100.0;
+    double wanted = std::ceil(share * static_cast<double>(count));
+    auto rank = std::max<std::uint64_t>(static_cast<std::uint64_t>(wanted), 1);
+    std::uint64_t seen = 0;
+    for (size_t b = 0; b < NUMBER_OF_BUCKETS; ++b)
+    {
+        seen += _buckets[b].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            // The top of the bucket can overshoot everything actually counted
+            auto highest = static_cast<std::int64_t>(highest_value_of(b));
+            return std::min(std::chrono::nanoseconds{highest}, max());
+        }
+    }
+    return max();
+}
+
+std::chrono::nanoseconds LatencyHistogram::mean() const
+{
+    std::uint64_t count = this->count();
+    if (count == 0) return std::chrono::nanoseconds{0};
+    auto total = _total_nanoseconds.load(std::memory_order_relaxed);
+    return std::chrono::nanoseconds{static_cast<std::int64_t>(total / count)};
+}
+
+void LatencyHistogram::write_header(std::ostream& stream, std::string_view label)
+{
+    stream << std::format("{:<32}{:>10}{:>12}{:>12}{:>12}{:>12}{:>12}\n", label, "Count",
+                          "Mean ms", "p50 ms", "p90 ms", "p99 ms", "Max ms");
+}
+
+void LatencyHistogram::write_row(std::ostream& stream, std::string_view label) const
+{
+    stream << std::format("{:<32}{:>10}{:>12.3f}{:>12.3f}{:>12.3f}{:>12.3f}{:>12.3f}\n", label,
+                          count(), to_milliseconds(mean()), to_milliseconds(percentile(50)),
+                          to_milliseconds(percentile(90)), to_milliseconds(percentile(99)),
+                          to_milliseconds(max()));
+}
+
+LatencyStats::LatencyStats(std::shared_ptr<const ScaleManager::Snapshot> snapshot)
+    : _snapshot(std::move(snapshot))
+{
+    // Value-initialised, so every scale starts without a histogram
+    _by_scale = std::make_unique<std::atomic<LatencyHistogram*>[]>(_snapshot->number_of_scales());
+}
+
+LatencyStats::~LatencyStats()
+{
+    for (size_t i = 0; i < _snapshot->number_of_scales(); ++i)
+    {
+        delete _by_scale[i].load(std::memory_order_relaxed);
+    }
+}
+
+void LatencyStats::record(const ScaleManager::Snapshot& snapshot, size_t scale_index,
+                          std::chrono::nanoseconds duration)
+{
+    _by_difficulty[snapshot.get_catalogue().difficulty(scale_index)].record(duration);
+    if (&snapshot != _snapshot.get()) return;
+
+    std::atomic<LatencyHistogram*>& slot = _by_scale[scale_index];
+    LatencyHistogram* histogram = slot.load(std::memory_order_acquire);
+    if (histogram == nullptr)
+    {
+        // If another thread got there first, its histogram is used and this one dropped
+        auto created = std::make_unique<LatencyHistogram>();
+        if (slot.compare_exchange_strong(histogram, created.get(), std::memory_order_acq_rel))
+        {
+            histogram = created.release();
+        }
+    }
+    histogram->record(duration);
+}
+
+void LatencyStats::write_report(std::ostream& stream) const
+{
+    LatencyHistogram::write_header(stream, "Answer times by difficulty");
+    for (size_t d = 0; d < ScaleManager::NUMBER_OF_DIFFICULTIES; ++d)
+    {
+        const LatencyHistogram& histogram = _by_difficulty[d];
+        if (histogram.count() != 0) histogram.write_row(stream, difficulty_names[d]);
+    }
+
+    std::vector<std::pair<std::chrono::nanoseconds, size_t>> answered;
+    for (size_t i = 0; i < _snapshot->number_of_scales(); ++i)
+    {
+        if (const LatencyHistogram* histogram = by_scale(i))
+        {
+            answered.emplace_back(histogram->percentile(90), i);
+        }
+    }
+    if (answered.empty()) return;
+
+    size_t reported = std::min(answered.size(), REPORTED_SCALES);
+    std::partial_sort(answered.begin(), answered.begin() + static_cast<long>(reported),
+                      answered.end(), std::greater<>{});
+    stream << '\n';
+    LatencyHistogram::write_header(stream, "Slowest scales (by p90)");
+    for (size_t r = 0; r < reported; ++r)
+    {
+        size_t scale_index = answered[r].second;
+        by_scale(scale_index)->write_row(stream, _snapshot->get_scale_name(scale_index));
+    }
+}
@@ -0,0 +1,209 @@
+#ifndef LATENCYHISTOGRAM
+#define LATENCYHISTOGRAM
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string_view>
+
+#include "scalemanager.hpp"
+
+/**
+ * @brief Lock-free histogram of durations with a bounded relative error, in the style of
+ * HdrHistogram, for percentiles of answer and command times.
+ *
+ * Durations are counted in nanoseconds. Below 2^SUB_BUCKET_BITS every value has a bucket of its
+ * own; above, every power of two is split into 2^(SUB_BUCKET_BITS - 1) equal buckets, so a
+ * percentile is off by at most 1 / 2^(SUB_BUCKET_BITS - 1) (about 3%). record is a few relaxed
+ * atomic adds, so any number of threads can record into the same histogram; percentiles read
+ * while others record are only as consistent as the counts they happened to see.
+ */
+class LatencyHistogram
+{
+   public:
+    static constexpr unsigned SUB_BUCKET_BITS = 6;
+
+    /**
+     * @brief Durations of 2^MAX_VALUE_BITS ns (about 18 minutes) or more fall into the last bucket.
+     *
+     */
+    static constexpr unsigned MAX_VALUE_BITS = 40;
+
+    static constexpr size_t NUMBER_OF_BUCKETS =
+        (size_t{1} << SUB_BUCKET_BITS) +
+        (MAX_VALUE_BITS - SUB_BUCKET_BITS) * (size_t{1} << (SUB_BUCKET_BITS - 1));
+
+   private:
+    std::array<std::atomic<std::uint64_t>, NUMBER_OF_BUCKETS> _buckets{};
+    std::atomic<std::uint64_t> _count{0};
+    std::atomic<std::uint64_t> _total_nanoseconds{0};
+    std::atomic<std::uint64_t> _max_nanoseconds{0};
+
+    /**
+     * @brief Returns the bucket a value in nanoseconds is counted in.
+     *
+     * @param nanoseconds - the value
+     * @return size_t
+     */
+    static size_t bucket_of(std::uint64_t nanoseconds);
+
+    /**
+     * @brief Returns the largest value counted in a bucket.
+     *
+     * @param bucket - the bucket
+     * @return std::uint64_t
+     */
+    static std::uint64_t highest_value_of(size_t bucket);
+
+   public:
+    /**
+     * @brief Counts a single duration; negative ones count as zero.
+     *
+     * @param duration - the duration to count
+     */
+    void record(std::chrono::nanoseconds duration);
+
+    /**
+     * @brief Adds every count of other to this histogram.
+     *
+     * @param other - reference to the histogram to add
+     */
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * @brief Returns the duration that percentile percent of the counted ones are at most (up to
+     * the histogram's precision), 0 if nothing was counted.
+     *
+     * @param percent - the percentile, from 0 to 100
+     * @return std::chrono::nanoseconds
+     */
+    std::chrono::nanoseconds percentile(double percent) const;
+
+    /**
+     * @brief Returns the mean of the counted durations, 0 if nothing was counted.
+     *
+     * @return std::chrono::nanoseconds
+     */
+    std::chrono::nanoseconds mean() const;
+
+    /**
+     * @brief Returns the longest counted duration.
+     *
+     * @return std::chrono::nanoseconds
+     */
+    inline std::chrono::nanoseconds max() const
+    {
+        return std::chrono::nanoseconds{_max_nanoseconds.load(std::memory_order_relaxed)};
+    }
+
+    /**
+     * @brief Returns how many durations were counted.
+     *
+     * @return std::uint64_t
+     */
+    inline std::uint64_t count() const { return _count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Writes the heading of the table write_row writes rows of.
+     *
+     * @param stream - reference to the output stream to write to
+     * @param label - heading of the label column
+     */
+    static void write_header(std::ostream& stream, std::string_view label);
+
+    /**
+     * @brief Writes the count, mean, 50th, 90th and 99th percentile and the maximum as a row of a
+     * table, in milliseconds.
+     *
+     * @param stream - reference to the output stream to write to
+     * @param label - what the row is about
+     */
+    void write_row(std::ostream& stream, std::string_view label) const;
+};
+
+/**
+ * @brief Histograms of answer times per difficulty and per scale, which sessions on any number of
+ * threads can record into at once.
+ *
+ * Scales are told apart by their index in the snapshot the LatencyStats was made for; answers to
+ * scales of another snapshot (e.g. after the scales were reloaded) are only counted by difficulty.
+ * The histogram of a scale is only allocated once it is first answered, so a large catalogue of
+ * which only a few scales were asked costs little more than those few histograms.
+ */
+class LatencyStats
+{
+   private:
+    std::shared_ptr<const ScaleManager::Snapshot> _snapshot;
+    std::array<LatencyHistogram, ScaleManager::NUMBER_OF_DIFFICULTIES> _by_difficulty;
+    // Published with a compare-exchange by whichever thread answers a scale first
+    std::unique_ptr<std::atomic<LatencyHistogram*>[]> _by_scale;
+
+   public:
+    /**
+     * @brief How many of the slowest scales write_report lists.
+     *
+     */
+    static constexpr size_t REPORTED_SCALES = 5;
+
+    /**
+     * @brief Construct a new Latency Stats object for the scales of a snapshot.
+     *
+     * @param snapshot - the scales answers are told apart by
+     */
+    explicit LatencyStats(std::shared_ptr<const ScaleManager::Snapshot> snapshot);
+
+    LatencyStats(const LatencyStats&) = delete;
+    LatencyStats& operator=(const LatencyStats&) = delete;
+
+    /**
+     * @brief Destroy the Latency Stats object and every histogram of a scale.
+     *
+     */
+    ~LatencyStats();
+
+    /**
+     * @brief Counts the answer to a question about a scale.
+     *
+     * @param snapshot - reference to the snapshot the question was drawn from
+     * @param scale_index - index of the scale in snapshot
+     * @param duration - how long the answer took
+     */
+    void record(const ScaleManager::Snapshot& snapshot, size_t scale_index,
+                std::chrono::nanoseconds duration);
+
+    /**
+     * @brief Get the histogram of every answer of a difficulty.
+     *
+     * @param difficulty - the difficulty of the scales answered
+     * @return const LatencyHistogram&
+     */
+    inline const LatencyHistogram& by_difficulty(ScaleManager::Difficulty difficulty) const
+    {
+        return _by_difficulty[static_cast<size_t>(difficulty)];
+    }
+
+    /**
+     * @brief Get the histogram of a scale of the snapshot, nullptr if it was never answered.
+     *
+     * @param scale_index - index of the scale in the snapshot
+     * @return const LatencyHistogram*
+     */
+    inline const LatencyHistogram* by_scale(size_t scale_index) const
+    {
+        return _by_scale[scale_index].load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Writes the percentiles of every difficulty that was answered, and of the
+     * REPORTED_SCALES scales with the slowest 90th percentile.
+     *
+     * @param stream - reference to the output stream to write to
+     */
+    void write_report(std::ostream& stream) const;
+};
+
+#endif
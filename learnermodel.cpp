@@ -0,0 +1,171 @@
+#include "learnermodel.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+/**
+ * @brief Finaliser of splitmix64, spreading every input bit over the whole result.
+ *
+ * @param x - value to mix
+ * @return std::uint64_t
+ */
+constexpr std::uint64_t mix(std::uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief FNV-1a hash of a name. Stored states depend on it, so it must never change.
+ *
+ * @param name - the name to hash
+ * @return std::uint64_t
+ */
+constexpr std::uint64_t hash_name(std::string_view name)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : name)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+}  // namespace
+
+LearnerModel::LearnerModel(State& state, std::shared_ptr<const ScaleManager::Snapshot> snapshot,
+                           ScaleManager::Difficulty difficulty)
+    : _state(&state), _snapshot(std::move(snapshot)), _difficulty(difficulty)
+{
+    if (_state->_version != STATE_VERSION)
+    {
+        *_state = State{};
+        _state->_version = STATE_VERSION;
+    }
+}
+
+double LearnerModel::need(double attempts, double correct, double latency)
+{
+    double misses = (attempts - correct + 1.0) / (attempts + 2.0);
+    // Nothing is known about the speed of something never answered either
+    double slowness = 0.5;
+    if (attempts > 0)
+    {
+        double slow = static_cast<double>(SLOW_ANSWER / LATENCY_UNIT);
+        slowness = std::min(latency / slow, 1.0);
+    }
+    return MIN_NEED + misses + SLOWNESS_NEED * slowness;
+}
+
+void LearnerModel::record(Counter& counter, bool correct, std::uint16_t latency)
+{
+    if (counter._attempts == UINT8_MAX)
+    {
+        counter._attempts /= 2;
+        counter._correct /= 2;
+    }
+    // The first answer sets the average, later ones move it a quarter of the way
+    if (counter._attempts == 0)
+    {
+        counter._latency = latency;
+    }
+    else
+    {
+        int moved = counter._latency + (static_cast<int>(latency) - counter._latency) / 4;
+        counter._latency = static_cast<std::uint16_t>(moved);
+    }
+    ++counter._attempts;
+    if (correct) ++counter._correct;
+}
+
+LearnerModel::Counter& LearnerModel::pair_counter(std::uint64_t name_hash, size_t root_index) const
+{
+    std::uint64_t slot = mix(name_hash + root_index * 0x9e3779b97f4a7c15ULL);
+    return _state->_pairs[slot % NUMBER_OF_PAIR_SLOTS];
+}
+
+std::uint64_t LearnerModel::scale_name_hash(size_t scale_index) const
+{
+    return hash_name(_snapshot->get_scale_name(scale_index));
+}
+
+double LearnerModel::scale_need(size_t scale_index) const
+{
+    std::uint64_t name_hash = scale_name_hash(scale_index);
+    // Summed over every root the scale can be asked on, so its need is that of the whole scale
+    double attempts = 0;
+    double correct = 0;
+    double latency = 0;
+    for (size_t r = 0; r < ScaleManager::number_of_roots(); ++r)
+    {
+        if (ScaleManager::root_weight(_difficulty, r) == 0.0) continue;
+        const Counter& counter = pair_counter(name_hash, r);
+        attempts += counter._attempts;
+        correct += counter._correct;
+        latency += static_cast<double>(counter._latency) * counter._attempts;
+    }
+    if (attempts > 0) latency /= attempts;
+    return need(attempts, correct, latency);
+}
+
+double LearnerModel::root_need(size_t root_index) const
+{
+    const Counter& counter = _state->_roots[root_index];
+    return need(counter._attempts, counter._correct, counter._latency);
+}
+
+bool LearnerModel::accept(double need, RandomEngine& gen)
+{
+    return std::generate_canonical<double, 53>(gen) * MAX_NEED < need;
+}
+
+size_t LearnerModel::sample_scale_index(RandomEngine& gen)
+{
+    while (true)
+    {
+        size_t scale_index = _snapshot->sample_scale_index(_difficulty, gen);
+        if (accept(scale_need(scale_index), gen)) return scale_index;
+    }
+}
+
+size_t LearnerModel::sample_root_index(RandomEngine& gen)
+{
+    while (true)
+    {
+        size_t root_index = _snapshot->sample_root_index(_difficulty, gen);
+        if (accept(root_need(root_index), gen)) return root_index;
+    }
+}
+
+std::vector<size_t> LearnerModel::sample_scale_indices(size_t number_of_scales, RandomEngine& gen)
+{
+    std::vector<size_t> sampled_scales;
+    sampled_scales.reserve(number_of_scales);
+    for (size_t i = 0; i < number_of_scales; ++i) sampled_scales.push_back(sample_scale_index(gen));
+    return sampled_scales;
+}
+
+std::vector<size_t> LearnerModel::sample_root_indices(size_t number_of_roots, RandomEngine& gen)
+{
+    std::vector<size_t> sampled_roots;
+    sampled_roots.reserve(number_of_roots);
+    for (size_t i = 0; i < number_of_roots; ++i) sampled_roots.push_back(sample_root_index(gen));
+    return sampled_roots;
+}
+
+void LearnerModel::record(size_t scale_index, size_t root_index, bool correct,
+                          std::chrono::milliseconds latency)
+{
+    auto units = std::clamp<std::chrono::milliseconds::rep>(latency / LATENCY_UNIT, 0, UINT16_MAX);
+    auto latency_units = static_cast<std::uint16_t>(units);
+    record(pair_counter(scale_name_hash(scale_index), root_index), correct, latency_units);
+    record(_state->_roots[root_index], correct, latency_units);
+    ++_state->_answers;
+}
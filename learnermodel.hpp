@@ -0,0 +1,242 @@
+#ifndef LEARNERMODEL
+#define LEARNERMODEL
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "randomengine.hpp"
+#include "scalemanager.hpp"
+
+/**
+ * @brief Adapts the questions of a session to a single learner: scales and roots the learner gets
+ * wrong, or is slow to answer, are asked more often than those they already know.
+ *
+ * Everything the model knows about a learner is in their State, a fixed-size block of plain
+ * counters that is updated in place after every answer, so states can be kept in a file mapped
+ * into memory (see LearnerStore) for as many learners as the disk holds. A scale and a root are
+ * sampled with the weight of the Snapshot and ScaleManager times how much the learner needs them:
+ *
+ *     need = MIN_NEED + (misses + 1) / (attempts + 2)
+ *                     + SLOWNESS_NEED * min(latency / SLOW_ANSWER, 1)
+ *
+ * so a scale never answered counts as half missed and half slow, and one that is always answered
+ * quickly and correctly is asked about MIN_NEED / (MIN_NEED + 0.75) as often as a new one. The
+ * need of a scale sums up its counters over every root it is asked on.
+ *
+ * Weighting by need is done by rejection: a draw from the snapshot's own O(1) sampler is kept
+ * with probability need / MAX_NEED, and drawn again otherwise. need is at least MIN_NEED, so a
+ * draw takes at most MAX_NEED / MIN_NEED tries on average whatever the catalogue's size, and
+ * nothing has to be built per session or rebuilt after an answer.
+ *
+ * The state can't hold a counter for every scale of an arbitrarily large catalogue, so each
+ * (scale, root) pair is hashed (by the scale's name, which survives reloads and reordering) into
+ * one of NUMBER_OF_PAIR_SLOTS counters, which pairs share when they collide.
+ */
+class LearnerModel
+{
+   public:
+    /**
+     * @brief Version of the State layout; states of another version are started over.
+     *
+     */
+    static constexpr std::uint32_t STATE_VERSION = 1;
+
+    /**
+     * @brief Bytes of a single State.
+     *
+     */
+    static constexpr size_t STATE_SIZE = 1024;
+
+    static constexpr size_t NUMBER_OF_ROOT_SLOTS = 16;
+    static constexpr size_t NUMBER_OF_PAIR_SLOTS = 238;
+
+    /**
+     * @brief Unit the latency of the counters is kept in.
+     *
+     */
+    static constexpr std::chrono::milliseconds LATENCY_UNIT{10};
+
+    /**
+     * @brief Answers taking this long or longer count as fully slow.
+     *
+     */
+    static constexpr std::chrono::milliseconds SLOW_ANSWER{8000};
+
+    static constexpr double MIN_NEED = 0.1;
+    static constexpr double SLOWNESS_NEED = 0.5;
+    static constexpr double MAX_NEED = MIN_NEED + 1.0 + SLOWNESS_NEED;
+
+    /**
+     * @brief How the answers to a scale, a root or a pair of them went.
+     *
+     * Once _attempts would overflow, both counts are halved, so the counters slowly forget the
+     * oldest answers instead of saturating.
+     */
+    struct Counter
+    {
+        std::uint8_t _attempts = 0;
+        std::uint8_t _correct = 0;
+        // Moving average of the answer latency, in LATENCY_UNITs
+        std::uint16_t _latency = 0;
+    };
+
+    /**
+     * @brief Everything known about a single learner. Zeroed memory is a learner who hasn't
+     * answered anything yet, so a new (sparse) file of states needs no initialising.
+     *
+     */
+    struct State
+    {
+        std::uint32_t _version = 0;
+        // Answers recorded over all sessions
+        std::uint32_t _answers = 0;
+        std::array<Counter, NUMBER_OF_ROOT_SLOTS> _roots;
+        std::array<Counter, NUMBER_OF_PAIR_SLOTS> _pairs;
+    };
+
+   private:
+    State* _state;
+    std::shared_ptr<const ScaleManager::Snapshot> _snapshot;
+    ScaleManager::Difficulty _difficulty;
+
+    /**
+     * @brief Returns how much a learner needs to be asked about something, see the class doc.
+     *
+     * @param attempts - how many times it was answered
+     * @param correct - how many of those were correct
+     * @param latency - average latency of the answers, in LATENCY_UNITs
+     * @return double
+     */
+    static double need(double attempts, double correct, double latency);
+
+    /**
+     * @brief Records a single answer into a counter.
+     *
+     * @param counter - reference to the counter to update
+     * @param correct - whether the answer was correct
+     * @param latency - how long the answer took, in LATENCY_UNITs
+     */
+    static void record(Counter& counter, bool correct, std::uint16_t latency);
+
+    /**
+     * @brief Returns the counter of a (scale, root) pair.
+     *
+     * @param name_hash - hash of the scale's name, see scale_name_hash
+     * @param root_index - index of the root among the possible roots
+     * @return Counter&
+     */
+    Counter& pair_counter(std::uint64_t name_hash, size_t root_index) const;
+
+    /**
+     * @brief Returns the hash of the name of the scale at scale_index, which its pair counters
+     * are found by.
+     *
+     * @param scale_index - index of the scale in the snapshot
+     * @return std::uint64_t
+     */
+    std::uint64_t scale_name_hash(size_t scale_index) const;
+
+    /**
+     * @brief Computes how much the learner needs the scale at scale_index from its counters.
+     *
+     * @param scale_index - index of the scale in the snapshot
+     * @return double
+     */
+    double scale_need(size_t scale_index) const;
+
+    /**
+     * @brief Computes how much the learner needs the root at root_index from its counter.
+     *
+     * @param root_index - index of the root among the possible roots
+     * @return double
+     */
+    double root_need(size_t root_index) const;
+
+    /**
+     * @brief Returns whether a draw of the given need is kept, see the class doc.
+     *
+     * @param need - how much the learner needs what was drawn
+     * @param gen - reference to the random engine to draw with
+     * @return true
+     * @return false
+     */
+    static bool accept(double need, RandomEngine& gen);
+
+   public:
+    /**
+     * @brief Construct a new Learner Model object for the scales of snapshot up to difficulty.
+     *
+     * state is updated by record and must outlive the model. A state of another STATE_VERSION is
+     * started over.
+     *
+     * @param state - reference to the learner's state
+     * @param snapshot - the scales to sample from
+     * @param difficulty - the maximum difficulty of the scales to sample
+     */
+    LearnerModel(State& state, std::shared_ptr<const ScaleManager::Snapshot> snapshot,
+                 ScaleManager::Difficulty difficulty);
+
+    /**
+     * @brief Samples a single index into the snapshot's catalogue, weighted by the learner's need.
+     *
+     * @param gen - reference to the random engine to draw with
+     * @return size_t
+     */
+    size_t sample_scale_index(RandomEngine& gen);
+
+    /**
+     * @brief Samples a single index into the possible roots, weighted by the learner's need.
+     *
+     * @param gen - reference to the random engine to draw with
+     * @return size_t
+     */
+    size_t sample_root_index(RandomEngine& gen);
+
+    /**
+     * @brief Samples indices into the snapshot's catalogue, weighted by the learner's need.
+     *
+     * @param number_of_scales - the number of scales to sample
+     * @param gen - reference to the random engine to draw with
+     * @return std::vector<size_t>
+     */
+    std::vector<size_t> sample_scale_indices(size_t number_of_scales, RandomEngine& gen);
+
+    /**
+     * @brief Samples indices into the possible roots, weighted by the learner's need.
+     *
+     * @param number_of_roots - the number of roots to sample
+     * @param gen - reference to the random engine to draw with
+     * @return std::vector<size_t>
+     */
+    std::vector<size_t> sample_root_indices(size_t number_of_roots, RandomEngine& gen);
+
+    /**
+     * @brief Records an answer into the learner's state, which the next draw already weights
+     * by. O(1).
+     *
+     * @param scale_index - index of the scale the question was about
+     * @param root_index - index of the root it was realised on
+     * @param correct - whether it was answered correctly
+     * @param latency - how long the learner took to answer
+     */
+    void record(size_t scale_index, size_t root_index, bool correct,
+                std::chrono::milliseconds latency);
+
+    /**
+     * @brief Get the learner's state.
+     *
+     * @return const State&
+     */
+    inline const State& state() const { return *_state; }
+};
+
+// Stored as raw bytes, so the layout must not change by accident
+static_assert(std::is_trivially_copyable_v<LearnerModel::State>);
+static_assert(sizeof(LearnerModel::State) == LearnerModel::STATE_SIZE);
+
+#endif
@@ -0,0 +1,121 @@
+#include "learnerstore.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "constants.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+LearnerStore::LearnerStore(const std::string& path, size_t number_of_learners) : _path(path)
+{
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error(BAD_FILE_OPEN);
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) ||
+        static_cast<size_t>(info.st_size) % sizeof(LearnerModel::State) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error(BAD_LEARNER_FILE);
+    }
+
+    // Extending the file only reserves the zeros, they take no room until written
+    size_t stored = static_cast<size_t>(info.st_size) / sizeof(LearnerModel::State);
+    _size = std::max(stored, number_of_learners);
+    size_t bytes = _size * sizeof(LearnerModel::State);
+    if (_size > stored && ::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error(BAD_FILE_OPEN);
+    }
+
+    if (bytes > 0)
+    {
+        void* data = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error(BAD_FILE_OPEN);
+        }
+        // Learners come and go in no particular order, reading ahead would only waste memory
+        ::madvise(data, bytes, MADV_RANDOM);
+        _states = static_cast<LearnerModel::State*>(data);
+    }
+
+    // The mapping stays valid after closing the descriptor
+    ::close(fd);
+}
+
+LearnerStore::~LearnerStore()
+{
+    // Dirty pages of a shared mapping are written back by the system, so unmapping loses nothing
+    if (_states != nullptr) ::munmap(_states, _size * sizeof(LearnerModel::State));
+}
+
+void LearnerStore::flush()
+{
+    if (_states != nullptr) ::msync(_states, _size * sizeof(LearnerModel::State), MS_SYNC);
+}
+
+#else
+#include <fstream>
+
+LearnerStore::LearnerStore(const std::string& path, size_t number_of_learners) : _path(path)
+{
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+    size_t stored = 0;
+    if (file.is_open())
+    {
+        auto bytes = static_cast<size_t>(file.tellg());
+        if (bytes % sizeof(LearnerModel::State) != 0)
+        {
+            throw std::runtime_error(BAD_LEARNER_FILE);
+        }
+        stored = bytes / sizeof(LearnerModel::State);
+    }
+
+    _loaded.resize(std::max(stored, number_of_learners));
+    if (stored > 0)
+    {
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(_loaded.data()),
+                  static_cast<std::streamsize>(stored * sizeof(LearnerModel::State)));
+    }
+    _states = _loaded.data();
+    _size = _loaded.size();
+    // Written right away, so a file that can't be written fails here rather than at the end
+    flush();
+}
+
+LearnerStore::~LearnerStore()
+{
+    try
+    {
+        flush();
+    }
+    catch (const std::exception&)
+    {
+        // Nothing left to report it to
+    }
+}
+
+void LearnerStore::flush()
+{
+    std::ofstream file{_path, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<const char*>(_loaded.data()),
+               static_cast<std::streamsize>(_loaded.size() * sizeof(LearnerModel::State)));
+    if (!file.good())
+    {
+        throw std::runtime_error(BAD_FILE_OPEN);
+    }
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef LEARNERSTORE
+#define LEARNERSTORE
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "learnermodel.hpp"
+
+/**
+ * @brief The LearnerModel::States of many learners, kept in a file mapped into memory read-write
+ * and shared, so updating a state is writing to memory and the system writes it back on its own.
+ *
+ * The file is nothing but the states of learners 0, 1, 2, ... one after the other, in the layout
+ * of the machine that wrote them. It is grown to the requested number of learners by extending it
+ * with zeros, which most file systems store sparsely, and a zeroed state is a new learner; so a
+ * store for millions of learners takes up disk and memory only for the learners who actually
+ * answered something, a page (four states) at a time.
+ *
+ * Without mmap the states are read into memory instead and written back by flush and on
+ * destruction.
+ */
+class LearnerStore
+{
+   private:
+    std::string _path;
+    LearnerModel::State* _states = nullptr;
+    size_t _size = 0;
+    // Only used without mmap
+    std::vector<LearnerModel::State> _loaded;
+
+   public:
+    /**
+     * @brief Construct a new Learner Store object, mapping the file at path and growing it (or
+     * creating it) to hold at least number_of_learners states. Throws an std::runtime_error
+     * exception if the file can't be opened or isn't a whole number of states.
+     *
+     * @param path - reference to the path of the learner file
+     * @param number_of_learners - how many learners the file should hold at least
+     */
+    LearnerStore(const std::string& path, size_t number_of_learners);
+
+    LearnerStore(const LearnerStore&) = delete;
+    LearnerStore& operator=(const LearnerStore&) = delete;
+
+    /**
+     * @brief Destroy the Learner Store object, unmapping (or writing back) the states.
+     *
+     */
+    ~LearnerStore();
+
+    /**
+     * @brief Get the state of a learner; learner must be below size(). Valid for as long as the
+     * store.
+     *
+     * @param learner - number of the learner
+     * @return LearnerModel::State&
+     */
+    inline LearnerModel::State& operator[](size_t learner) { return _states[learner]; }
+
+    /**
+     * @brief Returns how many learners the file holds.
+     *
+     * @return size_t
+     */
+    inline size_t size() const { return _size; }
+
+    /**
+     * @brief Writes every changed state to the file and waits until it is done.
+     *
+     */
+    void flush();
+};
+
+#endif
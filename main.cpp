@@ -1,10 +1,64 @@
 #include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "applicationmanager.hpp"
 #include "argparse.hpp"
+#include "cataloguewatcher.hpp"
+#include "constants.hpp"
+#include "latencyhistogram.hpp"
+#include "learnerstore.hpp"
 #include "musiclibrary.hpp"
+#include "profiler.hpp"
 #include "scalemanager.hpp"
+#include "sessionserver.hpp"
+#include "terminalrenderer.hpp"
+
+/**
+ * @brief Arguments of the compile subcommand, which turns a scales .csv file into a compiled
+ * catalogue.
+ *
+ */
+struct CompileArgs : public argparse::Args
+{
+    std::string& input_path = kwarg("i", "Path to the scales files").set_default("./scales.csv");
+    std::string& output_path =
+        kwarg("o", "Path to the compiled catalogue").set_default("./scales.bin");
+};
+
+/**
+ * @brief Arguments of the serve subcommand, which serves sessions over TCP instead of running one
+ * in the terminal.
+ *
+ */
+struct ServeArgs : public argparse::Args
+{
+    std::string& input_path =
+        kwarg("i", "Path to the scales file (.csv or compiled)").set_default("./scales.csv");
+    bool& builtin = flag("builtin", "Serve the built-in scales instead of reading -i");
+    bool& watch =
+        flag("watch", "Reload -i whenever it changes; sessions in progress keep the old scales");
+    std::string& address = kwarg("address", "IPv4 address to listen on").set_default("127.0.0.1");
+    std::uint16_t& port = kwarg("port", "Port to listen on (0 picks a free one)")
+                              .set_default(SessionServer::DEFAULT_PORT);
+    size_t& threads = kwarg("threads", "Number of event loop threads").set_default(1);
+    size_t& number_of_questions =
+        kwarg("n", "Number of questions when START doesn't say").set_default(5);
+    size_t& difficulty =
+        kwarg("d", "Difficulty when START doesn't say (0 = Easy, 1 = Medium, 2 = Hard)")
+            .set_default(1);
+    std::optional<std::uint64_t>& seed =
+        kwarg("seed", "Seed for the random generator, session n always gets the same questions");
+    std::optional<std::string>& output_path =
+        kwarg("o", "Append the results of every finished session to this .csv file");
+    std::optional<std::string>& learners_path =
+        kwarg("learners", "Keep learners in this file, so LEARNER can adapt sessions to them");
+    size_t& max_learners =
+        kwarg("max-learners", "Number of learners the --learners file holds").set_default(1 << 20);
+    bool& latency = flag("latency", "Print answer and command time percentiles when stopped");
+};
 
 /**
  * @brief Specification of command line arguments using the morrisfranken/argparse library.
@@ -12,12 +66,28 @@
  */
 struct MyArgs : public argparse::Args
 {
+    CompileArgs& compile = subcommand("compile");
+    ServeArgs& serve = subcommand("serve");
+
     size_t& number_of_questions = kwarg("n", "Number of questions in this session").set_default(5);
-    std::string& input_path = kwarg("i", "Path to the scales files").set_default("./scales.csv");
+    std::string& input_path =
+        kwarg("i", "Path to the scales file (.csv or compiled)").set_default("./scales.csv");
+    bool& builtin = flag("builtin", "Use the built-in scales instead of reading -i");
     std::string& output_path =
         kwarg("o", "Path to the output .csv file").set_default("./results.csv");
     size_t& difficulty =
         kwarg("d", "Question difficulty (0 = Easy, 1 = Medium, 2 = Hard)").set_default(1);
+    std::optional<std::uint64_t>& seed =
+        kwarg("seed", "Seed for the random generator, the same seed gives the same session");
+    bool& append = flag("append", "Append the results to the output file instead of replacing it");
+    bool& columnar = flag("columnar", "Write the results in the binary columnar format");
+    bool& lazy = flag("lazy", "Generate each question when it is asked, for very long sessions");
+    std::optional<std::string>& learner_path =
+        kwarg("learner", "Adapt the questions to your answers, kept in this file between sessions");
+    bool& latency = flag("latency", "Print answer time percentiles at the end");
+    bool& profile = flag("profile", "Print per-phase timings and allocations at the end");
+    std::optional<std::string>& profile_path =
+        kwarg("profile-file", "Write the --profile table to this file instead of printing it");
 };
 
 /**
@@ -33,24 +103,148 @@ int main(int argc, char* argv[])
     // another parser like in the homeworks
     auto args = argparse::parse<MyArgs>(argc, argv);
 
+    // Compiling a catalogue is all the compile subcommand does, there is no session
+    if (args.compile.is_valid)
+    {
+        ScaleManager sm;
+        sm.load_scales_from_file(args.compile.input_path);
+        sm.save_compiled_catalogue(args.compile.output_path);
+        return 0;
+    }
+
+    // Serving loads the scales once and runs until interrupted
+    if (args.serve.is_valid)
+    {
+        auto sm = std::make_shared<ScaleManager>();
+        if (args.serve.builtin)
+        {
+            sm->load_default_scales();
+        }
+        else
+        {
+            sm->load_scales_from_file(args.serve.input_path);
+        }
+
+        SessionServer::Options options;
+        options._address = args.serve.address;
+        options._port = args.serve.port;
+        options._threads = args.serve.threads;
+        options._questions = args.serve.number_of_questions;
+        options._difficulty =
+            (ScaleManager::Difficulty)(args.serve.difficulty > 2 ? 2 : args.serve.difficulty);
+        options._seed = args.serve.seed;
+        options._results_path = args.serve.output_path;
+        options._learners_path = args.serve.learners_path;
+        options._max_learners = args.serve.max_learners;
+
+        // Before starting, so the worker threads never get the signals either
+        SessionServer::block_termination_signals();
+        SessionServer server{sm, options};
+        server.start();
+        std::cout << "Serving on " << options._address << ':' << server.port() << std::endl;
+
+        // Sessions hold on to the scales they started with, so the file can be reloaded under them
+        std::optional<CatalogueWatcher> watcher;
+        if (args.serve.watch && !args.serve.builtin)
+        {
+            watcher.emplace(sm, args.serve.input_path, CatalogueWatcher::Options{});
+            watcher->start();
+        }
+
+        SessionServer::wait_for_termination_signal();
+        if (watcher.has_value()) watcher->stop();
+        server.stop();
+        if (args.serve.latency) server.write_latency_report(std::cout);
+        return 0;
+    }
+
+    ResultsSink::Options results_options;
+    results_options._append = args.append;
+    results_options._format =
+        args.columnar ? ResultsSink::Format::COLUMNAR : ResultsSink::Format::CSV;
+
+    // The learner's state is updated in place after every answer, so it outlives the session
+    std::optional<LearnerStore> learner;
+    if (args.learner_path.has_value()) learner.emplace(args.learner_path.value(), 1);
+
     // ApplicationManager wraps over the logic of the application
     ApplicationManager am;
-    // Load scales from the .csv file containing scales information
-    am.load_scales(args.input_path);
-    // Generates an appropriate session of questions based on the command line arguments
-    am.generate_session(args.number_of_questions,
-                        (ScaleManager::Difficulty)(args.difficulty > 2 ? 2 : args.difficulty));
+    if (learner.has_value()) am.set_learner(&(*learner)[0]);
+    // Only seed explicitly if asked to, otherwise every session is different
+    if (args.seed.has_value()) am.set_seed(args.seed.value());
+    // Load scales from the .csv file containing scales information, or the ones built in
+    if (args.builtin)
+    {
+        am.load_default_scales();
+    }
+    else
+    {
+        am.load_scales(args.input_path);
+    }
+    // Generates an appropriate session of questions based on the command line arguments. A lazy
+    // session keeps neither its questions nor its answers, so they are written out as they come
+    auto difficulty = (ScaleManager::Difficulty)(args.difficulty > 2 ? 2 : args.difficulty);
+    if (args.lazy)
+    {
+        am.open_session_results(args.output_path, results_options);
+        am.generate_lazy_session(args.number_of_questions, difficulty);
+    }
+    else
+    {
+        am.generate_session(args.number_of_questions, difficulty);
+    }
+    // Made for the session's scales, so answers are told apart by scale as well
+    std::optional<LatencyStats> latency;
+    if (args.latency)
+    {
+        latency.emplace(am.snapshot());
+        am.set_latency_stats(&latency.value());
+    }
 
-    // Main program loop; printing questions and reading answers until we finish the session
+    // Main program loop; drawing questions and reading answers until we finish the session. Each
+    // frame is written in one go, so reading an answer needn't flush std::cout first
+    std::cin.tie(nullptr);
+    TerminalRenderer renderer;
+    std::vector<std::string> frame;
     while (am.can_print_more())
     {
-        am.clear_stream(std::cout);
-        am.print_header(std::cout);
-        am.print_question(std::cout);
+        am.compose_question_frame(frame);
+        renderer.render(frame);
         am.load_answer(std::cin);
         am.next_question();
     }
 
-    // Save the results to a .csv file
-    am.save_session_results(args.output_path);
+    // Save the results to a .csv (or columnar) file
+    if (args.lazy)
+    {
+        am.close_session_results();
+    }
+    else
+    {
+        am.save_session_results(args.output_path, results_options);
+    }
+
+    if (latency.has_value()) latency->write_report(std::cout);
+
+    if (args.profile || args.profile_path.has_value())
+    {
+        if (args.profile_path.has_value())
+        {
+            std::ofstream profile_file{args.profile_path.value(), std::ios::trunc};
+            if (!profile_file.good())
+            {
+                throw std::runtime_error(BAD_FILE_OPEN);
+            }
+            Profiler::write_report(profile_file);
+            profile_file.flush();
+            if (!profile_file.good())
+            {
+                throw std::runtime_error(BAD_FILE_OPEN);
+            }
+        }
+        else
+        {
+            Profiler::write_report(std::cout);
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "mappedfile.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error(BAD_FILE_OPEN);
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+    {
+        _size = static_cast<size_t>(info.st_size);
+        if (_size == 0)
+        {
+            // mmap refuses empty mappings, but there is nothing to map anyway
+            _mapped = true;
+        }
+        else
+        {
+            void* data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                ::madvise(data, _size, MADV_SEQUENTIAL);
+                _data = static_cast<const char*>(data);
+                _mapped = true;
+            }
+            else
+            {
+                _size = 0;
+            }
+        }
+    }
+
+    // The mapping stays valid after closing the descriptor
+    ::close(fd);
+}
+
+void MappedFile::unmap()
+{
+    if (_data != nullptr)
+    {
+        ::munmap(const_cast<char*>(_data), _size);
+    }
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+}
+
+#else
+#include <fstream>
+
+// Without mmap every file is read as a stream; this only checks that it can be opened
+MappedFile::MappedFile(const std::string& path)
+{
+    if (!std::ifstream{path}.good())
+    {
+        throw std::runtime_error(BAD_FILE_OPEN);
+    }
+}
+
+void MappedFile::unmap()
+{
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+}
+
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _data(std::exchange(other._data, nullptr)),
+      _size(std::exchange(other._size, 0)),
+      _mapped(std::exchange(other._mapped, false))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+        _mapped = std::exchange(other._mapped, false);
+    }
+    return *this;
+}
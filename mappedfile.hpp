@@ -0,0 +1,93 @@
+#ifndef MAPPEDFILE
+#define MAPPEDFILE
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "constants.hpp"
+
+/**
+ * @brief Read-only memory mapping of a whole file, unmapped again on destruction.
+ *
+ * Only regular files get mapped. Anything else (a pipe, a terminal, a character device or a
+ * platform without mmap) still opens fine, but is_mapped is false and the caller is expected to
+ * fall back to reading the file as a stream.
+ */
+class MappedFile
+{
+   private:
+    /**
+     * @brief Start of the mapping, or nullptr if nothing is mapped.
+     *
+     */
+    const char* _data = nullptr;
+
+    /**
+     * @brief Size of the mapping in bytes.
+     *
+     */
+    size_t _size = 0;
+
+    /**
+     * @brief Whether the file could be mapped; an empty regular file counts as mapped.
+     *
+     */
+    bool _mapped = false;
+
+    /**
+     * @brief Unmaps the file, if anything is mapped.
+     *
+     */
+    void unmap();
+
+   public:
+    /**
+     * @brief Construct a new Mapped File object, mapping the file at path if it is a regular file.
+     * Throws an std::runtime_error exception if the file cannot be opened at all.
+     *
+     * @param path - reference to the path of the file to map
+     */
+    explicit MappedFile(const std::string& path);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Construct a new Mapped File object, taking over the mapping of other.
+     *
+     * @param other - mapping to move from, left unmapped
+     */
+    MappedFile(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Takes over the mapping of other, unmapping the current one.
+     *
+     * @param other - mapping to move from, left unmapped
+     * @return MappedFile&
+     */
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Destroy the Mapped File object, unmapping the file.
+     *
+     */
+    inline ~MappedFile() { unmap(); }
+
+    /**
+     * @brief Returns whether the file is mapped; if not, it has to be read as a stream.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool is_mapped() const { return _mapped; }
+
+    /**
+     * @brief Get a view of the mapped bytes, valid for as long as the mapping lives.
+     *
+     * @return std::string_view
+     */
+    inline std::string_view view() const { return {_data, _size}; }
+};
+
+#endif
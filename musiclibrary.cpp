@@ -1,509 +1,221 @@
 #include "musiclibrary.hpp"
 
-// ====NOTE====
+// ====INSTANTIATIONS====
 
-Note::NamingInformation::NamingInformation(scale_degree_value base_degree,
-                                           accidentals_value accidentals)
-    : _base_degree(base_degree), _accidentals(accidentals)
-{
-    // Checking for base_degree referencing a note name that does not exist.
-    if (base_degree > note_names.size() - 1)
-    {
-        throw std::invalid_argument(BAD_SCALE_DEGREE_INDEX);
-    }
-}
+// The default tuning and naming are compiled once, here, instead of in every file using them (see
+// the extern template declarations in musiclibrary.hpp). They come before the compile-time checks
+// below, which would otherwise evaluate constexpr members that GCC then never emits.
+template class BasicNote<DefaultTuning, DefaultNaming>;
+template class BasicPackedNote<DefaultTuning, DefaultNaming>;
+template class BasicRealisedScale<DefaultTuning, DefaultNaming>;
+template class BasicPackedRealisedScale<DefaultTuning, DefaultNaming>;
 
-// We set octave using some simple arithmetic
-Note::MIDIInformation::MIDIInformation(midi_value midi_val)
-    : midi_value_(midi_val),
-      octave_(MIDDLE_C_OCTAVE + ((midi_val - MIDDLE_C_MIDI) / NOTES_PER_OCTAVE) -
-              (midi_val - MIDDLE_C_MIDI < 0 ? 1 : 0))
-{
-}
+// ====INSTANTIATIONS====
+// ====SPELLING====
 
-// Default constructor default to Middle C
-Note::Note() : midi_(MIDDLE_C_MIDI) { names_ = {NamingInformation{0, 0}}; }
-
-// For any MIDI value that requires an accidental, both variants are generated
-std::vector<Note::NamingInformation> Note::generate_naming_information_from_midi(midi_value midi)
+// Compile-time checks of the constexpr spelling tables and functions in musiclibrary.hpp. If any of
+// these stop holding, the library stops compiling.
+namespace
 {
-    midi_value offset_from_middle_c = midi - MIDDLE_C_MIDI;
-    midi_value midi_offset_from_c_in_scale =
-        (NOTES_PER_OCTAVE + (offset_from_middle_c % NOTES_PER_OCTAVE)) % NOTES_PER_OCTAVE;
+/**
+ * @brief The entries of the MIDI offset to spelling table when it was still a std::multimap, as
+ * (MIDI offset, base degree, accidentals), in the order equal_range used to return them.
+ */
+constexpr std::array<std::tuple<midi_value, scale_degree_value, accidentals_value>, 17>
+    reference_offset_spellings{{{0, 0, 0},
+                                {1, 0, 1},
+                                {1, 1, -1},
+                                {2, 1, 0},
+                                {3, 1, 1},
+                                {3, 2, -1},
+                                {4, 2, 0},
+                                {5, 3, 0},
+                                {6, 3, 1},
+                                {6, 4, -1},
+                                {7, 4, 0},
+                                {8, 4, 1},
+                                {8, 5, -1},
+                                {9, 5, 0},
+                                {10, 5, 1},
+                                {10, 6, -1},
+                                {11, 6, 0}}};
 
-    std::vector<NamingInformation> names;
+/**
+ * @brief The entries of the scale degree to MIDI difference table when it was still a std::map.
+ */
+constexpr std::array<std::pair<scale_degree_value, midi_value>, 7> reference_midi_diffs{
+    {{0, 0}, {1, 2}, {2, 4}, {3, 5}, {4, 7}, {5, 9}, {6, 11}}};
 
-    auto range =
-        scale_midi_offset_to_scale_degree_and_accidental.equal_range(midi_offset_from_c_in_scale);
+// The tunings every generic check below runs on
+using Tuning12 = Tuning<12, 7>;
+using Tuning19 = Tuning<19, 7>;
+using Tuning24 = Tuning<24, 7>;
+using Tuning31 = Tuning<31, 7>;
 
-    for (auto it = range.first; it != range.second; ++it)
-    {
-        auto [base_degree, accidental] = it->second;
-        names.emplace_back(base_degree, accidental);
-    }
-
-    return names;
+template <typename TuningPolicy>
+constexpr midi_value pitch_class(midi_value midi)
+{
+    constexpr midi_value steps = TuningPolicy::STEPS_PER_OCTAVE;
+    return (steps + (midi % steps)) % steps;
 }
 
-Note::Note(midi_value midi, bool generate_names) : midi_({midi})
+template <typename TuningPolicy>
+constexpr midi_value pitch_class(Spelling spelling)
 {
-    if (generate_names)
-    {
-        names_ = generate_naming_information_from_midi(midi);
-    }
-    have_to_regenerate_name = true;
+    return pitch_class<TuningPolicy>(TuningPolicy::NATURAL_STEPS[spelling.base_degree] +
+                                     spelling.accidentals * TuningPolicy::SHARP);
 }
 
-void Note::set_note(midi_value midi, bool generate_names)
+constexpr bool midi_diffs_match_reference()
 {
-    midi_ = {midi};
-    names_ = {};
-    if (generate_names)
+    for (auto&& [scale_degree, midi_diff] : reference_midi_diffs)
     {
-        names_ = generate_naming_information_from_midi(midi);
+        if (scale_degree_to_midi_diff[scale_degree] != midi_diff) return false;
     }
-    have_to_regenerate_name = true;
+    return true;
 }
 
-// Expects name to be in the form [Base Note Name][optional multiple # or b chars][optional number
-// for octave]
-std::tuple<Note::NamingInformation, std::optional<Note::MIDIInformation>>
-Note::generate_naming_and_midi_from_string(const std::string& name)
+constexpr bool offset_spellings_match_reference()
 {
-    std::smatch matches;
-    std::regex_search(name, matches, note_name_regex);
-    size_t i = 0;
-    size_t note_name_roots_index = 0;
-    accidentals_value accidentals = 0;
-    int octave = 0;
-    bool octave_found = false;
-    // Iterating and switching over the match groups
-    for (auto&& match : matches)
+    size_t entry = 0;
+    for (midi_value offset = 0; offset < NOTES_PER_OCTAVE; ++offset)
     {
-        switch (i)
+        for (auto&& spelling : scale_midi_offset_to_scale_degree_and_accidental[offset])
         {
-            case 1:  // First match group should be the note name root
-            {
-                auto it = std::find(note_names.begin(), note_names.end(), match.str());
-                auto index = std::distance(note_names.begin(), it);
-                if (static_cast<unsigned long>(index) >= note_names.size())
-                {
-                    bool is_ok = false;
-#ifdef GERMAN_NAMING
-                    // Special-casing for the German naming system (i.e. H flat becomes a B)
-                    if (match.str() == "B")
-                    {
-                        note_name_roots_index = 6;
-                        accidentals = -1;
-                        is_ok = true;
-                    }
-#endif
-                    if (!is_ok) throw std::invalid_argument(INVALID_NOTE_NAME_FOUND);
-                }
-                note_name_roots_index = static_cast<size_t>(index);
-                break;
-            }
-            case 2:  // Second match group should be the flats
-            {
-                if (match.length() > 0)
-                {
-                    accidentals += -static_cast<accidentals_value>(match.length());
-                }
-                break;
-            }
-            case 3:  // Third match group should be sharps
+            if (entry >= reference_offset_spellings.size()) return false;
+            auto [reference_offset, base_degree, accidentals] = reference_offset_spellings[entry];
+            if (reference_offset != offset || spelling != Spelling{base_degree, accidentals})
             {
-                if (match.length() > 0)
-                {
-                    if (accidentals < 0) throw std::invalid_argument(BOTH_ACCIDENTALS_FOUND);
-
-                    accidentals += static_cast<accidentals_value>(match.length());
-                }
-                break;
+                return false;
             }
-            case 4:  // Fourth match group is for the possible octave
-            {
-                if (match.length() > 0)
-                {
-                    // I know that int to int truncation is occuring here. For reasonable octave
-                    // values this is not an issue
-                    octave = std::stoi(match.str());
-                    octave_found = true;
-                }
-                break;
-            }
-        }
-        ++i;
-    }
-
-    NamingInformation ni(note_name_roots_index, accidentals);
-    std::optional<MIDIInformation> mi;
-    if (octave_found)
-    {
-        // MIDI arithmetic
-        midi_value midi_offset_from_scale_c = static_cast<midi_value>(
-            note_name_roots_index * 2 - (note_name_roots_index > 2 ? 1 : 0));
-        midi_value midi = MIDDLE_C_MIDI + ((octave - MIDDLE_C_OCTAVE) * NOTES_PER_OCTAVE) +
-                          midi_offset_from_scale_c + accidentals;
-        mi = MIDIInformation{midi, octave};
-    }
-
-    return std::tuple<NamingInformation, std::optional<MIDIInformation>>{ni, mi};
-}
-
-Note::Note(const std::string& name)
-{
-    // Oooooooh, fancy structured binding, look at this fancy C++ concept
-    auto [naming, midi] = generate_naming_and_midi_from_string(name);
-    names_ = {naming};
-    midi_ = midi;
-}
-
-void Note::set_note(const std::string& name)
-{
-    auto [naming, midi] = generate_naming_and_midi_from_string(name);
-    names_ = {naming};
-    midi_ = midi;
-    have_to_regenerate_name = true;
-}
-
-std::tuple<std::optional<Note::NamingInformation>, std::optional<Note::MIDIInformation>>
-Note::generate_naming_and_midi_from_root_and_scale_degree(const Note& scale_root,
-                                                          scale_degree_value scale_degree,
-                                                          accidentals_value accidentals)
-{
-    // Second scale degree corresponds to index one due to different indexing
-    if (scale_degree == 0)
-    {
-        throw std::invalid_argument(INDEX_BASE_ERROR);
-    }
-
-    scale_degree -= 1;
-
-    std::optional<NamingInformation> namei;
-    std::optional<MIDIInformation> midii;
-
-    // We have to do some pretty gnarly if branching here due to the different outcomes based on
-    // what scale_root looks like.
-
-    if (scale_root.midi_.has_value())
-    {
-        midi_value scale_degree_midi_diff =
-            scale_degree_to_midi_diff.at(scale_degree % note_names.size()) +
-            static_cast<midi_value>((NOTES_PER_OCTAVE * (scale_degree / note_names.size())));
-        midii = {scale_root.midi_.value().midi_value_ + scale_degree_midi_diff + accidentals};
-    }
-
-    if (scale_root.names_.has_value() && scale_root.names_.value().size() == 1)
-    {
-        // This entire block of code took up about 30% of the project time, as trying to transcribe
-        // the intuitive, yet complex rules of scale degree pitch spelling into a formal system is
-        // difficulty. Who'd have guessed?
-
-        // This code block is responsible for figuring out the correct note name and accidental
-        // based on the expected midi difference from the root based on the scale degree and
-        // accidentals.
-
-        // This is needed, as the halfnote steps between E/F and B/C present issues with this.
-        // For example, the minor 3rd from C is Eb (accidental present), but the minor third from E
-        // is G (no accidental).
-        size_t number_of_note_names = note_names.size();
-        scale_degree_value root_base_degree = scale_root.names_.value()[0]._base_degree;
-        scale_degree_value new_base_degree =
-            (root_base_degree + scale_degree) % number_of_note_names;
-        midi_value root_midi_offset_from_c = scale_degree_to_midi_diff.at(root_base_degree) +
-                                             scale_root.names_.value()[0]._accidentals;
-        midi_value scale_degree_without__accidentalsmidi_offset_from_c =
-            scale_degree_to_midi_diff.at(new_base_degree);
-        if (scale_degree_without__accidentalsmidi_offset_from_c < root_midi_offset_from_c)
-        {
-            scale_degree_without__accidentalsmidi_offset_from_c += NOTES_PER_OCTAVE;
+            ++entry;
         }
-        midi_value expected_midi_diff_from_root =
-            scale_degree_to_midi_diff.at(scale_degree % number_of_note_names) + accidentals;
-        midi_value unaccidented_midi_diff_from_root =
-            scale_degree_without__accidentalsmidi_offset_from_c - root_midi_offset_from_c;
-        accidentals_value needed_accidentals = static_cast<accidentals_value>(
-            expected_midi_diff_from_root - unaccidented_midi_diff_from_root);
-        namei = {static_cast<scale_degree_value>(new_base_degree), needed_accidentals};
     }
-
-    if (!scale_root.midi_.has_value() && scale_root.names_.has_value() &&
-        scale_root.names_.value().size() != 1)
-    {
-        throw std::invalid_argument(CREATION_NOT_BOTH_INFORMATION);
-    }
-
-    return std::tuple{namei, midii};
-}
-
-Note::Note(const Note& scale_root, scale_degree_value scale_degree, accidentals_value accidentals)
-{
-    auto [naming, midi] =
-        generate_naming_and_midi_from_root_and_scale_degree(scale_root, scale_degree, accidentals);
-    midi_ = midi;
-    if (naming.has_value()) names_ = {naming.value()};
-}
-
-void Note::set_note(const Note& scale_root, scale_degree_value scale_degree,
-                    accidentals_value accidentals)
-{
-    auto [naming, midi] =
-        generate_naming_and_midi_from_root_and_scale_degree(scale_root, scale_degree, accidentals);
-    midi_ = midi;
-    if (naming.has_value()) names_ = {naming.value()};
-    have_to_regenerate_name = true;
+    return entry == reference_offset_spellings.size();
 }
 
-std::string Note::generate_name_as_string() const
+// Every spelling of a step has to sound that step, and a step with two spellings has to have the
+// second as the next_enharmonic of the first (which is what PackedNote relies on)
+template <typename TuningPolicy>
+constexpr bool offset_spellings_are_consistent()
 {
-    std::ostringstream stream;
-    bool first = true;
-    for (auto&& naming_info : names_.value())
+    for (midi_value offset = 0; offset < TuningPolicy::STEPS_PER_OCTAVE; ++offset)
     {
-        if (!first) stream << NOTE_PRINT_SEPERATOR;
-
-#ifdef GERMAN_NAMING
-        // German special casing for H flat becoming B
-        if (naming_info._base_degree == 6 && naming_info._accidentals < 0)
+        const OffsetSpellings& spellings =
+            TuningPolicy::OFFSET_SPELLINGS[static_cast<size_t>(offset)];
+        for (auto&& spelling : spellings)
         {
-            stream << 'B';
+            if (pitch_class<TuningPolicy>(spelling) != offset) return false;
         }
-        else
+        if (spellings.count == 2 &&
+            TuningPolicy::next_enharmonic(spellings.spellings[0]) != spellings.spellings[1])
         {
-            stream << note_names[naming_info._base_degree];
+            return false;
         }
-#endif
-#ifndef GERMAN_NAMING
-        stream << note_names[naming_info._base_degree];
-#endif
-        std::string accidental =
-            naming_info._accidentals < 0 ? downward_accidental : upward_accidental;
-
-        int amount_of_accidentals =
-            naming_info._accidentals < 0 ? naming_info._accidentals * -1 : naming_info._accidentals;
-
-#ifdef GERMAN_NAMING
-        // German special casing
-        if (naming_info._base_degree == 6 && naming_info._accidentals < 0)
-        {
-            amount_of_accidentals -= 1;
-        }
-#endif
-
-        for (int i = 0; i < amount_of_accidentals; ++i)
-        {
-            stream << accidental;
-        }
-
-        first = false;
     }
-
-    return stream.str();
-}
-
-std::string& Note::get_name()
-{
-    if (!(check_has_name())) throw std::runtime_error(NO_NAME_INFORMATION);
-    if (have_to_regenerate_name) name_as_string = generate_name_as_string();
-    return name_as_string;
-}
-
-std::string Note::get_name() const
-{
-    if (!(check_has_name())) throw std::runtime_error(NO_NAME_INFORMATION);
-    if (!have_to_regenerate_name) return name_as_string;
-    return generate_name_as_string();
+    return true;
 }
 
-std::string Note::generate_complex_name_as_string() const
+// Every spelling must land on the right note name root and sound the right pitch class, for any
+// root (with up to two accidentals) and scale degrees up to two octaves
+template <typename TuningPolicy>
+constexpr bool spellings_are_consistent()
 {
-    std::ostringstream stream;
-    int octave = midi_.value().octave_;
-
-    bool first = true;
-    for (auto&& naming_information : names_.value())
-    {
-        if (!first) stream << NOTE_PRINT_SEPERATOR;
-
-        stream << get_name();
-
-        stream << octave << " (" << midi_.value().midi_value_ << ')';
-
-        first = false;
-    }
-
-    return stream.str();
-}
-
-std::string& Note::get_name_and_midi_string()
-{
-    if (!check_has_midi() || !check_has_name()) throw std::runtime_error(NOT_BOTH_INFORMATION);
-    if (have_to_regenerate_name) complex_name = generate_complex_name_as_string();
-    return complex_name;
-}
-
-std::string Note::get_name_and_midi_string() const
-{
-    if (!check_has_midi() || !check_has_name()) throw std::runtime_error(NOT_BOTH_INFORMATION);
-    if (!have_to_regenerate_name)
-    {
-        return complex_name;
-    }
-    return generate_complex_name_as_string();
-}
-
-// Tries to print out as much information as it can
-std::ostream& operator<<(std::ostream& stream, const Note& note)
-{
-    if (note.check_has_midi() && note.check_has_name())
-        stream << note.get_name_and_midi_string();
-    else if (note.check_has_midi())
-    {
-        stream << note.get_midi();
-    }
-    else if (note.check_has_name())
-    {
-        stream << note.get_name();
-    }
-    else
+    constexpr scale_degree_value degrees = TuningPolicy::NUMBER_OF_SCALE_DEGREES;
+    for (scale_degree_value root_degree = 0; root_degree < degrees; ++root_degree)
     {
-        throw std::runtime_error(NO_NAME_INFORMATION);
-    }
-
-    return stream;
-}
-
-// ====NOTE====
-// ====SCALE====
-
-Scale::scale_degree Scale::parse_scale_degree_string(const std::string& input)
-{
-    std::smatch matches;
-    std::regex_search(input, matches, scale_degree_regex);
-    size_t i = 0;
-    scale_degree_value sd = 0;
-    accidentals_value accidentals = 0;
-    for (auto&& match : matches)
-    {
-        switch (i)
+        for (accidentals_value root_accidentals = -2; root_accidentals <= 2; ++root_accidentals)
         {
-            case 1:  // First match group should be the flats
+            Spelling root{root_degree, root_accidentals};
+            for (scale_degree_value degree = 0; degree < 2 * degrees; ++degree)
             {
-                if (match.length() > 0)
+                for (accidentals_value accidentals = -2; accidentals <= 2; ++accidentals)
                 {
-                    accidentals = -static_cast<accidentals_value>(match.length());
-                }
-                break;
-            }
-            case 2:  // Second match group should be the sharps
-            {
-                if (match.length() > 0)
-                {
-                    if (accidentals < 0)
+                    Spelling spelled = TuningPolicy::spell_scale_degree(root, degree, accidentals);
+                    if (spelled.base_degree != (root_degree + degree) % degrees)
                     {
-                        throw std::invalid_argument(BOTH_ACCIDENTALS_FOUND);
+                        return false;
+                    }
+                    if (pitch_class<TuningPolicy>(spelled) !=
+                        pitch_class<TuningPolicy>(pitch_class<TuningPolicy>(root) +
+                                                  TuningPolicy::scale_degree_offset(degree) +
+                                                  accidentals * TuningPolicy::SHARP))
+                    {
+                        return false;
                     }
-
-                    accidentals = static_cast<accidentals_value>(match.length());
-                }
-                break;
-            }
-            case 3:  // Third match group should be the scale degree
-            {
-                if (match.length() > 0)
-                {
-                    sd = static_cast<scale_degree_value>(std::stoi(match.str()));
-                }
-                else
-                {
-                    throw std::invalid_argument(NO_SCALE_DEGREE);
                 }
             }
         }
-        ++i;
     }
-
-    return {sd, accidentals};
-}
-
-std::istream& operator>>(std::istream& stream, Scale& scale)
-{
-    std::string scale_degree_str;
-
-    scale.clear();
-
-    while (std::getline(stream, scale_degree_str, SCALE_DEGREE_SEPERATOR))
-    {
-        scale._scale_degrees.emplace_back(Scale::parse_scale_degree_string(scale_degree_str));
-    }
-
-    return stream;
-}
-
-std::ostream& operator<<(std::ostream& stream, const Scale& scale)
-{
-    bool first = true;
-    for (auto&& sd : scale._scale_degrees)
-    {
-        if (!first) stream << SCALE_DEGREE_SEPERATOR << ' ';
-        if (sd.second < 0)
-        {
-            for (accidentals_value acc_i = 0; acc_i > sd.second; --acc_i)
-            {
-                stream << downward_accidental;
-            }
-        }
-        else if (sd.second > 0)
-        {
-            for (accidentals_value acc_i = 0; acc_i > sd.second; ++acc_i)
-            {
-                stream << upward_accidental;
-            }
-        }
-        stream << sd.first;
-
-        first = false;
-    }
-    return stream;
-}
-
+    return true;
+}
+
+static_assert(midi_diffs_match_reference());
+static_assert(offset_spellings_match_reference());
+static_assert(std::is_same_v<DefaultTuning, Tuning12>);
+
+static_assert(offset_spellings_are_consistent<Tuning12>());
+static_assert(offset_spellings_are_consistent<Tuning19>());
+static_assert(offset_spellings_are_consistent<Tuning24>());
+static_assert(offset_spellings_are_consistent<Tuning31>());
+static_assert(spellings_are_consistent<Tuning12>());
+static_assert(spellings_are_consistent<Tuning19>());
+static_assert(spellings_are_consistent<Tuning24>());
+static_assert(spellings_are_consistent<Tuning31>());
+
+// A few spellings that are easy to get wrong (degrees here are 0-based)
+static_assert(spell_scale_degree({0, 0}, 2, -1) == Spelling{2, -1});  // C minor third is Eb
+static_assert(spell_scale_degree({2, 0}, 2, -1) == Spelling{4, 0});   // E minor third is G
+static_assert(spell_scale_degree({3, 1}, 6, 0) == Spelling{2, 1});    // F# major seventh is E#
+static_assert(spell_scale_degree({4, -1}, 3, 0) == Spelling{0, -1});  // Gb fourth is Cb
+static_assert(spell_scale_degree({6, 0}, 1, -1) == Spelling{0, 0});   // B minor second is C
+static_assert(spell_scale_degree({6, 1}, 7, 0) == Spelling{6, 1});    // B# octave is B#
+static_assert(spell_scale_degree({1, -2}, 6, 0) == Spelling{0, -1});  // Dbb major seventh is Cb
+static_assert(scale_degree_midi_offset(8) == 14);                     // The ninth
+static_assert(octave_of_midi(MIDDLE_C_MIDI) == MIDDLE_C_OCTAVE);
+
+// The microtonal tunings have their own tables: C# and Db are different steps in 19-EDO, where E#
+// and Fb are the same one, and 24-EDO has quarter tones that are left unnamed
+static_assert(Tuning19::SHARP == 1 && Tuning19::NATURAL_STEPS[6] == 17);
+static_assert(Tuning19::OFFSET_SPELLINGS[1].count == 1 && Tuning19::OFFSET_SPELLINGS[2].count == 1);
+static_assert(Tuning19::OFFSET_SPELLINGS[7].count == 2);
+static_assert(Tuning24::SHARP == 2 && Tuning24::OFFSET_SPELLINGS[1].count == 0);
+static_assert(Tuning31::SHARP == 2 && Tuning31::MIDDLE_C == 155);
+static_assert(Tuning31::spell_scale_degree({3, 1}, 6, 0) == Spelling{2, 1});  // F# to E# again
+
+// And the spelling also works on PackedNotes at compile time (1-based degrees here)
+static_assert(PackedNote{PackedNote{{1, -1}, 61}, 3, -1}.get_base_degree() == 3);  // Db -> Fb
+static_assert(PackedNote{PackedNote{{1, -1}, 61}, 3, -1}.get_accidentals() == -1);
+static_assert(PackedNote{PackedNote{{1, -1}, 61}, 3, -1}.get_midi() == 64);
+
+// The minor third of middle C is two steps below E in 31-EDO
+using PackedNote31 = BasicPackedNote<Tuning31, EnglishNaming>;
+static_assert(PackedNote31{PackedNote31{{0, 0}, Tuning31::MIDDLE_C}, 3, -1}.get_midi() == 163);
+}  // namespace
+
+// ====SPELLING====
 // ====SCALE====
-// ====REALISEDSCALE====
 
-std::vector<Note> RealisedScale::realise_scale(const Note& root, const Scale& scale)
+// Compile-time checks of the _scale literal, parsed with the same rules as the >> operators
+namespace
 {
-    std::vector<Note> result;
-    for (auto&& sd : scale)
-    {
-        if (sd.first == 1)
-        {
-            result.emplace_back(root);
-        }
-        else
-        {
-            result.emplace_back(Note{root, sd.first, sd.second});
-        }
-    }
-
-    return result;
-}
+constexpr auto natural_minor = "1,2,b3,4,5,b6,b7"_scale;
+static_assert(natural_minor.size() == 7);
+static_assert(natural_minor[2] == Scale::scale_degree{3, -1});
+static_assert("1,##2,9,"_scale == StaticScale<3>{{{{1, 0}, {2, 2}, {9, 0}}}});
 
-RealisedScale::RealisedScale(const Note& root, const Scale& scale)
-{
-    _notes = realise_scale(root, scale);
-}
+// C4 natural minor, spelled and with MIDI values, without ever running
+constexpr auto c_natural_minor = natural_minor.realise(PackedNote{{0, 0}, MIDDLE_C_MIDI});
+static_assert(c_natural_minor[0].get_midi() == MIDDLE_C_MIDI);
+static_assert(c_natural_minor[2].get_base_degree() == 2);  // Eb
+static_assert(c_natural_minor[2].get_accidentals() == -1);
+static_assert(c_natural_minor[5].get_midi() == 68 && c_natural_minor[6].get_midi() == 70);
 
-std::ostream& operator<<(std::ostream& stream, const RealisedScale& scale)
-{
-    bool first = true;
-    for (auto&& note : scale._notes)
-    {
-        if (!first) stream << SCALE_DEGREE_SEPERATOR << ' ';
-        first = false;
-        stream << note.get_name();
-    }
-    return stream;
-}
+// The same scale in 19-EDO, from the same literal
+constexpr auto c_natural_minor_19 =
+    natural_minor.realise(BasicPackedNote<Tuning19, EnglishNaming>{{0, 0}, Tuning19::MIDDLE_C});
+static_assert(c_natural_minor_19[2].get_midi() == Tuning19::MIDDLE_C + 5);  // Eb
+static_assert(c_natural_minor_19[6].get_midi() == Tuning19::MIDDLE_C + 16);
+}  // namespace
 
-// ====REALISEDSCALE====
+// ====SCALE====
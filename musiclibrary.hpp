@@ -3,13 +3,23 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
 #include <exception>
+#include <format>
 #include <iostream>
-#include <map>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
 #include <optional>
-#include <regex>
+#include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 // Constants kept together here, as this library should be able to used without being attached to
@@ -30,535 +40,2616 @@ constexpr char NO_SCALE_DEGREE[] = "No scale degree passed in string!";
 constexpr char BAD_SCALE_DEGREE_INDEX[] = "Scale degree is not a valid index!";
 
 constexpr char INDEX_BASE_ERROR[] = "No such thing as as a 0th scale degree. Use 1-based indexing.";
+constexpr char CANNOT_PACK_NOTE[] =
+    "Note cannot be packed; it has more names than a spelling and its enharmonic, or its values "
+    "are out of the packable range.";
+constexpr char BAD_FORMAT_SPEC[] = "Unsupported format spec for a music library type.";
+constexpr char WRONG_NUMBER_OF_SCALE_DEGREES[] =
+    "Passed string has a different number of scale degrees than the StaticScale.";
+constexpr char BAD_TUNING[] =
+    "Tuning cannot be spelled; its naturals are not distinct, or a step has spellings that are "
+    "not a sharp and the flat of the next note name root.";
 
 // Type aliases
 using midi_value = int;
 using accidentals_value = short;
 using scale_degree_value = size_t;
 
-// Music-related constants
-constexpr midi_value MIDDLE_C_MIDI = 60;
+// Music-related constants (the ones that depend on the tuning are part of Tuning below)
 constexpr int MIDDLE_C_OCTAVE = 4;
-constexpr midi_value NOTES_PER_OCTAVE = 12;
-constexpr scale_degree_value NUMBER_OF_SCALE_DEGREES = 7;
 
 // Output-related constants
 constexpr char NOTE_PRINT_SEPERATOR = '/';
 constexpr char SCALE_DEGREE_SEPERATOR = ',';
 
-// I use this method of setting the specific constants based on the style. This is a compile-time
-// change, and not something for users to mess with, but for the developers to change based on their
-// needs
-#if !defined(GERMAN_NAMING) && !defined(FRENCH_NAMING)
-#define ENGLISH_NAMING
+// ====SPELLING====
+
+// The tables and functions in this section are the arithmetic behind pitch spelling. They are all
+// constexpr, so spelling can happen at compile time, and at runtime it is a few array lookups
+// rather than walking through std::map nodes. Every tuning has tables of its own (see Tuning), and
+// the static_asserts in musiclibrary.cpp check them. These use 0-based indexing throughout.
+
+/**
+ * @brief A spelling of a note, i.e. a note name root (index into the note names, so C = 0) and the
+ * accidentals applied to it.
+ *
+ */
+struct Spelling
+{
+    scale_degree_value base_degree;
+    accidentals_value accidentals;
+
+    friend constexpr bool operator==(const Spelling&, const Spelling&) = default;
+};
+
+/**
+ * @brief All the spellings (up to one accidental) that a given MIDI offset from C can have. Steps
+ * of some tunings have none (e.g. the quarter tones of 24-EDO).
+ *
+ */
+struct OffsetSpellings
+{
+    std::array<Spelling, 2> spellings;
+    size_t count;
+
+    inline constexpr OffsetSpellings() : spellings{}, count(0) {}
+    inline constexpr OffsetSpellings(Spelling only) : spellings{only, only}, count(1) {}
+    inline constexpr OffsetSpellings(Spelling sharp, Spelling flat)
+        : spellings{sharp, flat}, count(2)
+    {
+    }
+
+    inline constexpr auto begin() const { return spellings.begin(); }
+    inline constexpr auto end() const { return spellings.begin() + count; }
+};
+
+/**
+ * @brief Tuning policy: the octave divided into EDO equal steps, with Degrees note name roots
+ * spelled along a chain of fifths. Tuning<12, 7> is the usual twelve-tone equal temperament;
+ * Tuning<19, 7>, Tuning<24, 7> and Tuning<31, 7> are the common microtonal ones.
+ *
+ * The tables every tuning needs are built from its parameters at compile time, so each tuning has
+ * its own, and spelling in any of them is the same few lookups as in 12-EDO, without a runtime
+ * branch on the tuning. Steps are counted the way MIDI counts semitones, with middle C at
+ * (MIDDLE_C_OCTAVE + 1) * EDO, so for 12-EDO they are MIDI values; the library calls them MIDI
+ * values for every tuning.
+ *
+ * The fifth is the step nearest to a just 3/2. The naturals are one fifth down and Degrees - 2
+ * fifths up from C (F C G D A E B for 7 degrees), and an accidental moves by the chroma, i.e.
+ * Degrees fifths less the nearest whole octaves (a step in 12- and 19-EDO, two in 24- and
+ * 31-EDO). Steps that are no natural with at most one accidental within the octave have no names.
+ *
+ * @tparam EDO - number of equal steps to the octave
+ * @tparam Degrees - number of note name roots, i.e. of scale degrees to the octave
+ */
+template <midi_value EDO, scale_degree_value Degrees>
+struct Tuning
+{
+    static_assert(EDO > 0 && Degrees > 1 && Degrees <= static_cast<scale_degree_value>(EDO));
+
+    static constexpr midi_value STEPS_PER_OCTAVE = EDO;
+    static constexpr scale_degree_value NUMBER_OF_SCALE_DEGREES = Degrees;
+    static constexpr midi_value MIDDLE_C = (MIDDLE_C_OCTAVE + 1) * EDO;
+
+    /**
+     * @brief Steps of the fifth (log2(3/2) of the octave, rounded).
+     *
+     */
+    static constexpr midi_value FIFTH = static_cast<midi_value>(EDO * 0.5849625007211562 + 0.5);
+
+    /**
+     * @brief Steps an accidental moves a note by.
+     *
+     */
+    static constexpr midi_value SHARP =
+        static_cast<midi_value>(Degrees) * FIFTH -
+        EDO * ((static_cast<midi_value>(Degrees) * FIFTH + EDO / 2) / EDO);
+    static_assert(SHARP > 0);
+
+    /**
+     * @brief Mapping from a given scale degree (without accidentals) to the MIDI offset from the
+     * scale root
+     *
+     */
+    static constexpr std::array<midi_value, Degrees> NATURAL_STEPS = []
+    {
+        std::array<midi_value, Degrees> steps{};
+        for (size_t i = 0; i < Degrees; ++i)
+        {
+            midi_value fifths = static_cast<midi_value>(i) - 1;
+            steps[i] = ((fifths * FIFTH) % EDO + EDO) % EDO;
+        }
+        std::sort(steps.begin(), steps.end());
+        if (std::adjacent_find(steps.begin(), steps.end()) != steps.end())
+        {
+            throw std::invalid_argument(BAD_TUNING);
+        }
+        return steps;
+    }();
+
+    /**
+     * @brief Mapping from a given MIDI offset from the scale root to what scale degree (and
+     * accidentals) a note is. A natural is the only spelling of its step; otherwise the sharp comes
+     * before the flat, which is always its next_enharmonic.
+     *
+     */
+    static constexpr std::array<OffsetSpellings, EDO> OFFSET_SPELLINGS = []
+    {
+        std::array<OffsetSpellings, EDO> spellings{};
+        for (size_t base_degree = 0; base_degree < Degrees; ++base_degree)
+        {
+            spellings[static_cast<size_t>(NATURAL_STEPS[base_degree])] =
+                OffsetSpellings{Spelling{base_degree, 0}};
+        }
+        for (size_t base_degree = 0; base_degree < Degrees; ++base_degree)
+        {
+            for (accidentals_value accidentals : std::array<accidentals_value, 2>{1, -1})
+            {
+                midi_value step = NATURAL_STEPS[base_degree] + accidentals * SHARP;
+                if (step < 0 || step >= EDO) continue;
+                OffsetSpellings& entry = spellings[static_cast<size_t>(step)];
+                if (entry.count == 1 && entry.spellings[0].accidentals == 0) continue;
+                if (entry.count == 0)
+                {
+                    entry = OffsetSpellings{Spelling{base_degree, accidentals}};
+                }
+                else if (entry.count == 1 && entry.spellings[0].accidentals == 1 &&
+                         accidentals == -1 && entry.spellings[0].base_degree + 1 == base_degree)
+                {
+                    entry = OffsetSpellings{entry.spellings[0], {base_degree, accidentals}};
+                }
+                else
+                {
+                    throw std::invalid_argument(BAD_TUNING);
+                }
+            }
+        }
+        return spellings;
+    }();
+
+    /**
+     * @brief Returns the MIDI offset of a scale degree (without accidentals) from the scale root.
+     *
+     * Scale degrees past the octave add whole octaves to the offset.
+     *
+     * @param scale_degree - which scale degree
+     * @return midi_value
+     */
+    static constexpr midi_value scale_degree_offset(scale_degree_value scale_degree)
+    {
+        return NATURAL_STEPS[scale_degree % Degrees] +
+               static_cast<midi_value>(EDO * (scale_degree / Degrees));
+    }
+
+    /**
+     * @brief Returns the octave a MIDI value falls into (middle C starts octave 4).
+     *
+     * @param midi - the MIDI value
+     * @return int
+     */
+    static constexpr int octave_of(midi_value midi)
+    {
+        return MIDDLE_C_OCTAVE + ((midi - MIDDLE_C) / EDO) - (midi - MIDDLE_C < 0 ? 1 : 0);
+    }
+
+    /**
+     * @brief Returns all spellings (up to one accidental) of a MIDI value.
+     *
+     * @param midi - the MIDI value to spell
+     * @return const OffsetSpellings&
+     */
+    static constexpr const OffsetSpellings& spellings_of(midi_value midi)
+    {
+        midi_value offset_from_middle_c = midi - MIDDLE_C;
+        midi_value offset_from_c_in_scale = (EDO + (offset_from_middle_c % EDO)) % EDO;
+        return OFFSET_SPELLINGS[static_cast<size_t>(offset_from_c_in_scale)];
+    }
+
+    /**
+     * @brief Does the pitch spelling of a scale degree based off the spelling of the scale root.
+     *
+     * This is needed, as the steps between note name roots are not all the same size. For example,
+     * the minor 3rd from C is Eb (accidental present), but the minor third from E is G (no
+     * accidental). So we figure out which note name root the scale degree lands on, and then how
+     * many accidentals it needs to be the expected MIDI difference away from the root.
+     *
+     * @param root - the Spelling of the scale root
+     * @param scale_degree - which scale degree should be spelled
+     * @param accidentals - which way and by how much accidentals should be applied (-1 is flat, -2
+     * is double flat, +1 is sharp etc.)
+     * @return Spelling
+     */
+    static constexpr Spelling spell_scale_degree(Spelling root, scale_degree_value scale_degree,
+                                                 accidentals_value accidentals)
+    {
+        scale_degree_value step = scale_degree % Degrees;
+        scale_degree_value new_base_degree = root.base_degree + step;
+        // Wrapping around the octave, written as arithmetic so it compiles without a branch
+        bool wraps = new_base_degree >= Degrees;
+        new_base_degree -= Degrees * wraps;
+        midi_value root_midi_offset_from_c =
+            NATURAL_STEPS[root.base_degree] + root.accidentals * SHARP;
+        midi_value unaccidented_midi_offset_from_c = NATURAL_STEPS[new_base_degree] + EDO * wraps;
+        midi_value expected_midi_diff_from_root = NATURAL_STEPS[step] + accidentals * SHARP;
+        midi_value unaccidented_midi_diff_from_root =
+            unaccidented_midi_offset_from_c - root_midi_offset_from_c;
+        return {new_base_degree,
+                static_cast<accidentals_value>(
+                    (expected_midi_diff_from_root - unaccidented_midi_diff_from_root) / SHARP)};
+    }
+
+    /**
+     * @brief Returns the enharmonic spelling using the next note name root (e.g. C# to Db). Only
+     * meaningful for spellings that have one, i.e. the sharps that OFFSET_SPELLINGS pairs up.
+     *
+     * @param spelling - the Spelling to respell
+     * @return Spelling
+     */
+    static constexpr Spelling next_enharmonic(Spelling spelling)
+    {
+        scale_degree_value next_base_degree = (spelling.base_degree + 1) % Degrees;
+        midi_value step = NATURAL_STEPS[next_base_degree] - NATURAL_STEPS[spelling.base_degree];
+        step += EDO * (step < 0);
+        return {next_base_degree,
+                static_cast<accidentals_value>(spelling.accidentals - step / SHARP)};
+    }
+};
+
+/**
+ * @brief The tuning of the aliases without a prefix (Note, Scale etc.), which is what the rest of
+ * the application works in.
+ *
+ */
+using DefaultTuning = Tuning<12, 7>;
+
+// The default tuning's values under their old names, which the 12-EDO code around the library
+// (BatchRealiser, ScaleIndex etc.) is written against
+constexpr midi_value MIDDLE_C_MIDI = DefaultTuning::MIDDLE_C;
+constexpr midi_value NOTES_PER_OCTAVE = DefaultTuning::STEPS_PER_OCTAVE;
+constexpr scale_degree_value NUMBER_OF_SCALE_DEGREES = DefaultTuning::NUMBER_OF_SCALE_DEGREES;
+inline constexpr const auto& scale_degree_to_midi_diff = DefaultTuning::NATURAL_STEPS;
+inline constexpr const auto& scale_midi_offset_to_scale_degree_and_accidental =
+    DefaultTuning::OFFSET_SPELLINGS;
+
+/**
+ * @brief Tuning::scale_degree_offset of the default tuning.
+ *
+ */
+inline constexpr midi_value scale_degree_midi_offset(scale_degree_value scale_degree)
+{
+    return DefaultTuning::scale_degree_offset(scale_degree);
+}
+
+/**
+ * @brief Tuning::octave_of of the default tuning.
+ *
+ */
+inline constexpr int octave_of_midi(midi_value midi) { return DefaultTuning::octave_of(midi); }
+
+/**
+ * @brief Tuning::spellings_of of the default tuning.
+ *
+ */
+inline constexpr const OffsetSpellings& spellings_of_midi(midi_value midi)
+{
+    return DefaultTuning::spellings_of(midi);
+}
+
+/**
+ * @brief Tuning::spell_scale_degree of the default tuning.
+ *
+ */
+inline constexpr Spelling spell_scale_degree(Spelling root, scale_degree_value scale_degree,
+                                             accidentals_value accidentals)
+{
+    return DefaultTuning::spell_scale_degree(root, scale_degree, accidentals);
+}
+
+/**
+ * @brief Tuning::next_enharmonic of the default tuning.
+ *
+ */
+inline constexpr Spelling next_enharmonic(Spelling spelling)
+{
+    return DefaultTuning::next_enharmonic(spelling);
+}
+
+// ====SPELLING====
+// ====NAMING====
+
+// Naming policies: how note name roots and accidentals are written. Each one is a type with the
+// same static members, so the library types take one as a template parameter.
+
+/**
+ * @brief A name written in place of a note name root with accidentals, e.g. B for H flat in German.
+ *
+ */
+struct SpecialName
+{
+    std::string_view _name;
+    Spelling _spelling;
+};
+
+/**
+ * @brief C D E F G A B, with b and #.
+ *
+ */
+struct EnglishNaming
+{
+    static constexpr std::array<std::string_view, 7> NOTE_NAMES{"C", "D", "E", "F", "G", "A", "B"};
+    static constexpr std::string_view DOWNWARD_ACCIDENTAL{"b"};
+    static constexpr std::string_view UPWARD_ACCIDENTAL{"#"};
+    static constexpr std::array<SpecialName, 0> SPECIAL_NAMES{};
+};
+
+/**
+ * @brief C D E F G A H, with b and #, and B for H flat.
+ *
+ */
+struct GermanNaming
+{
+    static constexpr std::array<std::string_view, 7> NOTE_NAMES{"C", "D", "E", "F", "G", "A", "H"};
+    static constexpr std::string_view DOWNWARD_ACCIDENTAL{"b"};
+    static constexpr std::string_view UPWARD_ACCIDENTAL{"#"};
+    static constexpr std::array<SpecialName, 1> SPECIAL_NAMES{{{"B", {6, -1}}}};
+};
+
+/**
+ * @brief Do Re Mi Fa Sol La Si, with bemol and diese.
+ *
+ */
+struct FrenchNaming
+{
+    static constexpr std::array<std::string_view, 7> NOTE_NAMES{"Do",  "Re", "Mi", "Fa",
+                                                                "Sol", "La", "Si"};
+    static constexpr std::string_view DOWNWARD_ACCIDENTAL{" bemol"};
+    static constexpr std::string_view UPWARD_ACCIDENTAL{" diese"};
+    static constexpr std::array<SpecialName, 0> SPECIAL_NAMES{};
+};
+
+// The naming of the aliases without a prefix can still be picked with GERMAN_NAMING or
+// FRENCH_NAMING. This is a compile-time change, and not something for users to mess with, but for
+// the developers to change based on their needs
+#if defined(GERMAN_NAMING)
+using DefaultNaming = GermanNaming;
+#elif defined(FRENCH_NAMING)
+using DefaultNaming = FrenchNaming;
+#else
+using DefaultNaming = EnglishNaming;
 #endif
 
-// Setting accidental style
-#if defined(GERMAN_NAMING) || defined(ENGLISH_NAMING)
-constexpr char downward_accidental[] = "b";
-const char upward_accidental[] = "#";
-#endif
+// The default naming's values under their old names
+inline constexpr const auto& note_names = DefaultNaming::NOTE_NAMES;
+constexpr std::string_view downward_accidental = DefaultNaming::DOWNWARD_ACCIDENTAL;
+constexpr std::string_view upward_accidental = DefaultNaming::UPWARD_ACCIDENTAL;
+
+// ====NAMING====
+// ====FORMATTING====
+
+/**
+ * @brief Writes an integer in decimal to an output iterator, without going through a stream.
+ *
+ * @tparam OutputIt - output iterator accepting char
+ * @tparam Integer - integral type of the value
+ * @param out - where to write the digits
+ * @param value - the value to write
+ * @return OutputIt - iterator past the last written character
+ */
+template <typename OutputIt, typename Integer>
+OutputIt format_integer_to(OutputIt out, Integer value)
+{
+    // Enough for every digit and a sign
+    std::array<char, std::numeric_limits<Integer>::digits10 + 2> buffer;
+    auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    return std::copy(buffer.data(), end, out);
+}
+
+/**
+ * @brief Writes a string to an output iterator.
+ *
+ * @tparam OutputIt - output iterator accepting char
+ * @param out - where to write the string
+ * @param text - the string to write
+ * @return OutputIt - iterator past the last written character
+ */
+template <typename OutputIt>
+constexpr OutputIt format_string_to(OutputIt out, std::string_view text)
+{
+    return std::copy(text.begin(), text.end(), out);
+}
+
+/**
+ * @brief Writes the name of a spelling (note name root and accidentals) to an output iterator.
+ *
+ * This renders the name from scratch; rendered_name below has the common ones ready-made.
+ *
+ * @tparam NamingPolicy - how to write the name (e.g. EnglishNaming)
+ * @tparam OutputIt - output iterator accepting char
+ * @param out - where to write the name
+ * @param spelling - the spelling to name
+ * @return OutputIt - iterator past the last written character
+ */
+template <typename NamingPolicy = DefaultNaming, typename OutputIt>
+constexpr OutputIt format_spelling_to(OutputIt out, Spelling spelling)
+{
+    std::string_view name = NamingPolicy::NOTE_NAMES[spelling.base_degree];
+    int amount_of_accidentals = spelling.accidentals < 0 ? -spelling.accidentals
+                                                         : spelling.accidentals;
+    // Special names take over some of the accidentals (e.g. German H flat becoming B)
+    for (auto&& special : NamingPolicy::SPECIAL_NAMES)
+    {
+        int special_accidentals = special._spelling.accidentals < 0
+                                      ? -special._spelling.accidentals
+                                      : special._spelling.accidentals;
+        if (special._spelling.base_degree == spelling.base_degree &&
+            special._spelling.accidentals * spelling.accidentals > 0 &&
+            special_accidentals <= amount_of_accidentals)
+        {
+            name = special._name;
+            amount_of_accidentals -= special_accidentals;
+            break;
+        }
+    }
+    out = format_string_to(out, name);
+
+    std::string_view accidental = spelling.accidentals < 0 ? NamingPolicy::DOWNWARD_ACCIDENTAL
+                                                           : NamingPolicy::UPWARD_ACCIDENTAL;
+    for (int i = 0; i < amount_of_accidentals; ++i)
+    {
+        out = format_string_to(out, accidental);
+    }
+    return out;
+}
+
+/**
+ * @brief Names with up to this many accidentals (either way) are pre-rendered.
+ *
+ */
+constexpr accidentals_value MAX_RENDERED_ACCIDENTALS = 3;
+
+/**
+ * @brief A note name rendered at compile time, stored inline.
+ *
+ */
+struct RenderedName
+{
+    // Fits the longest name with MAX_RENDERED_ACCIDENTALS in every naming style
+    std::array<char, 24> characters{};
+    size_t length = 0;
+
+    inline constexpr std::string_view view() const { return {characters.data(), length}; }
+};
+
+/**
+ * @brief Every name with up to MAX_RENDERED_ACCIDENTALS accidentals, rendered at compile time, for
+ * each naming policy. Indexed by base_degree * (2 * MAX_RENDERED_ACCIDENTALS + 1) + accidentals +
+ * MAX_RENDERED_ACCIDENTALS.
+ *
+ * @tparam NamingPolicy - how the names are written
+ */
+template <typename NamingPolicy>
+constexpr auto rendered_names = []
+{
+    constexpr size_t accidental_range = 2 * MAX_RENDERED_ACCIDENTALS + 1;
+    std::array<RenderedName, NamingPolicy::NOTE_NAMES.size() * accidental_range> names{};
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        Spelling spelling{i / accidental_range, static_cast<accidentals_value>(
+                                                    static_cast<int>(i % accidental_range) -
+                                                    MAX_RENDERED_ACCIDENTALS)};
+        // Rendered into a roomier buffer first; as this runs at compile time, the throw stops
+        // compilation if a name style ever outgrows RenderedName
+        std::array<char, 64> buffer{};
+        size_t length = static_cast<size_t>(
+            format_spelling_to<NamingPolicy>(buffer.data(), spelling) - buffer.data());
+        if (length > names[i].characters.size())
+        {
+            throw std::length_error("Note name does not fit into RenderedName");
+        }
+        std::copy(buffer.data(), buffer.data() + length, names[i].characters.data());
+        names[i].length = length;
+    }
+    return names;
+}();
+
+/**
+ * @brief Returns the pre-rendered name of a spelling, or an empty string_view if it has more than
+ * MAX_RENDERED_ACCIDENTALS accidentals.
+ *
+ * @tparam NamingPolicy - how the name is written
+ * @param spelling - the spelling to name; its base_degree has to be a valid note name root
+ * @return std::string_view
+ */
+template <typename NamingPolicy = DefaultNaming>
+constexpr std::string_view rendered_name(Spelling spelling)
+{
+    if (spelling.accidentals < -MAX_RENDERED_ACCIDENTALS ||
+        spelling.accidentals > MAX_RENDERED_ACCIDENTALS)
+    {
+        return {};
+    }
+    return rendered_names<NamingPolicy>[spelling.base_degree * (2 * MAX_RENDERED_ACCIDENTALS + 1) +
+                                        static_cast<size_t>(spelling.accidentals +
+                                                            MAX_RENDERED_ACCIDENTALS)]
+        .view();
+}
+
+/**
+ * @brief Lazily rendered names of a Note, which any number of threads can read at once.
+ *
+ * The first reader renders the names; readers that arrive while that happens wait on the atomic
+ * state, and every read after that is a single acquire load. Copies take over the names if they
+ * are already rendered. Only reset (i.e. changing the Note) must not race with readers, same as
+ * for any other non-const member function.
+ *
+ * The names are std::pmr strings, so a Note built with an allocator renders its names into the
+ * same memory resource as the rest of it.
+ */
+class NameCache
+{
+   public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+   private:
+    static constexpr std::uint8_t EMPTY = 0;
+    static constexpr std::uint8_t RENDERING = 1;
+    static constexpr std::uint8_t READY = 2;
+
+    mutable std::atomic<std::uint8_t> _state{EMPTY};
+    mutable std::pmr::string _name;
+    mutable std::pmr::string _complex_name;
+
+    /**
+     * @brief Takes over the names of other if it has them rendered.
+     *
+     * @param other - the cache to copy
+     */
+    inline void copy_from(const NameCache& other)
+    {
+        if (other._state.load(std::memory_order_acquire) != READY) return;
+        _name = other._name;
+        _complex_name = other._complex_name;
+        _state.store(READY, std::memory_order_release);
+    }
+
+    /**
+     * @brief Moves the names out of other if it has them rendered, leaving other empty. The
+     * strings are only stolen if both caches use the same memory resource, and copied otherwise.
+     *
+     * @param other - the cache to move from
+     */
+    inline void move_from(NameCache& other)
+    {
+        if (other._state.load(std::memory_order_acquire) != READY) return;
+        _name = std::move(other._name);
+        _complex_name = std::move(other._complex_name);
+        _state.store(READY, std::memory_order_release);
+        other._state.store(EMPTY, std::memory_order_release);
+    }
+
+   public:
+    NameCache() = default;
+
+    inline explicit NameCache(const allocator_type& alloc) : _name(alloc), _complex_name(alloc) {}
+
+    inline NameCache(const NameCache& other) { copy_from(other); }
+
+    inline NameCache(const NameCache& other, const allocator_type& alloc) : NameCache(alloc)
+    {
+        copy_from(other);
+    }
+
+    // Same as for the standard containers, a moved cache keeps the memory resource of the original
+    inline NameCache(NameCache&& other) noexcept : NameCache(other._name.get_allocator())
+    {
+        move_from(other);
+    }
+
+    inline NameCache(NameCache&& other, const allocator_type& alloc) : NameCache(alloc)
+    {
+        move_from(other);
+    }
+
+    inline NameCache& operator=(const NameCache& other)
+    {
+        if (this != &other)
+        {
+            reset();
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    inline NameCache& operator=(NameCache&& other)
+    {
+        if (this != &other)
+        {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Forgets the rendered names, so the next get renders them again.
+     *
+     */
+    inline void reset()
+    {
+        _state.store(EMPTY, std::memory_order_relaxed);
+        _name.clear();
+        _complex_name.clear();
+    }
+
+    /**
+     * @brief Renders the names with render(name, complex_name) unless that already happened, and
+     * returns the cache. If render throws, the cache stays empty and the exception propagates.
+     *
+     * @tparam Render - callable taking two std::pmr::string& to render the names into
+     * @param render - renders the names
+     * @return const NameCache&
+     */
+    template <typename Render>
+    const NameCache& get(Render&& render) const
+    {
+        for (;;)
+        {
+            std::uint8_t state = _state.load(std::memory_order_acquire);
+            if (state == READY) return *this;
+            if (state == RENDERING)
+            {
+                _state.wait(RENDERING, std::memory_order_acquire);
+                continue;
+            }
+            if (_state.compare_exchange_weak(state, RENDERING, std::memory_order_acquire))
+            {
+                try
+                {
+                    render(_name, _complex_name);
+                }
+                catch (...)
+                {
+                    _name.clear();
+                    _complex_name.clear();
+                    _state.store(EMPTY, std::memory_order_release);
+                    _state.notify_all();
+                    throw;
+                }
+                _state.store(READY, std::memory_order_release);
+                _state.notify_all();
+                return *this;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the rendered 'simple' name. Only valid after get.
+     *
+     * @return const std::pmr::string&
+     */
+    inline const std::pmr::string& name() const { return _name; }
+
+    /**
+     * @brief Returns the rendered 'complex' name. Only valid after get.
+     *
+     * @return const std::pmr::string&
+     */
+    inline const std::pmr::string& complex_name() const { return _complex_name; }
+};
+
+// ====FORMATTING====
+// ====NOTE====
+
+template <typename TuningPolicy, typename NamingPolicy>
+class BasicPackedNote;
+
+/**
+ * @brief Class representing a musical note
+ *
+ * The Note contains either MIDI information or name information(s) (or both).
+ * This is because a musical note can either represent a specific pitch (MIDI value 60) or an
+ * 'abstract' concept of a given note (a note C, or C4).
+ * A single Note can have multiple names, due to enharmonics. This is especially important to note
+ * when creating/setting the note using a MIDI value.
+ * This ability to (not) have either piece of information is dealt with by having both of these
+ * pieces of information be std::optional<>, with runtime-checks used to ensure that nothing fails.
+ * This could have been dealt with using inheritance, but it would struggle from expandability
+ * issues, as every possible combination would have to be treated; if we wanted to add timing
+ * information in a more complex library, we would run into issues.
+ *
+ * Much of this approach is somewhat un-C++-ish, but it resembles the way the Python music21 library
+ * operates, which is currently a gold standard for symbolic music manipulation, and so I opted to
+ * loosely follow their ideas.
+ *
+ * Notes are allocator-aware (std::pmr): every constructor takes an optional allocator, which the
+ * names and their rendered strings are allocated with, so containers of Notes can be built in a
+ * single memory resource (e.g. a std::pmr::monotonic_buffer_resource) and freed together.
+ *
+ * Note is the default tuning and naming; every other pair is a BasicNote of its own, with the
+ * lookup tables of its tuning and naming compiled in.
+ *
+ * @tparam TuningPolicy - the Tuning the note is in
+ * @tparam NamingPolicy - how its names are written (e.g. EnglishNaming)
+ */
+template <typename TuningPolicy, typename NamingPolicy>
+class BasicNote
+{
+    static_assert(NamingPolicy::NOTE_NAMES.size() == TuningPolicy::NUMBER_OF_SCALE_DEGREES);
+
+   public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    using tuning_type = TuningPolicy;
+    using naming_type = NamingPolicy;
+    using packed_type = BasicPackedNote<TuningPolicy, NamingPolicy>;
+
+   private:
+    /**
+     * @brief Struct holding information about the note name (i.e. what 'letter' and accidental)
+     *
+     */
+    struct NamingInformation
+    {
+        // _base_degree here is an index to the NamingPolicy::NOTE_NAMES std::array object, and so
+        // uses 0-based indexing
+        scale_degree_value _base_degree;
+        accidentals_value _accidentals;
+
+        inline constexpr NamingInformation(scale_degree_value base_degree,
+                                           accidentals_value accidentals)
+            : _base_degree(base_degree), _accidentals(accidentals)
+        {
+            // Checking for base_degree referencing a note name that does not exist.
+            if (base_degree > TuningPolicy::NUMBER_OF_SCALE_DEGREES - 1)
+            {
+                throw std::invalid_argument(BAD_SCALE_DEGREE_INDEX);
+            }
+        }
+
+        inline constexpr NamingInformation(Spelling spelling)
+            : NamingInformation(spelling.base_degree, spelling.accidentals)
+        {
+        }
+
+        inline constexpr Spelling spelling() const { return {_base_degree, _accidentals}; }
+    };
+
+    /**
+     * @brief Struct holding MIDI information about the note
+     *
+     */
+    struct MIDIInformation
+    {
+        midi_value midi_value_;
+        int octave_;
+
+        // We set octave using some simple arithmetic
+        inline MIDIInformation(midi_value midi_val)
+            : midi_value_(midi_val), octave_(TuningPolicy::octave_of(midi_val))
+        {
+        }
+
+        // Used when manual octave overriding has to occur
+        inline MIDIInformation(midi_value midi_val, int octave)
+            : midi_value_(midi_val), octave_(octave)
+        {
+        }
+    };
+
+    std::optional<MIDIInformation> midi_;
+    // Empty if the note has no name information
+    std::pmr::vector<NamingInformation> names_;
+
+    /**
+     * @brief Parses a given MIDI value and replaces names_ with all possible names for the note
+     *
+     * This only covers enharmonics up to one accidental (F#/Gb, but not Abbb or E##)
+     *
+     * @param midi - the MIDI value that the note should contain
+     */
+    void generate_naming_information_from_midi(midi_value midi);
+
+    // Small helpers for the string parser. These all work over a string_view that gets consumed
+    // from the front, so the parser never has to allocate.
+
+    /**
+     * @brief Removes the longest prefix of characters satisfying pred from input and returns it.
+     */
+    template <typename Pred>
+    static std::string_view consume_while(std::string_view& input, Pred pred)
+    {
+        size_t length = 0;
+        while (length < input.size() && pred(input[length])) ++length;
+        std::string_view consumed = input.substr(0, length);
+        input.remove_prefix(length);
+        return consumed;
+    }
+
+    /**
+     * @brief Removes all leading copies of c from input and returns how many there were.
+     */
+    static size_t consume_repeated(std::string_view& input, char c)
+    {
+        return consume_while(input, [c](char x) { return x == c; }).size();
+    }
+
+    /**
+     * @brief Removes the leading run of characters that can make up an integer (digits, '-' and
+     * '|').
+     */
+    static std::string_view consume_integer(std::string_view& input)
+    {
+        return consume_while(input, [](char c)
+                             { return c == '-' || c == '|' || (c >= '0' && c <= '9'); });
+    }
+
+    /**
+     * @brief Parses the start of digits as an int, throwing std::invalid_argument(error) if there
+     * is no number to parse.
+     */
+    static int parse_integer(std::string_view digits, const char* error)
+    {
+        int value = 0;
+        auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+        if (ec != std::errc{}) throw std::invalid_argument(error);
+        return value;
+    }
+
+    /**
+     * @brief Parses a note name string and generates the NameInformation object (and possible
+     * MIDIInformation)
+     *
+     * The MIDIInformation is only generated if the note is in the form "C{octave within MIDI
+     * range}", and not just "C".
+     *
+     * The string is parsed in a single pass without any allocations. It is expected to be in the
+     * form [note name root][optional b chars][optional # chars][optional octave].
+     *
+     * @param name - string_view of the note name
+     * @return std::tuple<NamingInformation, std::optional<MIDIInformation>>
+     */
+    std::tuple<NamingInformation, std::optional<MIDIInformation>>
+    generate_naming_and_midi_from_string(std::string_view name);
+
+    /**
+     * @brief Generates NameInformation and MIDIInformation (under certain conditions) based off a
+     * scale root, a scale degree, and accidental number.
+     *
+     * NamingInformation only gets generated if scale_root (which we base calculation off) contains
+     * one NameInformation struct. If scale_root has no NameInformation, we do not know what to base
+     * it off of. If scale_root has multiple possible names (i.e. unclarified enharmonic
+     * possibilites), we do not know which way to do pitch spelling.
+     *
+     * MIDIInformation is only generated if scale_root has MIDIInformation we can work from.
+     *
+     * @param scale_root - reference to a Note that represents the scale's root
+     * @param scale_degree - which scale degree should be generated; uses 1-based indexing
+     * @param accidentals - which way and by how much accidentals should be applied (-1 is flat, -2
+     * is double flat, +1 is sharp etc.)
+     * @return std::tuple<std::optional<NamingInformation>, std::optional<MIDIInformation>>
+     */
+    std::tuple<std::optional<NamingInformation>, std::optional<MIDIInformation>>
+    generate_naming_and_midi_from_root_and_scale_degree(const BasicNote& scale_root,
+                                                        scale_degree_value scale_degree,
+                                                        accidentals_value accidentals);
+
+    /**
+     * @brief Writes a single name (note name root and accidentals) to a stream.
+     *
+     * @param stream - output stream reference to write to
+     * @param naming - the NamingInformation to write
+     */
+    static void write_naming_information(std::ostream& stream, const NamingInformation& naming);
+
+    /**
+     * @brief Writes a single name (note name root and accidentals) to an output iterator.
+     *
+     * @tparam OutputIt - output iterator accepting char
+     * @param out - where to write the name
+     * @param naming - the NamingInformation to write
+     * @return OutputIt - iterator past the last written character
+     */
+    template <typename OutputIt>
+    static OutputIt format_naming_information_to(OutputIt out, const NamingInformation& naming)
+    {
+        std::string_view name = rendered_name<NamingPolicy>(naming.spelling());
+        if (!name.empty()) return format_string_to(out, name);
+        return format_spelling_to<NamingPolicy>(out, naming.spelling());
+    }
+
+    /**
+     * @brief Runtime check if Note contains MIDIInformation.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool check_has_midi() const { return midi_.has_value(); }
+
+    /**
+     * @brief Runtime check if Note contains at least one NameInformation.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool check_has_name() const { return !names_.empty(); }
+
+    /**
+     * @brief Cache of the rendered 'simple' and 'complex' names, filled on first access.
+     *
+     */
+    NameCache names_cache_;
+
+    /**
+     * @brief Renders both names for names_cache_. The 'complex' name is left empty unless the note
+     * has both MIDI and name information.
+     *
+     * @param name - where to render the 'simple' name
+     * @param complex_name - where to render the 'complex' name
+     */
+    void render_names(std::pmr::string& name, std::pmr::string& complex_name) const;
+
+    /**
+     * @brief Writes every name, optionally with the octave and MIDI value, as render_names renders
+     * them.
+     *
+     * @tparam OutputIt - output iterator accepting char
+     * @param out - where to write the names
+     * @param with_midi - whether to write the 'complex' names
+     * @return OutputIt - iterator past the last written character
+     */
+    template <typename OutputIt>
+    OutputIt render_names_to(OutputIt out, bool with_midi) const;
+
+   public:
+    // Every constructor may create a note with or without both types of information!
+
+    /**
+     * @brief Construct a new Note object - becomes middle C with both MIDI and name information
+     *
+     */
+    BasicNote();
+
+    /**
+     * @brief Construct a new Note object - becomes middle C with both MIDI and name information
+     *
+     * @param alloc - allocator for the names
+     */
+    explicit BasicNote(const allocator_type& alloc);
+
+    /**
+     * @brief Construct a new Note object that represents a given MIDI value
+     *
+     * Possible names are generated if generate_names is enabled.
+     * Multiple names can be generated due to enharmonics (enharmonics only up to one accidental are
+     * created)
+     *
+     * @param midi - MIDI value of the note
+     * @param generate_names - if false, no NoteInformation is generated; if true, possible
+     * NoteInformation is generated (up to single accidental enharmonics)
+     * @param alloc - allocator for the names
+     */
+    BasicNote(midi_value midi, bool generate_names = true, const allocator_type& alloc = {});
+
+    /**
+     * @brief Construct a new Note object that represents a given MIDI value, with every possible
+     * name (up to single accidental enharmonics)
+     *
+     * @param midi - MIDI value of the note
+     * @param alloc - allocator for the names
+     */
+    inline BasicNote(midi_value midi, const allocator_type& alloc) : BasicNote(midi, true, alloc)
+    {
+    }
+
+    /**
+     * @brief Set the note object to a given MIDI value
+     *
+     * Possible names are generated if generate_names is enabled.
+     * Multiple names can be generated due to enharmonics (enharmonics only up to one accidental are
+     * created)
+     *
+     * @param midi - MIDI value you want to set the Note to
+     * @param generate_names - if false, no NoteInformation is generated; if true, possible
+     * NoteInformation is generated (up to single accidental enharmonics)
+     */
+    void set_note(midi_value midi, bool generate_names = true);
+
+    /**
+     * @brief Construct a new Note object from a string. Will contain name information.
+     *
+     * If a number within the valid octave range is present, then MIDI information is also
+     * generated
+     *
+     * @param name - string reference to the name of the note
+     * @param alloc - allocator for the names
+     */
+    BasicNote(const std::string& name, const allocator_type& alloc = {});
+
+    /**
+     * @brief Construct a new Note object from a string_view. Will contain name information.
+     *
+     * Same as the std::string constructor, but avoids building a temporary std::string.
+     *
+     * @param name - string_view of the name of the note
+     * @param alloc - allocator for the names
+     */
+    BasicNote(std::string_view name, const allocator_type& alloc = {});
+
+    /**
+     * @brief Construct a new Note object from a C string. Will contain name information.
+     *
+     * Only present so that string literals are not ambiguous between the other two overloads.
+     *
+     * @param name - null-terminated name of the note
+     * @param alloc - allocator for the names
+     */
+    inline BasicNote(const char* name, const allocator_type& alloc = {})
+        : BasicNote(std::string_view{name}, alloc)
+    {
+    }
+
+    /**
+     * @brief Set a Note object from a string. Will contain name information.
+     *
+     * If a number within the valid octave range is present, then MIDI information is also
+     * generated
+     *
+     * @param name - string reference to the name of the note
+     */
+    void set_note(const std::string& name);
+
+    /**
+     * @brief Set a Note object from a string_view. Will contain name information.
+     *
+     * @param name - string_view of the name of the note
+     */
+    void set_note(std::string_view name);
+
+    /**
+     * @brief Set a Note object from a C string. Will contain name information.
+     *
+     * @param name - null-terminated name of the note
+     */
+    inline void set_note(const char* name) { set_note(std::string_view{name}); }
+
+    /**
+     * @brief Construct a new Note object representing a specific scale degree based off the scale
+     * root.
+     *
+     * If the scale_root has a MIDI value, then the resulting note will also have a MIDI value.
+     * If the scale_root has a unique name, then the resulting note will also have a unique name.
+     *
+     * @param scale_root - reference to a Note that represents the scale's root
+     * @param scale_degree - which scale degree should be generated; uses 1-based indexing
+     * @param accidentals - which way and by how much accidentals should be applied (-1 is flat, -2
+     * is double flat, +1 is sharp etc.)
+     * @param alloc - allocator for the names
+     */
+    BasicNote(const BasicNote& scale_root, scale_degree_value scale_degree,
+              accidentals_value accidentals, const allocator_type& alloc = {});
+
+    /**
+     * @brief Set a Note object representing a specific scale degree based off the scale
+     * root.
+     *
+     * If the scale_root has a MIDI value, then the resulting note will also have a MIDI value.
+     * If the scale_root has a unique name, then the resulting note will also have a unique name.
+     *
+     * @param scale_root - reference to a Note that represents the scale's root
+     * @param scale_degree - which scale degree should be generated; uses 1-based indexing
+     * @param accidentals - which way and by how much accidentals should be applied (-1 is flat, -2
+     * is double flat, +1 is sharp etc.)
+     */
+    void set_note(const BasicNote& scale_root, scale_degree_value scale_degree,
+                  accidentals_value accidentals);
+
+    /**
+     * @brief Construct a new Note object by unpacking a PackedNote.
+     *
+     * @param packed - reference to the PackedNote to unpack
+     * @param alloc - allocator for the names
+     */
+    explicit BasicNote(const packed_type& packed, const allocator_type& alloc = {});
+
+    // The default copying and moving constructors/assignment operators work just fine; as for the
+    // standard containers, copies use the default memory resource, moves and assignments keep the
+    // one they have.
+    BasicNote(const BasicNote&) = default;
+    BasicNote(BasicNote&&) = default;
+    BasicNote& operator=(const BasicNote&) = default;
+    BasicNote& operator=(BasicNote&&) = default;
+
+    /**
+     * @brief Construct a new Note object copying other, allocating with alloc.
+     *
+     * @param other - reference to the Note to copy
+     * @param alloc - allocator for the names
+     */
+    inline BasicNote(const BasicNote& other, const allocator_type& alloc)
+        : midi_(other.midi_), names_(other.names_, alloc), names_cache_(other.names_cache_, alloc)
+    {
+    }
+
+    /**
+     * @brief Construct a new Note object moving other, allocating with alloc. Nothing is copied if
+     * other uses the same memory resource.
+     *
+     * @param other - reference to the Note to move
+     * @param alloc - allocator for the names
+     */
+    inline BasicNote(BasicNote&& other, const allocator_type& alloc)
+        : midi_(other.midi_),
+          names_(std::move(other.names_), alloc),
+          names_cache_(std::move(other.names_cache_), alloc)
+    {
+    }
+
+    /**
+     * @brief Returns the allocator the names are allocated with.
+     *
+     * @return allocator_type
+     */
+    inline allocator_type get_allocator() const { return names_.get_allocator(); }
+
+    /**
+     * @brief Get the MIDI value of the MIDIInformation
+     *
+     * Throws an std::runtime_error exception if no MIDIInformation is present.
+     *
+     * @return midi_value
+     */
+    inline midi_value get_midi() const
+    {
+        if (midi_.has_value())
+            return midi_.value().midi_value_;
+        else
+            throw std::runtime_error(NO_MIDI_INFORMATION);
+    }
+
+    /**
+     * @brief Get the 'simple' (no MIDI information) name as a string. The name is rendered on the
+     * first call (from any thread) and is only looked up afterwards.
+     *
+     * Throws an std::runtime_error exception if no name is present.
+     *
+     * @return const std::pmr::string&
+     */
+    inline const std::pmr::string& get_name() const
+    {
+        if (!check_has_name()) throw std::runtime_error(NO_NAME_INFORMATION);
+        return names_cache_.get([this](std::pmr::string& name, std::pmr::string& complex_name)
+                                { render_names(name, complex_name); })
+            .name();
+    }
+
+    /**
+     * @brief Get the 'complex' (name and MIDI information) name as a string. The name is rendered
+     * on the first call (from any thread) and is only looked up afterwards.
+     *
+     * Throws an std::runtime_error exception if either is missing.
+     *
+     * @return const std::pmr::string&
+     */
+    inline const std::pmr::string& get_name_and_midi_string() const
+    {
+        if (!check_has_midi() || !check_has_name()) throw std::runtime_error(NOT_BOTH_INFORMATION);
+        return names_cache_.get([this](std::pmr::string& name, std::pmr::string& complex_name)
+                                { render_names(name, complex_name); })
+            .complex_name();
+    }
+
+    /**
+     * @brief Writes the 'simple' (no MIDI information) name to an output iterator, without
+     * allocating. Throws an std::runtime_error exception if no name is present.
+     *
+     * @tparam OutputIt - output iterator accepting char
+     * @param out - where to write the name
+     * @return OutputIt - iterator past the last written character
+     */
+    template <typename OutputIt>
+    OutputIt format_name_to(OutputIt out) const
+    {
+        // Straight from the pre-rendered names; only get_name goes through the cache
+        if (!check_has_name()) throw std::runtime_error(NO_NAME_INFORMATION);
+        return render_names_to(out, false);
+    }
+
+    /**
+     * @brief Writes the 'complex' (name and MIDI information) name to an output iterator, without
+     * allocating. Throws an std::runtime_error exception if either is missing.
+     *
+     * @tparam OutputIt - output iterator accepting char
+     * @param out - where to write the name
+     * @return OutputIt - iterator past the last written character
+     */
+    template <typename OutputIt>
+    OutputIt format_name_and_midi_to(OutputIt out) const
+    {
+        if (!check_has_midi() || !check_has_name()) throw std::runtime_error(NOT_BOTH_INFORMATION);
+        return render_names_to(out, true);
+    }
+
+    /**
+     * @brief Writes the same as the << operator to an output iterator, without allocating.
+     *
+     * @tparam OutputIt - output iterator accepting char
+     * @param out - where to write the note
+     * @return OutputIt - iterator past the last written character
+     */
+    template <typename OutputIt>
+    OutputIt format_to(OutputIt out) const
+    {
+        if (check_has_midi() && check_has_name()) return format_name_and_midi_to(out);
+        if (check_has_midi()) return format_integer_to(out, midi_.value().midi_value_);
+        return format_name_to(out);
+    }
+
+    /**
+     * @brief Destroy the Note object
+     *
+     */
+    ~BasicNote() = default;
+
+    /**
+     * @brief Printing to stream operator.
+     *
+     * Tries to print the 'complex' name if possible, otherwise prints what is possible to print.
+     *
+     * @param stream - output stream reference to write out
+     * @param note - reference to Note to be printed
+     * @return std::ostream&
+     */
+    friend std::ostream& operator<<(std::ostream& stream, const BasicNote& note)
+    {
+        note.format_to(std::ostreambuf_iterator<char>{stream});
+        return stream;
+    }
+
+    friend packed_type;
+};
+
+// Default constructor default to Middle C
+template <typename TuningPolicy, typename NamingPolicy>
+BasicNote<TuningPolicy, NamingPolicy>::BasicNote() : BasicNote(allocator_type{})
+{
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+BasicNote<TuningPolicy, NamingPolicy>::BasicNote(const allocator_type& alloc)
+    : midi_(TuningPolicy::MIDDLE_C), names_({NamingInformation{0, 0}}, alloc), names_cache_(alloc)
+{
+}
+
+// For any MIDI value that requires an accidental, both variants are generated
+template <typename TuningPolicy, typename NamingPolicy>
+void BasicNote<TuningPolicy, NamingPolicy>::generate_naming_information_from_midi(midi_value midi)
+{
+    // Filled in place, so the names stay in the note's memory resource
+    names_.clear();
+    for (auto&& spelling : TuningPolicy::spellings_of(midi))
+    {
+        names_.emplace_back(spelling);
+    }
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+BasicNote<TuningPolicy, NamingPolicy>::BasicNote(midi_value midi, bool generate_names,
+                                                 const allocator_type& alloc)
+    : midi_({midi}), names_(alloc), names_cache_(alloc)
+{
+    if (generate_names)
+    {
+        generate_naming_information_from_midi(midi);
+    }
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+void BasicNote<TuningPolicy, NamingPolicy>::set_note(midi_value midi, bool generate_names)
+{
+    midi_ = {midi};
+    names_.clear();
+    if (generate_names)
+    {
+        generate_naming_information_from_midi(midi);
+    }
+    names_cache_.reset();
+}
+
+// Expects name to be in the form [Base Note Name][optional multiple # or b chars][optional number
+// for octave]
+template <typename TuningPolicy, typename NamingPolicy>
+auto BasicNote<TuningPolicy, NamingPolicy>::generate_naming_and_midi_from_string(
+    std::string_view name) -> std::tuple<NamingInformation, std::optional<MIDIInformation>>
+{
+    size_t note_name_roots_index = 0;
+    accidentals_value accidentals = 0;
+    int octave = 0;
+    bool octave_found = false;
+
+    // The note name root is a run of letters; a lowercase 'b' always starts the flats
+    std::string_view root = consume_while(
+        name, [](char c) { return c != 'b' && (std::isalpha(static_cast<unsigned char>(c)) ||
+                                               c == '|'); });
+    const auto& note_names = NamingPolicy::NOTE_NAMES;
+    auto it = std::find(note_names.begin(), note_names.end(), root);
+    if (it != note_names.end())
+    {
+        note_name_roots_index = static_cast<size_t>(std::distance(note_names.begin(), it));
+    }
+    else
+    {
+        // Special names (e.g. B for H flat in German) start off with their accidentals
+        const auto& special_names = NamingPolicy::SPECIAL_NAMES;
+        auto special = std::find_if(special_names.begin(), special_names.end(),
+                                    [root](const SpecialName& s) { return s._name == root; });
+        if (special == special_names.end()) throw std::invalid_argument(INVALID_NOTE_NAME_FOUND);
+        note_name_roots_index = special->_spelling.base_degree;
+        accidentals = special->_spelling.accidentals;
+    }
+
+    accidentals -= static_cast<accidentals_value>(consume_repeated(name, 'b'));
+
+    size_t sharps = consume_repeated(name, '#');
+    if (sharps > 0)
+    {
+        if (accidentals < 0) throw std::invalid_argument(BOTH_ACCIDENTALS_FOUND);
+        accidentals += static_cast<accidentals_value>(sharps);
+    }
+
+    std::string_view octave_string = consume_integer(name);
+    if (octave_string.size() > 0)
+    {
+        octave = parse_integer(octave_string, INVALID_NOTE_NAME_FOUND);
+        octave_found = true;
+    }
+
+    NamingInformation ni(note_name_roots_index, accidentals);
+    std::optional<MIDIInformation> mi;
+    if (octave_found)
+    {
+        // MIDI arithmetic
+        midi_value midi_offset_from_scale_c = TuningPolicy::NATURAL_STEPS[note_name_roots_index];
+        midi_value midi = TuningPolicy::MIDDLE_C +
+                          ((octave - MIDDLE_C_OCTAVE) * TuningPolicy::STEPS_PER_OCTAVE) +
+                          midi_offset_from_scale_c + accidentals * TuningPolicy::SHARP;
+        mi = MIDIInformation{midi, octave};
+    }
+
+    return std::tuple<NamingInformation, std::optional<MIDIInformation>>{ni, mi};
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+BasicNote<TuningPolicy, NamingPolicy>::BasicNote(const std::string& name,
+                                                 const allocator_type& alloc)
+    : BasicNote(std::string_view{name}, alloc)
+{
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+BasicNote<TuningPolicy, NamingPolicy>::BasicNote(std::string_view name,
+                                                 const allocator_type& alloc)
+    : names_(alloc), names_cache_(alloc)
+{
+    // Oooooooh, fancy structured binding, look at this fancy C++ concept
+    auto [naming, midi] = generate_naming_and_midi_from_string(name);
+    names_.assign({naming});
+    midi_ = midi;
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+void BasicNote<TuningPolicy, NamingPolicy>::set_note(const std::string& name)
+{
+    set_note(std::string_view{name});
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+void BasicNote<TuningPolicy, NamingPolicy>::set_note(std::string_view name)
+{
+    auto [naming, midi] = generate_naming_and_midi_from_string(name);
+    names_.assign({naming});
+    midi_ = midi;
+    names_cache_.reset();
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+auto BasicNote<TuningPolicy, NamingPolicy>::generate_naming_and_midi_from_root_and_scale_degree(
+    const BasicNote& scale_root, scale_degree_value scale_degree, accidentals_value accidentals)
+    -> std::tuple<std::optional<NamingInformation>, std::optional<MIDIInformation>>
+{
+    // Second scale degree corresponds to index one due to different indexing
+    if (scale_degree == 0)
+    {
+        throw std::invalid_argument(INDEX_BASE_ERROR);
+    }
+
+    scale_degree -= 1;
 
-#if defined(FRENCH_NAMING)
-constexpr char downward_accidental[] = " bemol";
-constexpr char upward_accidental[] = " diese";
-#endif
+    std::optional<NamingInformation> namei;
+    std::optional<MIDIInformation> midii;
+
+    // We have to do some pretty gnarly if branching here due to the different outcomes based on
+    // what scale_root looks like.
+
+    if (scale_root.midi_.has_value())
+    {
+        midii = {scale_root.midi_.value().midi_value_ +
+                 TuningPolicy::scale_degree_offset(scale_degree) +
+                 accidentals * TuningPolicy::SHARP};
+    }
+
+    if (scale_root.names_.size() == 1)
+    {
+        namei = TuningPolicy::spell_scale_degree(scale_root.names_[0].spelling(), scale_degree,
+                                                 accidentals);
+    }
+
+    if (!scale_root.midi_.has_value() && scale_root.names_.size() > 1)
+    {
+        throw std::invalid_argument(CREATION_NOT_BOTH_INFORMATION);
+    }
+
+    return std::tuple{namei, midii};
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+BasicNote<TuningPolicy, NamingPolicy>::BasicNote(const BasicNote& scale_root,
+                                                 scale_degree_value scale_degree,
+                                                 accidentals_value accidentals,
+                                                 const allocator_type& alloc)
+    : names_(alloc), names_cache_(alloc)
+{
+    auto [naming, midi] =
+        generate_naming_and_midi_from_root_and_scale_degree(scale_root, scale_degree, accidentals);
+    midi_ = midi;
+    if (naming.has_value()) names_.assign({naming.value()});
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+void BasicNote<TuningPolicy, NamingPolicy>::set_note(const BasicNote& scale_root,
+                                                     scale_degree_value scale_degree,
+                                                     accidentals_value accidentals)
+{
+    auto [naming, midi] =
+        generate_naming_and_midi_from_root_and_scale_degree(scale_root, scale_degree, accidentals);
+    midi_ = midi;
+    names_.clear();
+    if (naming.has_value()) names_.assign({naming.value()});
+    names_cache_.reset();
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+BasicNote<TuningPolicy, NamingPolicy>::BasicNote(const packed_type& packed,
+                                                 const allocator_type& alloc)
+    : names_(alloc), names_cache_(alloc)
+{
+    if (packed.has_midi()) midi_ = MIDIInformation{packed._midi, packed._octave};
+    if (packed.has_name())
+    {
+        NamingInformation naming{packed._base_degree, packed._accidentals};
+        names_.reserve(packed.has_enharmonic() ? 2 : 1);
+        names_.push_back(naming);
+        if (packed.has_enharmonic())
+        {
+            names_.emplace_back(TuningPolicy::next_enharmonic(naming.spelling()));
+        }
+    }
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+void BasicNote<TuningPolicy, NamingPolicy>::write_naming_information(
+    std::ostream& stream, const NamingInformation& naming_info)
+{
+    format_naming_information_to(std::ostreambuf_iterator<char>{stream}, naming_info);
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+template <typename OutputIt>
+OutputIt BasicNote<TuningPolicy, NamingPolicy>::render_names_to(OutputIt out, bool with_midi) const
+{
+    bool first = true;
+    for (auto&& naming : names_)
+    {
+        if (!first) *out++ = NOTE_PRINT_SEPERATOR;
+        first = false;
+        out = format_naming_information_to(out, naming);
+        if (with_midi)
+        {
+            out = format_integer_to(out, midi_.value().octave_);
+            out = format_string_to(out, " (");
+            out = format_integer_to(out, midi_.value().midi_value_);
+            *out++ = ')';
+        }
+    }
+    return out;
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+void BasicNote<TuningPolicy, NamingPolicy>::render_names(std::pmr::string& name,
+                                                         std::pmr::string& complex_name) const
+{
+    if (!check_has_name()) return;
+
+    // Notes have at most two names, so unless a name has more accidentals than the pre-rendered
+    // table, everything fits into a small buffer and each string gets assigned in one go
+    bool all_pre_rendered =
+        names_.size() <= 2 &&
+        std::all_of(names_.begin(), names_.end(),
+                    [](const NamingInformation& naming)
+                    { return !rendered_name<NamingPolicy>(naming.spelling()).empty(); });
+    if (all_pre_rendered)
+    {
+        std::array<char, 128> buffer;
+        name.assign(buffer.data(), render_names_to(buffer.data(), false));
+        if (check_has_midi())
+        {
+            complex_name.assign(buffer.data(), render_names_to(buffer.data(), true));
+        }
+        return;
+    }
+
+    render_names_to(std::back_inserter(name), false);
+    if (check_has_midi()) render_names_to(std::back_inserter(complex_name), true);
+}
+
+/**
+ * @brief A Note in the default tuning and naming.
+ *
+ */
+using Note = BasicNote<DefaultTuning, DefaultNaming>;
+
+// Instantiated once, in musiclibrary.cpp
+extern template class BasicNote<DefaultTuning, DefaultNaming>;
 
 // ====NOTE====
+// ====PACKEDNOTE====
 
 /**
- * @brief Class representing a musical note
+ * @brief Compact, trivially copyable representation of a Note.
  *
- * The Note contains either MIDI information or name information(s) (or both).
- * This is because a musical note can either represent a specific pitch (MIDI value 60) or an
- * 'abstract' concept of a given note (a note C, or C4).
- * A single Note can have multiple names, due to enharmonics. This is especially important to note
- * when creating/setting the note using a MIDI value.
- * This ability to (not) have either piece of information is dealt with by having both of these
- * pieces of information be std::optional<>, with runtime-checks used to ensure that nothing fails.
- * This could have been dealt with using inheritance, but it would struggle from expandability
- * issues, as every possible combination would have to be treated; if we wanted to add timing
- * information in a more complex library, we would run into issues.
+ * A Note carries optionals, a vector of names and cached strings, which is a lot of weight for what
+ * is conceptually a handful of small integers. PackedNote stores the MIDI value, octave, a single
+ * spelling and a flag for whether the spelling's enharmonic (e.g. Db for C#) is also a valid name.
+ * This covers every Note this library generates, as notes generated from MIDI have at most those
+ * two names.
  *
- * Much of this approach is somewhat un-C++-ish, but it resembles the way the Python music21 library
- * operates, which is currently a gold standard for symbolic music manipulation, and so I opted to
- * loosely follow their ideas.
+ * Conversions to and from Note are explicit, as packing a Note can fail. Same as for Note,
+ * PackedNote is the default tuning and naming, and BasicPackedNote any other pair.
+ *
+ * @tparam TuningPolicy - the Tuning the note is in
+ * @tparam NamingPolicy - how its names are written (e.g. EnglishNaming)
  */
-class Note
+template <typename TuningPolicy, typename NamingPolicy>
+class BasicPackedNote
 {
+    // The note name root has to fit into _base_degree
+    static_assert(TuningPolicy::NUMBER_OF_SCALE_DEGREES <= 8);
+
+   public:
+    using tuning_type = TuningPolicy;
+    using naming_type = NamingPolicy;
+    using note_type = BasicNote<TuningPolicy, NamingPolicy>;
+
    private:
-    // Setting note names style
-#ifdef ENGLISH_NAMING
-    inline static const std::array<std::string, NUMBER_OF_SCALE_DEGREES> note_names = {
-        "C", "D", "E", "F", "G", "A", "B"};
-#endif
+    std::int16_t _midi = 0;
+    std::int8_t _octave = 0;
+    std::int8_t _accidentals = 0;
+    std::uint8_t _base_degree : 3 = 0;
+    std::uint8_t _has_midi : 1 = 0;
+    std::uint8_t _has_name : 1 = 0;
+    std::uint8_t _has_enharmonic : 1 = 0;
+
+    /**
+     * @brief Converts value to the (smaller) packed field type T, throwing if it does not fit.
+     *
+     * @tparam T - type of the packed field
+     * @param value - the value to narrow
+     * @return T
+     */
+    template <typename T>
+    static constexpr T narrow(int value)
+    {
+        if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max())
+        {
+            throw std::invalid_argument(CANNOT_PACK_NOTE);
+        }
+        return static_cast<T>(value);
+    }
+
+    /**
+     * @brief Sets the MIDI value and the octave derived from it.
+     *
+     * @param midi - the MIDI value
+     */
+    inline constexpr void set_midi(midi_value midi)
+    {
+        _midi = narrow<std::int16_t>(midi);
+        _octave = narrow<std::int8_t>(TuningPolicy::octave_of(midi));
+        _has_midi = true;
+    }
+
+    /**
+     * @brief Sets the stored spelling.
+     *
+     * @param spelling - the note name root and accidentals
+     */
+    inline constexpr void set_spelling(Spelling spelling)
+    {
+        _base_degree = static_cast<std::uint8_t>(spelling.base_degree);
+        _accidentals = narrow<std::int8_t>(spelling.accidentals);
+        _has_name = true;
+    }
+
+   public:
+    /**
+     * @brief Construct a new PackedNote object with no MIDI or name information.
+     *
+     */
+    constexpr BasicPackedNote() = default;
+
+    /**
+     * @brief Construct a new PackedNote object by packing a Note.
+     *
+     * Throws std::invalid_argument if the Note has names that are not a spelling and its
+     * enharmonic, or if its values do not fit.
+     *
+     * @param note - reference to the Note to pack
+     */
+    explicit BasicPackedNote(const note_type& note);
+
+    /**
+     * @brief Construct a new PackedNote object with only name information.
+     *
+     * @param spelling - the note name root and accidentals
+     */
+    inline constexpr BasicPackedNote(Spelling spelling) { set_spelling(spelling); }
+
+    /**
+     * @brief Construct a new PackedNote object with both name and MIDI information.
+     *
+     * @param spelling - the note name root and accidentals
+     * @param midi - the MIDI value; the octave is derived from it
+     */
+    inline constexpr BasicPackedNote(Spelling spelling, midi_value midi) : BasicPackedNote(spelling)
+    {
+        set_midi(midi);
+    }
+
+    /**
+     * @brief Construct a new PackedNote object representing a specific scale degree based off the
+     * scale root.
+     *
+     * Follows the same rules as the equivalent Note constructor, without any allocation, and can be
+     * evaluated at compile time.
+     *
+     * @param scale_root - the PackedNote that represents the scale's root
+     * @param scale_degree - which scale degree should be generated; uses 1-based indexing
+     * @param accidentals - which way and by how much accidentals should be applied (-1 is flat, -2
+     * is double flat, +1 is sharp etc.)
+     */
+    inline constexpr BasicPackedNote(BasicPackedNote scale_root, scale_degree_value scale_degree,
+                                     accidentals_value accidentals)
+    {
+        if (scale_degree == 0)
+        {
+            throw std::invalid_argument(INDEX_BASE_ERROR);
+        }
+
+        scale_degree -= 1;
+
+        if (scale_root.has_midi())
+        {
+            set_midi(scale_root._midi + TuningPolicy::scale_degree_offset(scale_degree) +
+                     accidentals * TuningPolicy::SHARP);
+        }
+
+        if (scale_root.has_name() && !scale_root.has_enharmonic())
+        {
+            set_spelling(TuningPolicy::spell_scale_degree(
+                {scale_root._base_degree, scale_root._accidentals}, scale_degree, accidentals));
+        }
+
+        if (!scale_root.has_midi() && scale_root.has_name() && scale_root.has_enharmonic())
+        {
+            throw std::invalid_argument(CREATION_NOT_BOTH_INFORMATION);
+        }
+    }
+
+    /**
+     * @brief Runtime check if the PackedNote contains a MIDI value.
+     *
+     * @return true
+     * @return false
+     */
+    inline constexpr bool has_midi() const { return _has_midi; }
+
+    /**
+     * @brief Runtime check if the PackedNote contains a name.
+     *
+     * @return true
+     * @return false
+     */
+    inline constexpr bool has_name() const { return _has_name; }
+
+    /**
+     * @brief Runtime check if the enharmonic of the stored spelling is also a name of this note.
+     *
+     * @return true
+     * @return false
+     */
+    inline constexpr bool has_enharmonic() const { return _has_enharmonic; }
+
+    /**
+     * @brief Get the MIDI value. Throws an std::runtime_error exception if none is present.
+     *
+     * @return midi_value
+     */
+    inline constexpr midi_value get_midi() const
+    {
+        if (!_has_midi) throw std::runtime_error(NO_MIDI_INFORMATION);
+        return _midi;
+    }
+
+    /**
+     * @brief Get the octave. Only meaningful if the PackedNote has a MIDI value.
+     *
+     * @return int
+     */
+    inline constexpr int get_octave() const { return _octave; }
+
+    /**
+     * @brief Get the index of the note name root of the stored spelling (0-based).
+     *
+     * @return scale_degree_value
+     */
+    inline constexpr scale_degree_value get_base_degree() const { return _base_degree; }
+
+    /**
+     * @brief Get the accidentals of the stored spelling.
+     *
+     * @return accidentals_value
+     */
+    inline constexpr accidentals_value get_accidentals() const { return _accidentals; }
+
+    /**
+     * @brief Unpacks into a full Note.
+     *
+     * @return note_type
+     */
+    inline note_type to_note() const { return note_type{*this}; }
+
+    /**
+     * @brief Writes the 'simple' (no MIDI information) name to a stream, same as Note::get_name.
+     *
+     * Throws an std::runtime_error exception if no name is present.
+     *
+     * @param stream - output stream reference to write to
+     */
+    void write_name(std::ostream& stream) const;
+
+    /**
+     * @brief Writes the 'simple' (no MIDI information) name to an output iterator, without
+     * allocating. Same as write_name otherwise.
+     *
+     * @tparam OutputIt - output iterator accepting char
+     * @param out - where to write the name
+     * @return OutputIt - iterator past the last written character
+     */
+    template <typename OutputIt>
+    OutputIt format_name_to(OutputIt out) const
+    {
+        if (!has_name()) throw std::runtime_error(NO_NAME_INFORMATION);
+        typename note_type::NamingInformation naming{_base_degree, _accidentals};
+        out = note_type::format_naming_information_to(out, naming);
+        if (has_enharmonic())
+        {
+            *out++ = NOTE_PRINT_SEPERATOR;
+            out = note_type::format_naming_information_to(
+                out, TuningPolicy::next_enharmonic(naming.spelling()));
+        }
+        return out;
+    }
+
+    /**
+     * @brief Writes the same as the << operator to an output iterator, without allocating (or
+     * unpacking into a Note).
+     *
+     * @tparam OutputIt - output iterator accepting char
+     * @param out - where to write the note
+     * @return OutputIt - iterator past the last written character
+     */
+    template <typename OutputIt>
+    OutputIt format_to(OutputIt out) const
+    {
+        if (!has_name())
+        {
+            if (!has_midi()) throw std::runtime_error(NO_NAME_INFORMATION);
+            return format_integer_to(out, _midi);
+        }
+        if (!has_midi()) return format_name_to(out);
+
+        typename note_type::NamingInformation naming{_base_degree, _accidentals};
+        for (int i = 0; i < (has_enharmonic() ? 2 : 1); ++i)
+        {
+            if (i > 0)
+            {
+                *out++ = NOTE_PRINT_SEPERATOR;
+                naming = TuningPolicy::next_enharmonic(naming.spelling());
+            }
+            out = note_type::format_naming_information_to(out, naming);
+            out = format_integer_to(out, _octave);
+            out = format_string_to(out, " (");
+            out = format_integer_to(out, _midi);
+            *out++ = ')';
+        }
+        return out;
+    }
+
+    /**
+     * @brief Compares all the packed fields.
+     *
+     */
+    friend constexpr bool operator==(const BasicPackedNote&, const BasicPackedNote&) = default;
+
+    /**
+     * @brief Printing to stream operator. Prints the same as the equivalent Note.
+     *
+     * @param stream - output stream reference to write out
+     * @param note - the PackedNote to be printed
+     * @return std::ostream&
+     */
+    friend std::ostream& operator<<(std::ostream& stream, const BasicPackedNote& note)
+    {
+        note.format_to(std::ostreambuf_iterator<char>{stream});
+        return stream;
+    }
+
+    friend note_type;
+};
+
+template <typename TuningPolicy, typename NamingPolicy>
+BasicPackedNote<TuningPolicy, NamingPolicy>::BasicPackedNote(const note_type& note)
+{
+    if (note.check_has_midi())
+    {
+        // The octave is copied rather than derived, as Notes parsed from strings can override it
+        _midi = narrow<std::int16_t>(note.midi_.value().midi_value_);
+        _octave = narrow<std::int8_t>(note.midi_.value().octave_);
+        _has_midi = true;
+    }
+
+    if (note.check_has_name())
+    {
+        auto& names = note.names_;
+        if (names.size() > 2) throw std::invalid_argument(CANNOT_PACK_NOTE);
+        if (names.size() == 2)
+        {
+            if (names[1].spelling() != TuningPolicy::next_enharmonic(names[0].spelling()))
+            {
+                throw std::invalid_argument(CANNOT_PACK_NOTE);
+            }
+            _has_enharmonic = true;
+        }
+        set_spelling(names[0].spelling());
+    }
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+void BasicPackedNote<TuningPolicy, NamingPolicy>::write_name(std::ostream& stream) const
+{
+    format_name_to(std::ostreambuf_iterator<char>{stream});
+}
+
+/**
+ * @brief A PackedNote in the default tuning and naming.
+ *
+ */
+using PackedNote = BasicPackedNote<DefaultTuning, DefaultNaming>;
+
+extern template class BasicPackedNote<DefaultTuning, DefaultNaming>;
+
+static_assert(std::is_trivially_copyable_v<PackedNote>);
+static_assert(sizeof(PackedNote) <= 8);
+
+// ====PACKEDNOTE====
+// ====SCALE====
+
+/**
+ * @brief Class representing an 'abstract' musical scale.alignas
+ *
+ * Supports scales that go past an octave (i.e. 9ths and onwards).
+ * This represents the idea of a scale (e.g. 'Major'); for a specific scale (e.g. 'C Major'), see
+ * RealisedScale.
+ *
+ * Made to work as a wrapper over a vector and tries to forward as much as possible from the vector
+ * such as iterators etc. More could be added here, but this is sufficient for now.
+ *
+ * Scale is the default tuning and naming, same as for Note; the scale degrees themselves mean the
+ * same in every tuning, only how they are realised and printed differs.
+ *
+ * @tparam TuningPolicy - the Tuning the scale is realised in
+ * @tparam NamingPolicy - how its accidentals are written (e.g. EnglishNaming)
+ */
+template <typename TuningPolicy, typename NamingPolicy>
+class BasicScale
+{
+   public:
+    // Type aliasing
+    using scale_degree = std::pair<scale_degree_value, accidentals_value>;
+
+   private:
+    /**
+     * @brief The underlying std::vector container used to store the scale degrees.
+     *
+     */
+    std::vector<scale_degree> _scale_degrees;
+
+    /**
+     * @brief Parsing method for turning a scale degree string (e.g. 'b3' or '#6') into a
+     * scale_degree.
+     *
+     * Parsed in a single pass without any allocations, and constexpr so that StaticScale can parse
+     * at compile time with the very same rules.
+     *
+     * @param input - string_view of the scale degree to parse
+     * @return scale_degree
+     */
+    static constexpr scale_degree parse_scale_degree_string(std::string_view input)
+    {
+        size_t flats = 0;
+        while (flats < input.size() && input[flats] == 'b') ++flats;
+        input.remove_prefix(flats);
 
-#ifdef GERMAN_NAMING
-    inline static const std::array<std::string, NUMBER_OF_SCALE_DEGREES> note_names = {
-        "C", "D", "E", "F", "G", "A", "H"};
-#endif
+        size_t sharps = 0;
+        while (sharps < input.size() && input[sharps] == '#') ++sharps;
+        input.remove_prefix(sharps);
 
-#ifdef FRENCH_NAMING
-    inline static const std::array<std::string, NUMBER_OF_SCALE_DEGREES> note_names = {
-        "Do", "Re", "Mi", "Fa", "Sol", "La", "Si"};
-#endif
+        if (flats > 0 && sharps > 0)
+        {
+            throw std::invalid_argument(BOTH_ACCIDENTALS_FOUND);
+        }
+        accidentals_value accidentals = sharps > 0 ? static_cast<accidentals_value>(sharps)
+                                                   : -static_cast<accidentals_value>(flats);
+
+        // Same as std::from_chars into an int (which is not constexpr until C++23): an optional
+        // minus sign and at least one digit, stopping at the first character that is not a digit
+        bool negative = !input.empty() && input[0] == '-';
+        size_t digit = negative ? 1 : 0;
+        auto is_digit = [&input](size_t i) { return input[i] >= '0' && input[i] <= '9'; };
+        if (digit >= input.size() || !is_digit(digit))
+        {
+            throw std::invalid_argument(NO_SCALE_DEGREE);
+        }
+
+        long long value = 0;
+        long long limit = static_cast<long long>(std::numeric_limits<int>::max()) + negative;
+        for (; digit < input.size() && is_digit(digit); ++digit)
+        {
+            value = value * 10 + (input[digit] - '0');
+            if (value > limit) throw std::invalid_argument(NO_SCALE_DEGREE);
+        }
+
+        int sd = static_cast<int>(negative ? -value : value);
+        return {static_cast<scale_degree_value>(sd), accidentals};
+    }
 
-    // The following are for internal use only, so use 0-based indexing
-    // We need both, as I need both directions indexed for different purposes
+    template <size_t N>
+    friend class StaticScale;
 
+   public:
     /**
-     * @brief Mapping from a given MIDI offset from the scale root to what scale degree (and
-     * accidentals) a note is
+     * @brief Construct a new empty Scale object
      *
      */
-    inline static const std::multimap<midi_value, std::tuple<midi_value, accidentals_value>>
-        scale_midi_offset_to_scale_degree_and_accidental{
-            {0, {0, 0}}, {1, {0, 1}},  {1, {1, -1}}, {2, {1, 0}},  {3, {1, 1}},   {3, {2, -1}},
-            {4, {2, 0}}, {5, {3, 0}},  {6, {3, 1}},  {6, {4, -1}}, {7, {4, 0}},  // Perfect fifth
-            {8, {4, 1}}, {8, {5, -1}}, {9, {5, 0}},  {10, {5, 1}}, {10, {6, -1}}, {11, {6, 0}}};
+    BasicScale() = default;
 
     /**
-     * @brief Mapping from a given scale degree (without accidentals) to the MIDI offset from the
-     * scale root
+     * @brief Construct a new Scale object from an input stream using the >> operator.
      *
+     * @param stream - input stream reference to read the scale from
      */
-    inline static const std::map<scale_degree_value, midi_value> scale_degree_to_midi_diff{
-        {0, 0}, {1, 2}, {2, 4}, {3, 5}, {4, 7}, {5, 9}, {6, 11}};
+    inline BasicScale(std::istream& stream) { stream >> *this; }
 
     /**
-     * @brief Regex pattern for parsing a Note string (e.g. 'Db5')
+     * @brief Construct a new Scale object from a string of scale degrees (e.g. '1,2,b3').
      *
+     * @param input - string_view from which to read the scale
      */
-    inline static const char note_name_regex_pattern[] = "([a|c-zA-Z]*)(b*)(#*)([\\-|\\d]*)";
-    inline static const std::regex note_name_regex{note_name_regex_pattern};
+    inline BasicScale(std::string_view input) { input >> *this; }
 
     /**
-     * @brief Struct holding information about the note name (i.e. what 'letter' and accidental)
+     * @brief Construct a new Scale object by copying an existing std::vector<scale_degree>
      *
+     * @param degrees - reference to vector of scale_degree (std::pair of scale_degree_value and accidentals_value) to copy
      */
-    struct NamingInformation
-    {
-        // _base_degree here is an index to the note_names std::arrat object, and so uses 0-based
-        // indexing
-        scale_degree_value _base_degree;
-        accidentals_value _accidentals;
+    inline BasicScale(const std::vector<scale_degree>& degrees) : _scale_degrees(degrees) {};
 
-        NamingInformation(scale_degree_value base_degree, accidentals_value accidentals);
-    };
+    /**
+     * @brief Construct a new Scale object by stealing an existing std::vector<scale_degree>
+     *
+     * @param degrees vector of scale_degree (std::pair of scale_degree_value and accidentals_value)
+     * to move
+     */
+    inline BasicScale(std::vector<scale_degree>&& degrees) noexcept
+        : _scale_degrees(std::move(degrees)) {};
+
+    // The default copying and moving constructors/assignment operators work just fine.
 
     /**
-     * @brief Struct holding MIDI information about the note
+     * @brief Operator for parsing a csv input stream into a scale object.
      *
+     * @param stream - input stream reference from which to read the scale
+     * @param scale - reference to Scale into which to parse the input
+     * @return std::istream&
      */
-    struct MIDIInformation
+    friend std::istream& operator>>(std::istream& stream, BasicScale& scale)
     {
-        midi_value midi_value_;
-        int octave_;
+        std::string scale_degree_str;
 
-        MIDIInformation(midi_value midi_val);
+        scale.clear();
 
-        // Used when manual octave overriding has to occur
-        inline MIDIInformation(midi_value midi_val, int octave)
-            : midi_value_(midi_val), octave_(octave)
+        while (std::getline(stream, scale_degree_str, SCALE_DEGREE_SEPERATOR))
         {
+            scale._scale_degrees.emplace_back(parse_scale_degree_string(scale_degree_str));
         }
-    };
 
-    std::optional<MIDIInformation> midi_;
-    std::optional<std::vector<NamingInformation>> names_;
+        return stream;
+    }
 
     /**
-     * @brief Parses a given MIDI value and generates all possible names for the note
+     * @brief Operator for parsing a string of scale degrees into a scale object.
      *
-     * This only covers enharmonics up to one accidental (F#/Gb, but not Abbb or E##)
+     * Works directly over the passed characters, so no temporary strings are built. The whole
+     * input is consumed, so the returned string_view is always empty; it is returned to mirror the
+     * stream operator.
      *
-     * @param midi - the MIDI value that the note should contain
-     * @return std::vector<NamingInformation>
+     * @param input - string_view from which to read the scale
+     * @param scale - reference to Scale into which to parse the input
+     * @return std::string_view
      */
-    std::vector<NamingInformation> generate_naming_information_from_midi(midi_value midi);
+    friend std::string_view operator>>(std::string_view input, BasicScale& scale)
+    {
+        scale.clear();
 
-    /**
-     * @brief Parses a note name string and generates the NameInformation object (and possible
-     * MIDIInformation)
-     *
-     * The MIDIInformation is only generated if the note is in the form "C{octave within MIDI
-     * range}", and not just "C".
-     *
-     * @param name - string reference to the note name
-     * @return std::tuple<NamingInformation, std::optional<MIDIInformation>>
-     */
-    std::tuple<NamingInformation, std::optional<MIDIInformation>>
-    generate_naming_and_midi_from_string(const std::string& name);
+        // Mirrors std::getline: an empty input produces no scale degrees, but a trailing separator
+        // does not produce an empty trailing one either
+        while (input.size() > 0)
+        {
+            size_t seperator = input.find(SCALE_DEGREE_SEPERATOR);
+            scale._scale_degrees.emplace_back(
+                parse_scale_degree_string(input.substr(0, seperator)));
+            input.remove_prefix(seperator == std::string_view::npos ? input.size() : seperator + 1);
+        }
 
-    /**
-     * @brief Generates NameInformation and MIDIInformation (under certain conditions) based off a
-     * scale root, a scale degree, and accidental number.
-     *
-     * NamingInformation only gets generated if scale_root (which we base calculation off) contains
-     * one NameInformation struct. If scale_root has no NameInformation, we do not know what to base
-     * it off of. If scale_root has multiple possible names (i.e. unclarified enharmonic
-     * possibilites), we do not know which way to do pitch spelling.
-     *
-     * MIDIInformation is only generated if scale_root has MIDIInformation we can work from.
-     *
-     * @param scale_root - reference to a Note that represents the scale's root
-     * @param scale_degree - which scale degree should be generated; uses 1-based indexing
-     * @param accidentals - which way and by how much accidentals should be applied (-1 is flat, -2
-     * is double flat, +1 is sharp etc.)
-     * @return std::tuple<std::optional<NamingInformation>, std::optional<MIDIInformation>>
-     */
-    std::tuple<std::optional<NamingInformation>, std::optional<MIDIInformation>>
-    generate_naming_and_midi_from_root_and_scale_degree(const Note& scale_root,
-                                                        scale_degree_value scale_degree,
-                                                        accidentals_value accidentals);
+        return input;
+    }
 
     /**
-     * @brief Runtime check if Note contains MIDIInformation.
+     * @brief Operator for writing a string representation of a scale to an output stream.
      *
-     * @return true
-     * @return false
+     * @param stream - output stream reference to which to write the scale
+     * @param scale - reference to Scale to write to the ostream
+     * @return std::ostream&
      */
-    inline bool check_has_midi() const { return midi_.has_value(); }
+    friend std::ostream& operator<<(std::ostream& stream, const BasicScale& scale)
+    {
+        scale.format_to(std::ostreambuf_iterator<char>{stream});
+        return stream;
+    }
 
     /**
-     * @brief Runtime check if Note contains at least one NameInformation.
+     * @brief Writes the same as the << operator to an output iterator, without allocating.
      *
-     * @return true
-     * @return false
+     * @tparam OutputIt - output iterator accepting char
+     * @param out - where to write the scale
+     * @return OutputIt - iterator past the last written character
      */
-    inline bool check_has_name() const
+    template <typename OutputIt>
+    OutputIt format_to(OutputIt out) const
     {
-        return !(!names_.has_value() || names_.value().size() == 0);
+        bool first = true;
+        for (auto&& sd : _scale_degrees)
+        {
+            if (!first)
+            {
+                *out++ = SCALE_DEGREE_SEPERATOR;
+                *out++ = ' ';
+            }
+            first = false;
+
+            std::string_view accidental = sd.second < 0 ? NamingPolicy::DOWNWARD_ACCIDENTAL
+                                                        : NamingPolicy::UPWARD_ACCIDENTAL;
+            for (int i = 0; i < (sd.second < 0 ? -sd.second : sd.second); ++i)
+            {
+                out = format_string_to(out, accidental);
+            }
+            out = format_integer_to(out, sd.first);
+        }
+        return out;
     }
 
     /**
-     * @brief Variable used to inform caching of the generated name.
+     * @brief Clears the underlying std::vector.
      *
      */
-    bool have_to_regenerate_name = true;
+    inline void clear() { return _scale_degrees.clear(); }
 
     /**
-     * @brief Used to cache the generated name (no MIDI information).
+     * @brief Returns the amount of scale degrees.
      *
+     * @return size_t
      */
-    std::string name_as_string;
+    inline size_t size() const { return _scale_degrees.size(); }
 
     /**
-     * @brief Used to generate a 'simple' name (i.e. no MIDI information).
+     * @brief Retrieves the .begin() iterator of the underlying std::vector.
      *
-     * @return std::string
+     * @return auto
      */
-    std::string generate_name_as_string() const;
+    inline auto begin() { return _scale_degrees.begin(); }
 
     /**
-     * @brief Used to cache the generated complex name (Name and MIDI information)
+     * @brief Retrieves the .end() iterator of the underlying std::vector.
      *
+     * @return auto
      */
-    std::string complex_name;
+    inline auto end() { return _scale_degrees.end(); }
 
     /**
-     * @brief Used to generate a 'complex' name (both Name and MIDI information where relevant).
+     * @brief Retrieves the const .begin() iterator of the underlying std::vector.
      *
-     * @return std::string
+     * @return auto
      */
-    std::string generate_complex_name_as_string() const;
-
-   public:
-    // Every constructor may create a note with or without both types of information!
+    inline auto begin() const { return _scale_degrees.begin(); }
 
     /**
-     * @brief Construct a new Note object - becomes middle C with both MIDI and name information
+     * @brief Retrieves the const .end() iterator of the underlying std::vector.
      *
+     * @return auto
      */
-    Note();
+    inline auto end() const { return _scale_degrees.end(); }
 
     /**
-     * @brief Construct a new Note object that represents a given MIDI value
-     *
-     * Possible names are generated if generate_names is enabled.
-     * Multiple names can be generated due to enharmonics (enharmonics only up to one accidental are
-     * created)
+     * @brief Retrieves the const .cbegin() iterator of the underlying std::vector.
      *
-     * @param midi - MIDI value of the note
-     * @param generate_names - if false, no NoteInformation is generated; if true, possible
-     * NoteInformation is generated (up to single accidental enharmonics)
+     * @return auto
      */
-    Note(midi_value midi, bool generate_names = true);
+    inline auto cbegin() const { return _scale_degrees.cbegin(); }
 
     /**
-     * @brief Set the note object to a given MIDI value
-     *
-     * Possible names are generated if generate_names is enabled.
-     * Multiple names can be generated due to enharmonics (enharmonics only up to one accidental are
-     * created)
+     * @brief Retrieves the const .cend() iterator of the underlying std::vector.
      *
-     * @param midi - MIDI value you want to set the Note to
-     * @param generate_names - if false, no NoteInformation is generated; if true, possible
-     * NoteInformation is generated (up to single accidental enharmonics)
+     * @return auto
      */
-    void set_note(midi_value midi, bool generate_names = true);
+    inline auto cend() const { return _scale_degrees.cend(); }
 
     /**
-     * @brief Construct a new Note object from a string. Will contain name information.
-     *
-     * If a number within the valid octave range is present, then MIDI information is also
-     * generated
+     * @brief Retrieves the index'th element of the underlying std::vector.
      *
-     * @param name - string reference to the name of the note
+     * @param index - 0-based index
+     * @return scale_degree&
      */
-
-    Note(const std::string& name);
+    inline scale_degree& operator[](size_t index) { return _scale_degrees[index]; }
 
     /**
-     * @brief Set a Note object from a string. Will contain name information.
-     *
-     * If a number within the valid octave range is present, then MIDI information is also
-     * generated
+     * @brief Retrieves the const index'th element of the underlying std::vector.
      *
-     * @param name - string reference to the name of the note
+     * @param index - 0-based index
+     * @return scale_degree&
      */
-    void set_note(const std::string& name);
+    inline const scale_degree& operator[](size_t index) const { return _scale_degrees[index]; }
 
     /**
-     * @brief Construct a new Note object representing a specific scale degree based off the scale
-     * root.
-     *
-     * If the scale_root has a MIDI value, then the resulting note will also have a MIDI value.
-     * If the scale_root has a unique name, then the resulting note will also have a unique name.
+     * @brief Retrieves a view of all scale degrees.
      *
-     * @param scale_root - reference to a Note that represents the scale's root
-     * @param scale_degree - which scale degree should be generated; uses 1-based indexing
-     * @param accidentals - which way and by how much accidentals should be applied (-1 is flat, -2
-     * is double flat, +1 is sharp etc.)
+     * @return std::span<const scale_degree>
      */
-    Note(const Note& scale_root, scale_degree_value scale_degree, accidentals_value accidentals);
+    inline std::span<const scale_degree> degrees() const { return _scale_degrees; }
 
     /**
-     * @brief Set a Note object representing a specific scale degree based off the scale
-     * root.
-     *
-     * If the scale_root has a MIDI value, then the resulting note will also have a MIDI value.
-     * If the scale_root has a unique name, then the resulting note will also have a unique name.
+     * @brief Counts the scale degrees in a string of scale degrees (e.g. '1,2,b3'), the same way
+     * the >> operator splits it.
      *
-     * @param scale_root - reference to a Note that represents the scale's root
-     * @param scale_degree - which scale degree should be generated; uses 1-based indexing
-     * @param accidentals - which way and by how much accidentals should be applied (-1 is flat, -2
-     * is double flat, +1 is sharp etc.)
+     * @param input - string_view of the scale degrees
+     * @return size_t
      */
-    void set_note(const Note& scale_root, scale_degree_value scale_degree,
-                  accidentals_value accidentals);
+    static constexpr size_t count_scale_degrees(std::string_view input)
+    {
+        size_t count = 0;
+        while (input.size() > 0)
+        {
+            size_t seperator = input.find(SCALE_DEGREE_SEPERATOR);
+            input.remove_prefix(seperator == std::string_view::npos ? input.size() : seperator + 1);
+            ++count;
+        }
+        return count;
+    }
+};
 
-    // The default copying and moving constructors/assignment operators work just fine.
+/**
+ * @brief A Scale in the default tuning and naming.
+ *
+ */
+using Scale = BasicScale<DefaultTuning, DefaultNaming>;
+
+/**
+ * @brief Class representing an 'abstract' musical scale of exactly N scale degrees, which can be
+ * parsed and realised at compile time.
+ *
+ * Scale keeps its degrees in a std::vector, which cannot outlive constant evaluation, so scales
+ * known up front (see the _scale literal) are kept as StaticScales and only turned into a Scale
+ * where one is needed.
+ *
+ * @tparam N - number of scale degrees
+ */
+template <size_t N>
+class StaticScale
+{
+   public:
+    using scale_degree = Scale::scale_degree;
 
+   private:
+    std::array<scale_degree, N> _scale_degrees{};
+
+   public:
     /**
-     * @brief Get the MIDI value of the MIDIInformation
+     * @brief Construct a new Static Scale object with every scale degree zeroed
      *
-     * Throws an std::runtime_error exception if no MIDIInformation is present.
+     */
+    constexpr StaticScale() = default;
+
+    /**
+     * @brief Construct a new Static Scale object from the scale degrees.
      *
-     * @return midi_value
+     * @param degrees - reference to the scale degrees
      */
-    inline midi_value get_midi() const
+    inline constexpr StaticScale(const std::array<scale_degree, N>& degrees)
+        : _scale_degrees(degrees)
     {
-        if (midi_.has_value())
-            return midi_.value().midi_value_;
-        else
-            throw std::runtime_error(NO_MIDI_INFORMATION);
     }
 
     /**
-     * @brief Get the 'simple' (no MIDI information) name as a string. Performs caching.
+     * @brief Construct a new Static Scale object from a string of scale degrees (e.g. '1,2,b3'),
+     * parsed the same way as for Scale.
      *
-     * @return std::string&
+     * Throws std::invalid_argument if the string doesn't have exactly N scale degrees or one of
+     * them doesn't parse; at compile time, that is a compilation error.
+     *
+     * @param input - string_view from which to read the scale
      */
-    std::string& get_name();
+    inline constexpr explicit StaticScale(std::string_view input)
+    {
+        if (Scale::count_scale_degrees(input) != N)
+        {
+            throw std::invalid_argument(WRONG_NUMBER_OF_SCALE_DEGREES);
+        }
+        for (auto&& sd : _scale_degrees)
+        {
+            size_t seperator = input.find(SCALE_DEGREE_SEPERATOR);
+            sd = Scale::parse_scale_degree_string(input.substr(0, seperator));
+            input.remove_prefix(seperator == std::string_view::npos ? input.size() : seperator + 1);
+        }
+    }
 
     /**
-     * @brief Get the 'simple' (no MIDI information) name as a string. Does not perform caching.
+     * @brief Returns the amount of scale degrees.
      *
-     * @return std::string
+     * @return size_t
      */
-    std::string get_name() const;
+    inline constexpr size_t size() const { return N; }
 
     /**
-     * @brief Get the 'complex' (name and MIDI information where relevant) name as a string.
-     * Performs caching.
+     * @brief Gets a scale degree.
      *
-     * @return std::string&
+     * @param index - 0-based index
+     * @return const scale_degree&
      */
-    std::string& get_name_and_midi_string();
+    inline constexpr const scale_degree& operator[](size_t index) const
+    {
+        return _scale_degrees[index];
+    }
+
+    inline constexpr auto begin() const { return _scale_degrees.begin(); }
+    inline constexpr auto end() const { return _scale_degrees.end(); }
 
     /**
-     * @brief Get the 'complex' (name and MIDI information where relevant) name as a string.
-     * Does not perform caching.
+     * @brief Retrieves a view of all scale degrees, e.g. for RealisedScale or ScaleCatalogue.
      *
-     * @return std::string&
+     * @return std::span<const scale_degree, N>
      */
-    std::string get_name_and_midi_string() const;
+    inline constexpr std::span<const scale_degree, N> degrees() const { return _scale_degrees; }
 
     /**
-     * @brief Destroy the Note object
+     * @brief Copies the scale degrees into a (runtime) Scale.
      *
+     * @tparam ScaleType - the BasicScale to copy into
+     * @return ScaleType
      */
-    ~Note() = default;
+    template <typename ScaleType = Scale>
+    inline ScaleType to_scale() const
+    {
+        return ScaleType{std::vector<scale_degree>(_scale_degrees.begin(), _scale_degrees.end())};
+    }
 
     /**
-     * @brief Printing to stream operator.
-     *
-     * Tries to print the 'complex' name if possible, otherwise prints what is possible to print.
+     * @brief Realises the scale on a root, the same as PackedRealisedScale does, but into a
+     * std::array, so it can happen at compile time.
      *
-     * @param stream - output stream reference to write out
-     * @param note - reference to Note to be printed
-     * @return std::ostream&
+     * @tparam PackedNoteType - the BasicPackedNote to realise into, i.e. the tuning and naming
+     * @param root - the PackedNote that acts as the scale root
+     * @return std::array<PackedNoteType, N>
      */
-    friend std::ostream& operator<<(std::ostream& stream, const Note& note);
+    template <typename PackedNoteType = PackedNote>
+    inline constexpr std::array<PackedNoteType, N> realise(PackedNoteType root) const
+    {
+        std::array<PackedNoteType, N> notes{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            // The 1st degree is the root itself, same as for RealisedScale
+            const scale_degree& sd = _scale_degrees[i];
+            notes[i] = sd.first == 1 ? root : PackedNoteType{root, sd.first, sd.second};
+        }
+        return notes;
+    }
+
+    friend constexpr bool operator==(const StaticScale&, const StaticScale&) = default;
+};
+
+/**
+ * @brief The characters of a string literal as a structural type, so the _scale literal can take
+ * them as a template argument.
+ *
+ * @tparam N - length of the literal, including the null terminator
+ */
+template <size_t N>
+struct ScaleLiteral
+{
+    std::array<char, N> _characters{};
+
+    inline consteval ScaleLiteral(const char (&characters)[N])
+    {
+        std::copy_n(characters, N, _characters.begin());
+    }
+
+    inline constexpr std::string_view view() const { return {_characters.data(), N - 1}; }
 };
 
-// ====NOTE====
+/**
+ * @brief Parses a scale at compile time, e.g. "1,2,b3,4,5,b6,b7"_scale is a StaticScale<7>.
+ *
+ * A string that doesn't parse as a Scale does not compile.
+ *
+ * @tparam Literal - the characters of the literal
+ * @return StaticScale of as many scale degrees as the literal has
+ */
+template <ScaleLiteral Literal>
+consteval auto operator""_scale()
+{
+    return StaticScale<Scale::count_scale_degrees(Literal.view())>{Literal.view()};
+}
+
 // ====SCALE====
+// ====REALISEDSCALE====
+
+template <typename TuningPolicy, typename NamingPolicy>
+class BasicPackedRealisedScale;
 
 /**
- * @brief Class representing an 'abstract' musical scale.alignas
- *
- * Supports scales that go past an octave (i.e. 9ths and onwards).
- * This represents the idea of a scale (e.g. 'Major'); for a specific scale (e.g. 'C Major'), see
- * RealisedScale.
+ * @brief Class representing a realised scale (e.g. 'C Major')
  *
- * Made to work as a wrapper over a vector and tries to forward as much as possible from the vector
- * such as iterators etc. More could be added here, but this is sufficient for now.
+ * Allocator-aware like Note: the notes and their names are all allocated with the scale's
+ * allocator. RealisedScale is the default tuning and naming, same as for Note.
  *
+ * @tparam TuningPolicy - the Tuning the scale is realised in
+ * @tparam NamingPolicy - how its notes are named (e.g. EnglishNaming)
  */
-class Scale
+template <typename TuningPolicy, typename NamingPolicy>
+class BasicRealisedScale
 {
+   public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    using note_type = BasicNote<TuningPolicy, NamingPolicy>;
+    using scale_type = BasicScale<TuningPolicy, NamingPolicy>;
+    using packed_type = BasicPackedRealisedScale<TuningPolicy, NamingPolicy>;
+
    private:
-    // Type aliasing
-    using scale_degree = std::pair<scale_degree_value, accidentals_value>;
+    /** Underlying container holding the Note objects */
+    std::pmr::vector<note_type> _notes;
 
     /**
-     * @brief Regex pattern for parsing a scale degree (e.g. 'b3' or '#6').
+     * @brief Method for generating the whole list of Notes in the scale for a given root note and
+     * scale, appending them to _notes.
      *
+     * @param root - reference to Note that acts as the scale root
+     * @param degrees - the scale degrees, which act as a template for generating the RealisedScale
      */
-    inline static const char scale_degree_regex_pattern[] = "(b*)(#*)([\\-|\\d]*)";
-    inline static const std::regex scale_degree_regex{scale_degree_regex_pattern};
+    void realise_scale(const note_type& root,
+                       std::span<const typename scale_type::scale_degree> degrees);
 
+   public:
     /**
-     * @brief The underlying std::vector container used to store the scale degrees.
+     * @brief Construct a new Realised Scale object
      *
      */
-    std::vector<scale_degree> _scale_degrees;
+    BasicRealisedScale() = default;
 
     /**
-     * @brief Parsing method for turning a scale degree string (e.g. 'b3' or '#6') into a
-     * scale_degree.
+     * @brief Construct a new empty Realised Scale object
      *
-     * @param input - string reference for note name to parse
-     * @return scale_degree
+     * @param alloc - allocator for the notes
      */
-    static scale_degree parse_scale_degree_string(const std::string& input);
+    inline explicit BasicRealisedScale(const allocator_type& alloc) : _notes(alloc) {}
 
-   public:
     /**
-     * @brief Construct a new empty Scale object
+     * @brief Construct a new Realised Scale object from a root note and scale.
      *
+     * @param root - reference to Note that acts as the scale root
+     * @param scale - reference to Scale, which acts as a template for generating the RealisedScale
+     * @param alloc - allocator for the notes
      */
-    Scale() = default;
+    inline BasicRealisedScale(const note_type& root, const scale_type& scale,
+                              const allocator_type& alloc = {})
+        : BasicRealisedScale(root, scale.degrees(), alloc)
+    {
+    }
 
     /**
-     * @brief Construct a new Scale object from an input stream using the >> operator.
+     * @brief Construct a new Realised Scale object from a root note and scale degrees.
      *
-     * @param stream - input stream reference to read the scale from
+     * @param root - reference to Note that acts as the scale root
+     * @param degrees - the scale degrees, which act as a template for generating the RealisedScale
+     * @param alloc - allocator for the notes
      */
-    inline Scale(std::istream& stream) { stream >> *this; }
+    BasicRealisedScale(const note_type& root,
+                       std::span<const typename scale_type::scale_degree> degrees,
+                       const allocator_type& alloc = {});
 
     /**
-     * @brief Construct a new Scale object by copying an existing std::vector<scale_degree>
+     * @brief Construct a new Realised Scale object by unpacking a PackedRealisedScale.
      *
-     * @param degrees - reference to vector of scale_degree (std::pair of scale_degree_value and accidentals_value) to copy
+     * @param scale - reference to the PackedRealisedScale to unpack
+     * @param alloc - allocator for the notes
      */
-    inline Scale(const std::vector<scale_degree>& degrees) : _scale_degrees(degrees) {};
+    explicit BasicRealisedScale(const packed_type& scale, const allocator_type& alloc = {});
+
+    // Copies use the default memory resource, moves and assignments keep the one they have, same
+    // as for Note
+    BasicRealisedScale(const BasicRealisedScale&) = default;
+    BasicRealisedScale(BasicRealisedScale&&) = default;
+    BasicRealisedScale& operator=(const BasicRealisedScale&) = default;
+    BasicRealisedScale& operator=(BasicRealisedScale&&) = default;
 
     /**
-     * @brief Construct a new Scale object by stealing an existing std::vector<scale_degree>
+     * @brief Construct a new Realised Scale object copying other, allocating with alloc.
      *
-     * @param degrees vector of scale_degree (std::pair of scale_degree_value and accidentals_value)
-     * to move
+     * @param other - reference to the RealisedScale to copy
+     * @param alloc - allocator for the notes
      */
-    inline Scale(std::vector<scale_degree>&& degrees) noexcept
-        : _scale_degrees(std::move(degrees)) {};
+    inline BasicRealisedScale(const BasicRealisedScale& other, const allocator_type& alloc)
+        : _notes(other._notes, alloc)
+    {
+    }
 
-    // The default copying and moving constructors/assignment operators work just fine.
+    /**
+     * @brief Construct a new Realised Scale object moving other, allocating with alloc. Nothing is
+     * copied if other uses the same memory resource.
+     *
+     * @param other - reference to the RealisedScale to move
+     * @param alloc - allocator for the notes
+     */
+    inline BasicRealisedScale(BasicRealisedScale&& other, const allocator_type& alloc)
+        : _notes(std::move(other._notes), alloc)
+    {
+    }
 
     /**
-     * @brief Operator for parsing a csv input stream into a scale object.
+     * @brief Returns the allocator the notes are allocated with.
      *
-     * @param stream - input stream reference from which to read the scale
-     * @param scale - reference to Scale into which to parse the input
-     * @return std::istream&
+     * @return allocator_type
      */
-    friend std::istream& operator>>(std::istream& stream, Scale& scale);
+    inline allocator_type get_allocator() const { return _notes.get_allocator(); }
 
     /**
-     * @brief Operator for writing a string representation of a scale to an output stream.
+     * @brief Get the root note (1st note in the scale)
      *
-     * @param stream - output stream reference to which to write the scale
-     * @param scale - reference to Scale to write to the ostream
+     * Technically, you could create a scale that does not contain the tonic; in that case this
+     * method will return the 'incorrect' value.
+     * In that case though, you're already doing something very very strange and illogical, so tough
+     * luck buddy.
+     *
+     * @return const note_type&
+     */
+    inline const note_type& get_root() const { return _notes[0]; }
+
+    /**
+     * @brief Operator for printing a realised scale into an output stream.
+     *
+     * @param stream - reference to output stream where we want to write the RealisedScale into
+     * @param scale - reference to RealisedScale we want to write to the output
      * @return std::ostream&
      */
-    friend std::ostream& operator<<(std::ostream& stream, const Scale& scale);
+    friend std::ostream& operator<<(std::ostream& stream, const BasicRealisedScale& scale)
+    {
+        scale.format_to(std::ostreambuf_iterator<char>{stream});
+        return stream;
+    }
+
+    /**
+     * @brief Writes the same as the << operator to an output iterator, without allocating.
+     *
+     * @tparam OutputIt - output iterator accepting char
+     * @param out - where to write the scale
+     * @return OutputIt - iterator past the last written character
+     */
+    template <typename OutputIt>
+    OutputIt format_to(OutputIt out) const
+    {
+        bool first = true;
+        for (auto&& note : _notes)
+        {
+            if (!first)
+            {
+                *out++ = SCALE_DEGREE_SEPERATOR;
+                *out++ = ' ';
+            }
+            first = false;
+            out = note.format_name_to(out);
+        }
+        return out;
+    }
 
     /**
      * @brief Clears the underlying std::vector.
      *
      */
-    inline void clear() { return _scale_degrees.clear(); }
+    inline void clear() { return _notes.clear(); }
 
     /**
      * @brief Returns the amount of scale degrees.
      *
      * @return size_t
      */
-    inline size_t size() { return _scale_degrees.size(); }
+    inline size_t size() const { return _notes.size(); }
 
     /**
      * @brief Retrieves the .begin() iterator of the underlying std::vector.
      *
      * @return auto
      */
-    inline auto begin() { return _scale_degrees.begin(); }
+    inline auto begin() { return _notes.begin(); }
 
     /**
      * @brief Retrieves the .end() iterator of the underlying std::vector.
      *
      * @return auto
      */
-    inline auto end() { return _scale_degrees.end(); }
+    inline auto end() { return _notes.end(); }
 
     /**
      * @brief Retrieves the const .begin() iterator of the underlying std::vector.
      *
      * @return auto
      */
-    inline auto begin() const { return _scale_degrees.begin(); }
+    inline auto begin() const { return _notes.begin(); }
 
     /**
      * @brief Retrieves the const .end() iterator of the underlying std::vector.
      *
      * @return auto
      */
-    inline auto end() const { return _scale_degrees.end(); }
+    inline auto end() const { return _notes.end(); }
 
     /**
      * @brief Retrieves the const .cbegin() iterator of the underlying std::vector.
      *
      * @return auto
      */
-    inline auto cbegin() const { return _scale_degrees.cbegin(); }
+    inline auto cbegin() const { return _notes.cbegin(); }
 
     /**
      * @brief Retrieves the const .cend() iterator of the underlying std::vector.
      *
      * @return auto
      */
-    inline auto cend() const { return _scale_degrees.cend(); }
+    inline auto cend() const { return _notes.cend(); }
 
     /**
      * @brief Retrieves the index'th element of the underlying std::vector.
@@ -566,7 +2657,7 @@ class Scale
      * @param index - 0-based index
      * @return scale_degree&
      */
-    inline scale_degree& operator[](size_t index) { return _scale_degrees[index]; }
+    inline note_type& operator[](size_t index) { return _notes[index]; }
 
     /**
      * @brief Retrieves the const index'th element of the underlying std::vector.
@@ -574,140 +2665,366 @@ class Scale
      * @param index - 0-based index
      * @return scale_degree&
      */
-    inline const scale_degree& operator[](size_t index) const { return _scale_degrees[index]; }
+    inline const note_type& operator[](size_t index) const { return _notes[index]; }
 };
 
-// ====SCALE====
-// ====REALISEDSCALE====
-
 /**
- * @brief Class representing a realised scale (e.g. 'C Major')
+ * @brief Class representing a realised scale (e.g. 'C Major') stored as PackedNotes.
+ *
+ * This is the packed storage mode of RealisedScale; realising into it only allocates the one
+ * underlying vector, never per note. For bulk work, realise_scale can also write straight into a
+ * caller-provided container so that many scales share one allocation. PackedRealisedScale is the
+ * default tuning and naming, same as for Note.
  *
+ * @tparam TuningPolicy - the Tuning the scale is realised in
+ * @tparam NamingPolicy - how its notes are named (e.g. EnglishNaming)
  */
-class RealisedScale
+template <typename TuningPolicy, typename NamingPolicy>
+class BasicPackedRealisedScale
 {
+   public:
+    using note_type = BasicPackedNote<TuningPolicy, NamingPolicy>;
+    using scale_type = BasicScale<TuningPolicy, NamingPolicy>;
+    using unpacked_type = BasicRealisedScale<TuningPolicy, NamingPolicy>;
+
    private:
-    /** Underlying container holding the Note objects */
-    std::vector<Note> _notes;
+    /** Underlying container holding the PackedNote objects */
+    std::vector<note_type> _notes;
 
+   public:
     /**
-     * @brief Method for generating the whole list of Notes in the scale for a given root note and
-     * scale.
+     * @brief Construct a new empty Packed Realised Scale object
      *
-     * @param root - reference to Note that acts as the scale root
-     * @param scale - reference to Scale, which acts as a template for generating the RealisedScale
-     * @return std::vector<Note>
      */
-    std::vector<Note> realise_scale(const Note& root, const Scale& scale);
+    BasicPackedRealisedScale() = default;
 
-   public:
     /**
-     * @brief Construct a new Realised Scale object
+     * @brief Construct a new Packed Realised Scale object from a root note and scale.
      *
+     * @param root - PackedNote that acts as the scale root
+     * @param scale - reference to Scale, which acts as a template for generating the scale
      */
-    RealisedScale() = default;
+    inline BasicPackedRealisedScale(note_type root, const scale_type& scale)
+        : BasicPackedRealisedScale(root, scale.degrees())
+    {
+    }
 
     /**
-     * @brief Construct a new Realised Scale object from a root note and scale.
+     * @brief Construct a new Packed Realised Scale object from a root note and scale degrees.
      *
-     * @param root - reference to Note that acts as the scale root
-     * @param scale - reference to Scale, which acts as a template for generating the RealisedScale
+     * @param root - PackedNote that acts as the scale root
+     * @param degrees - the scale degrees, which act as a template for generating the scale
      */
-    RealisedScale(const Note& root, const Scale& scale);
+    BasicPackedRealisedScale(note_type root,
+                             std::span<const typename scale_type::scale_degree> degrees);
 
     /**
-     * @brief Get the root note (1st note in the scale)
-     *
-     * Technically, you could create a scale that does not contain the tonic; in that case this
-     * method will return the 'incorrect' value.
-     * In that case though, you're already doing something very very strange and illogical, so tough
-     * luck buddy.
+     * @brief Construct a new Packed Realised Scale object by packing every Note of a RealisedScale.
      *
-     * @return const Note&
+     * @param scale - reference to the RealisedScale to pack
      */
-    inline const Note& get_root() const { return _notes[0]; }
+    explicit BasicPackedRealisedScale(const unpacked_type& scale);
 
     /**
-     * @brief Operator for printing a realised scale into an output stream.
+     * @brief Writes the PackedNotes of the scale realised on root to an output iterator.
      *
-     * @param stream - reference to output stream where we want to write the RealisedScale into
-     * @param scale - reference to RealisedScale we want to write to the output
-     * @return std::ostream&
+     * @tparam OutputIt - output iterator accepting PackedNote
+     * @param root - PackedNote that acts as the scale root
+     * @param degrees - the scale degrees, which act as a template for generating the scale
+     * @param out - where to write the notes
+     * @return OutputIt - iterator past the last written note
      */
-    friend std::ostream& operator<<(std::ostream& stream, const RealisedScale& scale);
+    template <typename OutputIt>
+    static OutputIt realise_scale(note_type root,
+                                  std::span<const typename scale_type::scale_degree> degrees,
+                                  OutputIt out)
+    {
+        for (auto&& sd : degrees)
+        {
+            *out++ = sd.first == 1 ? root : note_type{root, sd.first, sd.second};
+        }
+        return out;
+    }
 
     /**
-     * @brief Clears the underlying std::vector.
+     * @brief Writes the PackedNotes of the scale realised on root to an output iterator.
      *
+     * @tparam OutputIt - output iterator accepting PackedNote
+     * @param root - PackedNote that acts as the scale root
+     * @param scale - reference to Scale, which acts as a template for generating the scale
+     * @param out - where to write the notes
+     * @return OutputIt - iterator past the last written note
      */
-    inline void clear() { return _notes.clear(); }
+    template <typename OutputIt>
+    static OutputIt realise_scale(note_type root, const scale_type& scale, OutputIt out)
+    {
+        return realise_scale(root, scale.degrees(), out);
+    }
 
     /**
-     * @brief Returns the amount of scale degrees.
+     * @brief Get the root note (1st note in the scale). Same caveats as RealisedScale::get_root.
      *
-     * @return size_t
+     * @return note_type
      */
-    inline size_t size() { return _notes.size(); }
+    inline note_type get_root() const { return _notes[0]; }
 
     /**
-     * @brief Retrieves the .begin() iterator of the underlying std::vector.
+     * @brief Operator for printing a packed realised scale into an output stream.
      *
-     * @return auto
+     * Prints the same as the equivalent RealisedScale.
+     *
+     * @param stream - reference to output stream where we want to write the scale into
+     * @param scale - reference to PackedRealisedScale we want to write to the output
+     * @return std::ostream&
      */
-    inline auto begin() { return _notes.begin(); }
+    friend std::ostream& operator<<(std::ostream& stream, const BasicPackedRealisedScale& scale)
+    {
+        scale.format_to(std::ostreambuf_iterator<char>{stream});
+        return stream;
+    }
 
     /**
-     * @brief Retrieves the .end() iterator of the underlying std::vector.
+     * @brief Writes the same as the << operator to an output iterator, without allocating.
      *
-     * @return auto
+     * @tparam OutputIt - output iterator accepting char
+     * @param out - where to write the scale
+     * @return OutputIt - iterator past the last written character
      */
-    inline auto end() { return _notes.end(); }
+    template <typename OutputIt>
+    OutputIt format_to(OutputIt out) const
+    {
+        return format_notes_to(out, _notes);
+    }
 
     /**
-     * @brief Retrieves the const .begin() iterator of the underlying std::vector.
+     * @brief Writes PackedNotes the way a PackedRealisedScale made of them prints (e.g. notes
+     * written by realise_scale), without allocating.
      *
-     * @return auto
+     * @tparam OutputIt - output iterator accepting char
+     * @param out - where to write the notes
+     * @param notes - the notes of the scale
+     * @return OutputIt - iterator past the last written character
      */
-    inline auto begin() const { return _notes.begin(); }
+    template <typename OutputIt>
+    static OutputIt format_notes_to(OutputIt out, std::span<const note_type> notes)
+    {
+        bool first = true;
+        for (auto&& note : notes)
+        {
+            if (!first)
+            {
+                *out++ = SCALE_DEGREE_SEPERATOR;
+                *out++ = ' ';
+            }
+            first = false;
+            out = note.format_name_to(out);
+        }
+        return out;
+    }
 
     /**
-     * @brief Retrieves the const .end() iterator of the underlying std::vector.
+     * @brief Clears the underlying std::vector.
      *
-     * @return auto
      */
-    inline auto end() const { return _notes.end(); }
+    inline void clear() { return _notes.clear(); }
 
     /**
-     * @brief Retrieves the const .cbegin() iterator of the underlying std::vector.
+     * @brief Returns the amount of scale degrees.
      *
-     * @return auto
+     * @return size_t
      */
-    inline auto cbegin() const { return _notes.cbegin(); }
+    inline size_t size() const { return _notes.size(); }
 
     /**
-     * @brief Retrieves the const .cend() iterator of the underlying std::vector.
+     * @brief Retrieves the const .begin() iterator of the underlying std::vector.
      *
      * @return auto
      */
-    inline auto cend() const { return _notes.cend(); }
+    inline auto begin() const { return _notes.begin(); }
 
     /**
-     * @brief Retrieves the index'th element of the underlying std::vector.
+     * @brief Retrieves the const .end() iterator of the underlying std::vector.
      *
-     * @param index - 0-based index
-     * @return scale_degree&
+     * @return auto
      */
-    inline Note& operator[](size_t index) { return _notes[index]; }
+    inline auto end() const { return _notes.end(); }
 
     /**
-     * @brief Retrieves the const index'th element of the underlying std::vector.
+     * @brief Retrieves the index'th element of the underlying std::vector.
      *
      * @param index - 0-based index
-     * @return scale_degree&
+     * @return note_type
      */
-    inline const Note& operator[](size_t index) const { return _notes[index]; }
+    inline note_type operator[](size_t index) const { return _notes[index]; }
 };
 
+template <typename TuningPolicy, typename NamingPolicy>
+void BasicRealisedScale<TuningPolicy, NamingPolicy>::realise_scale(
+    const note_type& root, std::span<const typename scale_type::scale_degree> degrees)
+{
+    // The notes are constructed in place, so they get _notes' allocator without a copy
+    _notes.reserve(degrees.size());
+    for (auto&& sd : degrees)
+    {
+        if (sd.first == 1)
+        {
+            _notes.emplace_back(root);
+        }
+        else
+        {
+            _notes.emplace_back(root, sd.first, sd.second);
+        }
+    }
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+BasicRealisedScale<TuningPolicy, NamingPolicy>::BasicRealisedScale(
+    const note_type& root, std::span<const typename scale_type::scale_degree> degrees,
+    const allocator_type& alloc)
+    : _notes(alloc)
+{
+    realise_scale(root, degrees);
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+BasicRealisedScale<TuningPolicy, NamingPolicy>::BasicRealisedScale(const packed_type& scale,
+                                                                   const allocator_type& alloc)
+    : _notes(alloc)
+{
+    _notes.reserve(scale.size());
+    for (auto&& note : scale)
+    {
+        _notes.emplace_back(note);
+    }
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+BasicPackedRealisedScale<TuningPolicy, NamingPolicy>::BasicPackedRealisedScale(
+    note_type root, std::span<const typename scale_type::scale_degree> degrees)
+{
+    _notes.reserve(degrees.size());
+    realise_scale(root, degrees, std::back_inserter(_notes));
+}
+
+template <typename TuningPolicy, typename NamingPolicy>
+BasicPackedRealisedScale<TuningPolicy, NamingPolicy>::BasicPackedRealisedScale(
+    const unpacked_type& scale)
+{
+    _notes.reserve(scale.size());
+    for (auto&& note : scale)
+    {
+        _notes.emplace_back(note);
+    }
+}
+
+/**
+ * @brief A RealisedScale in the default tuning and naming.
+ *
+ */
+using RealisedScale = BasicRealisedScale<DefaultTuning, DefaultNaming>;
+
+/**
+ * @brief A PackedRealisedScale in the default tuning and naming.
+ *
+ */
+using PackedRealisedScale = BasicPackedRealisedScale<DefaultTuning, DefaultNaming>;
+
+extern template class BasicRealisedScale<DefaultTuning, DefaultNaming>;
+extern template class BasicPackedRealisedScale<DefaultTuning, DefaultNaming>;
+
 // ====REALISEDSCALE====
+// ====STD::FORMAT====
+
+// std::formatter specialisations, so the library types work with std::format, std::format_to etc.
+// They all write straight into the output of the format context through the format_to methods.
+
+/**
+ * @brief Format spec parsing shared by the formatters that take no format spec ("{}").
+ *
+ */
+struct MusicLibraryFormatter
+{
+    constexpr auto parse(std::format_parse_context& context)
+    {
+        auto it = context.begin();
+        if (it != context.end() && *it != '}') throw std::format_error(BAD_FORMAT_SPEC);
+        return it;
+    }
+};
+
+/**
+ * @brief Formats a Note the same as the << operator. The 'n' format spec ("{:n}") only writes the
+ * name, same as Note::get_name.
+ *
+ */
+template <typename TuningPolicy, typename NamingPolicy>
+struct std::formatter<BasicNote<TuningPolicy, NamingPolicy>>
+{
+    bool _name_only = false;
+
+    constexpr auto parse(std::format_parse_context& context)
+    {
+        auto it = context.begin();
+        if (it != context.end() && *it == 'n')
+        {
+            _name_only = true;
+            ++it;
+        }
+        if (it != context.end() && *it != '}') throw std::format_error(BAD_FORMAT_SPEC);
+        return it;
+    }
+
+    template <typename FormatContext>
+    auto format(const BasicNote<TuningPolicy, NamingPolicy>& note, FormatContext& context) const
+    {
+        return _name_only ? note.format_name_to(context.out()) : note.format_to(context.out());
+    }
+};
+
+/**
+ * @brief Formats a Scale the same as the << operator.
+ *
+ */
+template <typename TuningPolicy, typename NamingPolicy>
+struct std::formatter<BasicScale<TuningPolicy, NamingPolicy>> : MusicLibraryFormatter
+{
+    template <typename FormatContext>
+    auto format(const BasicScale<TuningPolicy, NamingPolicy>& scale, FormatContext& context) const
+    {
+        return scale.format_to(context.out());
+    }
+};
+
+/**
+ * @brief Formats a RealisedScale the same as the << operator.
+ *
+ */
+template <typename TuningPolicy, typename NamingPolicy>
+struct std::formatter<BasicRealisedScale<TuningPolicy, NamingPolicy>> : MusicLibraryFormatter
+{
+    template <typename FormatContext>
+    auto format(const BasicRealisedScale<TuningPolicy, NamingPolicy>& scale,
+                FormatContext& context) const
+    {
+        return scale.format_to(context.out());
+    }
+};
+
+/**
+ * @brief Formats a PackedRealisedScale the same as the << operator.
+ *
+ */
+template <typename TuningPolicy, typename NamingPolicy>
+struct std::formatter<BasicPackedRealisedScale<TuningPolicy, NamingPolicy>> : MusicLibraryFormatter
+{
+    template <typename FormatContext>
+    auto format(const BasicPackedRealisedScale<TuningPolicy, NamingPolicy>& scale,
+                FormatContext& context) const
+    {
+        return scale.format_to(context.out());
+    }
+};
+
+// ====STD::FORMAT====
 
 #endif
\ No newline at end of file
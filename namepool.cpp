@@ -0,0 +1,84 @@
+#include "namepool.hpp"
+
+#include <algorithm>
+
+std::string_view NamePool::store(std::string_view name)
+{
+    // Takes no room, and there may be no block yet to point into: a new or cleared pool starts
+    // out with a full (nonexistent) block
+    if (name.empty()) return {};
+
+    if (name.size() > BLOCK_SIZE)
+    {
+        // Oversized strings get an exact fit block, the current one stays open for appending
+        auto& block = _blocks.emplace_back(std::make_unique<char[]>(name.size()));
+        std::copy(name.begin(), name.end(), block.get());
+        return {block.get(), name.size()};
+    }
+
+    if (BLOCK_SIZE - _block_used < name.size())
+    {
+        _current_block = _blocks.emplace_back(std::make_unique<char[]>(BLOCK_SIZE)).get();
+        _block_used = 0;
+    }
+
+    char* start = _current_block + _block_used;
+    std::copy(name.begin(), name.end(), start);
+    _block_used += name.size();
+    return {start, name.size()};
+}
+
+NamePool::NameId NamePool::intern(std::string_view name)
+{
+    if (_ids_stale)
+    {
+        _ids.reserve(_views.size());
+        for (NameId id = 0; id < _views.size(); ++id)
+        {
+            _ids.emplace(_views[id], id);
+        }
+        _ids_stale = false;
+    }
+
+    if (auto it = _ids.find(name); it != _ids.end())
+    {
+        return it->second;
+    }
+
+    std::string_view stored = store(name);
+    NameId id = static_cast<NameId>(_views.size());
+    _views.push_back(stored);
+    _ids.emplace(stored, id);
+    return id;
+}
+
+void NamePool::assign(std::string_view table, std::span<const std::uint32_t> offsets)
+{
+    clear();
+    if (offsets.empty()) return;
+
+    // An exact fit block of its own, so later strings never get appended into it
+    char* block = nullptr;
+    if (!table.empty())
+    {
+        block = _blocks.emplace_back(std::make_unique<char[]>(table.size())).get();
+        std::copy(table.begin(), table.end(), block);
+    }
+
+    _views.reserve(offsets.size() - 1);
+    for (size_t id = 0; id + 1 < offsets.size(); ++id)
+    {
+        _views.emplace_back(block + offsets[id], offsets[id + 1] - offsets[id]);
+    }
+    _ids_stale = true;
+}
+
+void NamePool::clear()
+{
+    _ids.clear();
+    _ids_stale = false;
+    _views.clear();
+    _blocks.clear();
+    _current_block = nullptr;
+    _block_used = BLOCK_SIZE;
+}
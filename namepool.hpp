@@ -0,0 +1,154 @@
+#ifndef NAMEPOOL
+#define NAMEPOOL
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Interns strings into an arena, handing out stable std::string_view and id handles.
+ *
+ * Characters are appended into fixed size blocks that are never reallocated, so a view handed out
+ * stays valid for as long as the pool lives, also when the pool itself is moved. Equal strings are
+ * stored only once and get the same id. The pool cannot be copied, as that would leave the views
+ * pointing into the original.
+ *
+ */
+class NamePool
+{
+   public:
+    /**
+     * @brief Handle of an interned string, dense and in order of first interning.
+     *
+     */
+    using NameId = std::uint32_t;
+
+   private:
+    /**
+     * @brief Size of a regular block; longer strings get a block of their own.
+     *
+     */
+    static constexpr size_t BLOCK_SIZE = 4096;
+
+    /**
+     * @brief The arena; strings are never split across blocks.
+     *
+     */
+    std::vector<std::unique_ptr<char[]>> _blocks;
+
+    /**
+     * @brief How much of the last regular block is used.
+     *
+     */
+    size_t _block_used = BLOCK_SIZE;
+
+    /**
+     * @brief The last regular block, which new strings are appended to.
+     *
+     */
+    char* _current_block = nullptr;
+
+    /**
+     * @brief View of every interned string, indexed by id.
+     *
+     */
+    std::vector<std::string_view> _views;
+
+    /**
+     * @brief Looks interned strings up by content; the keys point into the arena.
+     *
+     * After assign this is only rebuilt on the next intern, so loading a table costs no hashing.
+     */
+    std::unordered_map<std::string_view, NameId> _ids;
+
+    /**
+     * @brief Whether _ids has to be rebuilt from _views before it is used.
+     *
+     */
+    bool _ids_stale = false;
+
+    /**
+     * @brief Copies the string into the arena; an empty string is not stored anywhere.
+     *
+     * @param name - the string to copy
+     * @return std::string_view - view of the copy
+     */
+    std::string_view store(std::string_view name);
+
+   public:
+    NamePool() = default;
+    NamePool(const NamePool&) = delete;
+    NamePool& operator=(const NamePool&) = delete;
+
+    /**
+     * @brief Construct a new Name Pool object, taking over the arena of other.
+     *
+     * @param other - pool to move from, left empty
+     */
+    inline NamePool(NamePool&& other) noexcept { *this = std::move(other); }
+
+    /**
+     * @brief Takes over the arena of other; views into it stay valid.
+     *
+     * @param other - pool to move from, left empty
+     * @return NamePool&
+     */
+    inline NamePool& operator=(NamePool&& other) noexcept
+    {
+        _blocks = std::move(other._blocks);
+        _block_used = std::exchange(other._block_used, BLOCK_SIZE);
+        _current_block = std::exchange(other._current_block, nullptr);
+        _views = std::move(other._views);
+        _ids = std::move(other._ids);
+        _ids_stale = std::exchange(other._ids_stale, false);
+        other.clear();
+        return *this;
+    }
+
+    /**
+     * @brief Interns a string, copying it into the arena unless an equal one is already there.
+     *
+     * @param name - the string to intern
+     * @return NameId - the id of the interned string
+     */
+    NameId intern(std::string_view name);
+
+    /**
+     * @brief Returns the view of an interned string.
+     *
+     * @param id - id returned by intern
+     * @return std::string_view
+     */
+    inline std::string_view view(NameId id) const { return _views[id]; }
+
+    /**
+     * @brief Returns the number of distinct strings interned.
+     *
+     * @return size_t
+     */
+    inline size_t size() const { return _views.size(); }
+
+    /**
+     * @brief Replaces the contents of the pool with a table of distinct strings, which gets copied
+     * into the arena in one piece.
+     *
+     * The string of id i is table[offsets[i], offsets[i + 1]), so offsets has one more element
+     * than there are strings. The offsets have to be non-decreasing and within the table.
+     *
+     * @param table - all strings back to back
+     * @param offsets - where every string starts, followed by the end of the last one
+     */
+    void assign(std::string_view table, std::span<const std::uint32_t> offsets);
+
+    /**
+     * @brief Drops every interned string; all handed out views and ids become invalid.
+     *
+     */
+    void clear();
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef PARALLEL
+#define PARALLEL
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Splits total items into number_of_blocks contiguous blocks as evenly as possible.
+ *
+ * The first (total % number_of_blocks) blocks get one extra item.
+ *
+ * @param total - the amount of items to split
+ * @param number_of_blocks - the amount of blocks, at least 1
+ * @param block - which block to get the range of
+ * @return std::pair<size_t, size_t> - first item and one past the last item of the block
+ */
+inline std::pair<size_t, size_t> block_range(size_t total, size_t number_of_blocks, size_t block)
+{
+    size_t base = total / number_of_blocks;
+    size_t extra = total % number_of_blocks;
+    size_t first = block * base + (block < extra ? block : extra);
+    return {first, first + base + (block < extra)};
+}
+
+/**
+ * @brief Runs work(worker) for every worker in [0, number_of_workers) on its own thread and waits
+ * for all of them.
+ *
+ * Exceptions cannot cross threads on their own, so each worker's is caught and, once every worker
+ * is done, the one of the lowest worker index is rethrown. With contiguous blocks of work this is
+ * the error a sequential run would have hit first.
+ *
+ * @tparam Function - callable taking the worker index
+ * @param number_of_workers - the amount of threads to start
+ * @param work - what each worker runs
+ */
+template <typename Function>
+void fork_join(size_t number_of_workers, Function&& work)
+{
+    std::vector<std::exception_ptr> errors(number_of_workers);
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(number_of_workers);
+        for (size_t w = 0; w < number_of_workers; ++w)
+        {
+            workers.emplace_back(
+                [&work, w, &error = errors[w]]()
+                {
+                    try
+                    {
+                        work(w);
+                    }
+                    catch (...)
+                    {
+                        error = std::current_exception();
+                    }
+                });
+        }
+    }  // jthreads join here
+
+    for (auto&& error : errors)
+    {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+#endif
@@ -0,0 +1,120 @@
+#include "profiler.hpp"
+
+#include <format>
+#include <iterator>
+
+namespace
+{
+// Allocations of the current thread, only counted when profiling is compiled in
+thread_local std::uint64_t thread_allocations = 0;
+thread_local std::uint64_t thread_allocated_bytes = 0;
+
+constexpr std::array<std::string_view, Profiler::NUMBER_OF_PHASES> phase_names{
+    "File load", "Build maps", "Scale sampling", "Root sampling",
+    "Realisation", "Distractor selection", "Rendering", "Results saving"};
+}  // namespace
+
+#ifdef SCALES_PROFILING
+#include <cstdlib>
+#include <new>
+
+// ====ALLOCATION COUNTING====
+// Replacing the global allocation functions; the array and nothrow forms forward to these.
+
+void* operator new(std::size_t size)
+{
+    ++thread_allocations;
+    thread_allocated_bytes += size;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++thread_allocations;
+    thread_allocated_bytes += size;
+    auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants the size to be a multiple of the alignment
+    if (void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+#endif
+
+std::array<Profiler::PhaseTotals, Profiler::NUMBER_OF_PHASES> Profiler::_totals{};
+
+Profiler::Scope::Scope(ProfilePhase phase)
+    : _phase(phase),
+      _start(std::chrono::steady_clock::now()),
+      _start_allocations(thread_allocations),
+      _start_allocated_bytes(thread_allocated_bytes)
+{
+}
+
+Profiler::Scope::~Scope()
+{
+    auto elapsed = std::chrono::steady_clock::now() - _start;
+    PhaseTotals& totals = _totals[static_cast<size_t>(_phase)];
+    totals._calls.fetch_add(1, std::memory_order_relaxed);
+    totals._nanoseconds.fetch_add(
+        static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+        std::memory_order_relaxed);
+    totals._allocations.fetch_add(thread_allocations - _start_allocations,
+                                  std::memory_order_relaxed);
+    totals._allocated_bytes.fetch_add(thread_allocated_bytes - _start_allocated_bytes,
+                                      std::memory_order_relaxed);
+}
+
+std::string_view Profiler::phase_name(ProfilePhase phase)
+{
+    return phase_names[static_cast<size_t>(phase)];
+}
+
+const Profiler::PhaseTotals& Profiler::totals(ProfilePhase phase)
+{
+    return _totals[static_cast<size_t>(phase)];
+}
+
+void Profiler::reset()
+{
+    for (auto&& totals : _totals)
+    {
+        totals._calls = 0;
+        totals._nanoseconds = 0;
+        totals._allocations = 0;
+        totals._allocated_bytes = 0;
+    }
+}
+
+void Profiler::write_report(std::ostream& stream)
+{
+    if (!ENABLED)
+    {
+        stream << "Profiling was not compiled in; configure with -DSCALES_PROFILING=ON\n";
+        return;
+    }
+
+    std::string report;
+    auto out = std::back_inserter(report);
+    std::format_to(out, "{:<22}{:>10}{:>14}{:>14}{:>14}{:>16}\n", "Phase", "Calls", "Total ms",
+                   "Mean us", "Allocations", "Bytes");
+    for (size_t p = 0; p < NUMBER_OF_PHASES; ++p)
+    {
+        const PhaseTotals& totals = _totals[p];
+        std::uint64_t calls = totals._calls;
+        double nanoseconds = static_cast<double>(totals._nanoseconds.load());
+        std::format_to(out, "{:<22}{:>10}{:>14.3f}{:>14.3f}{:>14}{:>16}\n", phase_names[p], calls,
+                       nanoseconds / 1e6,
+                       calls == 0 ? 0.0 : nanoseconds / 1e3 / static_cast<double>(calls),
+                       totals._allocations.load(), totals._allocated_bytes.load());
+    }
+    stream << report;
+}
@@ -0,0 +1,143 @@
+#ifndef PROFILER
+#define PROFILER
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+/**
+ * @brief The phases of the application that the profiler tells apart.
+ *
+ * Phases can nest (e.g. realisation happens while generating a session); every phase counts
+ * everything that happens inside of it.
+ */
+enum class ProfilePhase
+{
+    FILE_LOAD = 0,
+    BUILD_MAPS,
+    SCALE_SAMPLING,
+    ROOT_SAMPLING,
+    REALISATION,
+    DISTRACTOR_SELECTION,
+    RENDERING,
+    RESULTS_SAVING
+};
+
+/**
+ * @brief Opt-in instrumentation recording the wall time and heap allocations of every phase.
+ *
+ * Everything is compiled out unless SCALES_PROFILING is defined (the SCALES_PROFILING CMake
+ * option): SCALES_PROFILE_PHASE then expands to nothing and no allocation is counted. With it,
+ * the global operator new is replaced to count allocations per thread, and a phase scope adds its
+ * time and the allocations of its own thread to the totals. Totals are atomic, so phases may run
+ * on several threads at once.
+ */
+class Profiler
+{
+   public:
+    /**
+     * @brief The amount of values in ProfilePhase
+     *
+     */
+    static constexpr size_t NUMBER_OF_PHASES = 8;
+
+    /**
+     * @brief Whether the profiler was compiled in.
+     *
+     */
+#ifdef SCALES_PROFILING
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    /**
+     * @brief Totals of a single phase.
+     *
+     */
+    struct PhaseTotals
+    {
+        std::atomic<std::uint64_t> _calls{0};
+        std::atomic<std::uint64_t> _nanoseconds{0};
+        std::atomic<std::uint64_t> _allocations{0};
+        std::atomic<std::uint64_t> _allocated_bytes{0};
+    };
+
+    /**
+     * @brief Records a phase from construction until destruction.
+     *
+     */
+    class Scope
+    {
+       private:
+        ProfilePhase _phase;
+        std::chrono::steady_clock::time_point _start;
+        std::uint64_t _start_allocations;
+        std::uint64_t _start_allocated_bytes;
+
+       public:
+        /**
+         * @brief Construct a new Scope object, starting the phase
+         *
+         * @param phase - the phase being run
+         */
+        explicit Scope(ProfilePhase phase);
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /**
+         * @brief Destroy the Scope object, adding the phase to the totals
+         *
+         */
+        ~Scope();
+    };
+
+   private:
+    static std::array<PhaseTotals, NUMBER_OF_PHASES> _totals;
+
+   public:
+    /**
+     * @brief Get the name of a phase, as printed in the report.
+     *
+     * @param phase - the phase
+     * @return std::string_view
+     */
+    static std::string_view phase_name(ProfilePhase phase);
+
+    /**
+     * @brief Get the totals of a phase so far.
+     *
+     * @param phase - the phase
+     * @return const PhaseTotals&
+     */
+    static const PhaseTotals& totals(ProfilePhase phase);
+
+    /**
+     * @brief Sets every total back to zero.
+     *
+     */
+    static void reset();
+
+    /**
+     * @brief Writes a table of the totals of every phase. If the profiler was not compiled in,
+     * writes a note saying so instead.
+     *
+     * @param stream - reference to the output stream to write to
+     */
+    static void write_report(std::ostream& stream);
+};
+
+#ifdef SCALES_PROFILING
+#define SCALES_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SCALES_PROFILE_CONCAT(a, b) SCALES_PROFILE_CONCAT_IMPL(a, b)
+#define SCALES_PROFILE_PHASE(phase) \
+    Profiler::Scope SCALES_PROFILE_CONCAT(profile_scope_, __LINE__) { ProfilePhase::phase }
+#else
+#define SCALES_PROFILE_PHASE(phase)
+#endif
+
+#endif
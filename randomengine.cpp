@@ -0,0 +1,68 @@
+#include "randomengine.hpp"
+
+#include <random>
+
+namespace
+{
+constexpr std::uint64_t SPLITMIX64_INCREMENT = 0x9e3779b97f4a7c15;
+
+/**
+ * @brief Finaliser of splitmix64, spreading every input bit over the whole result.
+ *
+ */
+std::uint64_t splitmix64_mix(std::uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+}  // namespace
+
+Xoshiro256StarStar::Xoshiro256StarStar(std::uint64_t seed)
+{
+    // splitmix64, as recommended by the xoshiro authors for seeding
+    for (auto&& word : _state)
+    {
+        seed += SPLITMIX64_INCREMENT;
+        word = splitmix64_mix(seed);
+    }
+}
+
+void Xoshiro256StarStar::jump()
+{
+    static constexpr std::array<result_type, 4> jump_polynomial{
+        0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+
+    std::array<result_type, 4> jumped{};
+    for (auto&& word : jump_polynomial)
+    {
+        for (int bit = 0; bit < 64; ++bit)
+        {
+            if (word & (result_type{1} << bit))
+            {
+                for (size_t i = 0; i < jumped.size(); ++i) jumped[i] ^= _state[i];
+            }
+            (*this)();
+        }
+    }
+    _state = jumped;
+}
+
+std::uint64_t random_seed()
+{
+    std::random_device rd;
+    return (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+}
+
+RandomEngine make_stream(std::uint64_t seed, std::uint64_t stream_index)
+{
+    RandomEngine engine{seed};
+    for (std::uint64_t i = 0; i < stream_index; ++i) engine.jump();
+    return engine;
+}
+
+std::uint64_t derive_seed(std::uint64_t seed, std::uint64_t seed_index)
+{
+    // splitmix64's state only ever advances by its increment, so its n'th output is direct
+    return splitmix64_mix(seed + (seed_index + 1) * SPLITMIX64_INCREMENT);
+}
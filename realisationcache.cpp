@@ -0,0 +1,34 @@
+#include "realisationcache.hpp"
+
+#include <iterator>
+
+RealisationCache::RealisationCache(const std::vector<Note>& roots)
+{
+    _roots.reserve(roots.size());
+    for (auto&& root : roots)
+    {
+        _roots.emplace_back(root);
+    }
+    _realiser = BatchRealiser{_roots};
+}
+
+void RealisationCache::add_scale(std::span<const Scale::scale_degree> degrees)
+{
+    _realiser.realise(degrees);
+    for (size_t r = 0; r < _roots.size(); ++r)
+    {
+        Entry entry;
+        entry._notes_offset = static_cast<std::uint32_t>(_notes.size());
+        _realiser.write_scale(r, std::back_inserter(_notes));
+        entry._notes_length = static_cast<std::uint32_t>(_notes.size() - entry._notes_offset);
+
+        // Rendered straight into the pooled text, the same as RealisedScale prints
+        entry._text_offset = static_cast<std::uint32_t>(_text.size());
+        PackedRealisedScale::format_notes_to(
+            std::back_inserter(_text),
+            std::span<const PackedNote>{_notes}.subspan(entry._notes_offset));
+        entry._text_length = static_cast<std::uint32_t>(_text.size() - entry._text_offset);
+
+        _entries.push_back(entry);
+    }
+}
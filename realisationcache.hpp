@@ -0,0 +1,187 @@
+#ifndef REALISATIONCACHE
+#define REALISATIONCACHE
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "batchrealiser.hpp"
+#include "musiclibrary.hpp"
+
+/**
+ * @brief Immutable cache of every scale realised on every possible root.
+ *
+ * The domain of questions is closed (every loaded Scale against every possible root), so it can all
+ * be realised and rendered once up front. The notes of all realisations live in one contiguous
+ * vector of PackedNotes and their display strings in one std::string; each realisation is then just
+ * a handful of offsets into those. Handing out a realisation is handing out its index.
+ *
+ * Realisation indices are laid out scale-major: index = scale_index * number_of_roots + root_index.
+ */
+class RealisationCache
+{
+   private:
+    /**
+     * @brief Where a single realisation's data lives in the pooled storage.
+     *
+     */
+    struct Entry
+    {
+        std::uint32_t _notes_offset;
+        std::uint32_t _notes_length;
+        std::uint32_t _text_offset;
+        std::uint32_t _text_length;
+    };
+
+    /**
+     * @brief The roots every scale gets realised on, in the order they were given.
+     *
+     */
+    std::vector<PackedNote> _roots;
+
+    /**
+     * @brief Realises every added scale on all of _roots at once.
+     *
+     */
+    BatchRealiser _realiser;
+
+    /**
+     * @brief Notes of all realisations, back to back.
+     *
+     */
+    std::vector<PackedNote> _notes;
+
+    /**
+     * @brief Display strings of all realisations, back to back.
+     *
+     */
+    std::string _text;
+
+    /**
+     * @brief One Entry per realisation.
+     *
+     */
+    std::vector<Entry> _entries;
+
+   public:
+    /**
+     * @brief Construct a new empty Realisation Cache object
+     *
+     */
+    RealisationCache() = default;
+
+    /**
+     * @brief Construct a new Realisation Cache object that realises scales on the given roots.
+     *
+     * Every root needs a MIDI value and a single spelling (see BatchRealiser); throws
+     * std::invalid_argument otherwise.
+     *
+     * @param roots - reference to the roots every added scale is realised on
+     */
+    explicit RealisationCache(const std::vector<Note>& roots);
+
+    /**
+     * @brief Realises and renders a scale on every root and appends the results.
+     *
+     * The scale gets the next scale index (i.e. scales should be added in the order of their
+     * indices).
+     *
+     * @param scale - reference to the Scale to add
+     */
+    inline void add_scale(const Scale& scale) { add_scale(scale.degrees()); }
+
+    /**
+     * @brief Realises and renders scale degrees on every root and appends the results. See
+     * add_scale(const Scale&).
+     *
+     * @param degrees - the scale degrees of the scale to add
+     */
+    void add_scale(std::span<const Scale::scale_degree> degrees);
+
+    /**
+     * @brief Returns whether no realisations are cached.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool empty() const { return _entries.empty(); }
+
+    /**
+     * @brief Returns the amount of cached realisations.
+     *
+     * @return size_t
+     */
+    inline size_t size() const { return _entries.size(); }
+
+    /**
+     * @brief Returns the amount of roots every scale is realised on.
+     *
+     * @return size_t
+     */
+    inline size_t number_of_roots() const { return _roots.size(); }
+
+    /**
+     * @brief Returns the index of the realisation of a given scale on a given root.
+     *
+     * @param scale_index - index of the scale (in the order the scales were added)
+     * @param root_index - index of the root (in the order the roots were given)
+     * @return size_t
+     */
+    inline size_t index_of(size_t scale_index, size_t root_index) const
+    {
+        return scale_index * _roots.size() + root_index;
+    }
+
+    /**
+     * @brief Returns the index of the scale a realisation belongs to.
+     *
+     * @param index - realisation index
+     * @return size_t
+     */
+    inline size_t scale_index(size_t index) const { return index / _roots.size(); }
+
+    /**
+     * @brief Returns the index of the root a realisation is realised on.
+     *
+     * @param index - realisation index
+     * @return size_t
+     */
+    inline size_t root_index(size_t index) const { return index % _roots.size(); }
+
+    /**
+     * @brief Returns the root a realisation is realised on.
+     *
+     * @param index - realisation index
+     * @return PackedNote
+     */
+    inline PackedNote root(size_t index) const { return _roots[root_index(index)]; }
+
+    /**
+     * @brief Returns the notes of a realisation.
+     *
+     * @param index - realisation index
+     * @return std::span<const PackedNote>
+     */
+    inline std::span<const PackedNote> notes(size_t index) const
+    {
+        const Entry& entry = _entries[index];
+        return {_notes.data() + entry._notes_offset, entry._notes_length};
+    }
+
+    /**
+     * @brief Returns the pre-rendered display string of a realisation (same as printing it as a
+     * RealisedScale).
+     *
+     * @param index - realisation index
+     * @return std::string_view
+     */
+    inline std::string_view text(size_t index) const
+    {
+        const Entry& entry = _entries[index];
+        return std::string_view{_text}.substr(entry._text_offset, entry._text_length);
+    }
+};
+
+#endif
@@ -0,0 +1,267 @@
+#include "resultssink.hpp"
+
+#include <filesystem>
+#include <format>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+constexpr std::string_view COLUMNAR_MAGIC{"SCALERES"};
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * @brief Appends the raw bytes of trivially copyable values to a buffer.
+ *
+ */
+template <typename T>
+void append_raw(std::string& buffer, std::span<const T> values)
+{
+    buffer.append(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+}
+
+/**
+ * @brief Returns what a results file of the format starts with: the csv header line, or the
+ * columnar magic, version and byte order mark.
+ *
+ */
+std::string file_header(ResultsSink::Format format)
+{
+    std::string header;
+    if (format == ResultsSink::Format::CSV)
+    {
+        std::format_to(std::back_inserter(header), "{}\n", RESULTS_FILE_HEADER);
+    }
+    else
+    {
+        header += COLUMNAR_MAGIC;
+        append_raw(header, std::span<const std::uint32_t>{&ResultsSink::COLUMNAR_VERSION, 1});
+        append_raw(header, std::span<const std::uint32_t>{&BYTE_ORDER_MARK, 1});
+    }
+    return header;
+}
+
+/**
+ * @brief Throws an std::runtime_error exception unless the existing file at path starts with
+ * header, so results are never appended to a file of another format or version.
+ *
+ */
+void check_header(const std::string& path, std::string_view header)
+{
+    std::ifstream file{path, std::ios::binary};
+    if (!file.good())
+    {
+        throw std::runtime_error(BAD_FILE_OPEN);
+    }
+    std::string existing(header.size(), '\0');
+    file.read(existing.data(), static_cast<std::streamsize>(existing.size()));
+    if (file.gcount() != static_cast<std::streamsize>(header.size()) || existing != header)
+    {
+        throw std::runtime_error(RESULTS_FORMAT_MISMATCH);
+    }
+}
+}  // namespace
+
+ResultsSink::ResultsSink(const std::string& path) : ResultsSink(path, Options{}) {}
+
+ResultsSink::ResultsSink(const std::string& path, const Options& options) : _options(options)
+{
+    std::error_code error;
+    bool fresh = !_options._append || !std::filesystem::exists(path, error) ||
+                 std::filesystem::file_size(path, error) == 0;
+
+    std::string header = file_header(_options._format);
+    if (!fresh) check_header(path, header);
+
+    _file.open(path, std::ios::binary | (_options._append ? std::ios::app : std::ios::trunc));
+    if (!_file.good())
+    {
+        throw std::runtime_error(BAD_FILE_OPEN);
+    }
+
+    _buffer.reserve(_options._buffer_size);
+    if (fresh) _buffer += header;
+
+    if (_options._asynchronous)
+    {
+        _writer = std::jthread{[this](std::stop_token token) { run_writer(token); }};
+    }
+}
+
+ResultsSink::~ResultsSink()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void ResultsSink::write(const Result& result)
+{
+    if (_options._format == Format::CSV)
+    {
+        std::format_to(std::back_inserter(_buffer), "{} {}{}{}{}{}{}{}\n", result._root_name,
+                       result._scale_name, CSV_SEPERATOR, result._difficulty, CSV_SEPERATOR,
+                       result._correct ? CORRECT : INCORRECT, CSV_SEPERATOR,
+                       result._milliseconds);
+        if (_buffer.size() >= _options._buffer_size) hand_off();
+        return;
+    }
+
+    _difficulties.push_back(result._difficulty);
+    _correct.push_back(result._correct);
+    _milliseconds.push_back(result._milliseconds);
+    _root_names += result._root_name;
+    _root_name_offsets.push_back(static_cast<std::uint32_t>(_root_names.size()));
+    _scale_names += result._scale_name;
+    _scale_name_offsets.push_back(static_cast<std::uint32_t>(_scale_names.size()));
+
+    // Roughly what the block takes once encoded
+    size_t block_size = _difficulties.size() * (2 + 3 * sizeof(std::uint32_t)) +
+                        _root_names.size() + _scale_names.size();
+    if (block_size >= _options._buffer_size)
+    {
+        encode_block();
+        hand_off();
+    }
+}
+
+void ResultsSink::encode_block()
+{
+    if (_difficulties.empty()) return;
+
+    auto rows = static_cast<std::uint32_t>(_difficulties.size());
+    append_raw(_buffer, std::span<const std::uint32_t>{&rows, 1});
+    append_raw(_buffer, std::span<const std::uint8_t>{_difficulties});
+    append_raw(_buffer, std::span<const std::uint8_t>{_correct});
+    append_raw(_buffer, std::span<const std::uint32_t>{_milliseconds});
+    append_raw(_buffer, std::span<const std::uint32_t>{_root_name_offsets});
+    append_raw(_buffer, std::span<const std::uint32_t>{_scale_name_offsets});
+    _buffer += _root_names;
+    _buffer += _scale_names;
+
+    _difficulties.clear();
+    _correct.clear();
+    _milliseconds.clear();
+    _root_name_offsets.assign(1, 0);
+    _scale_name_offsets.assign(1, 0);
+    _root_names.clear();
+    _scale_names.clear();
+}
+
+void ResultsSink::hand_off()
+{
+    if (_buffer.empty()) return;
+
+    if (!_options._asynchronous)
+    {
+        write_to_file(_buffer);
+        _buffer.clear();
+        return;
+    }
+
+    std::unique_lock lock{_mutex};
+    rethrow_writer_error();
+    _pending.push_back(std::move(_buffer));
+
+    // Buffers come back from the writer, so after warming up nothing gets allocated
+    if (_free_buffers.empty())
+    {
+        _buffer = std::string{};
+        _buffer.reserve(_options._buffer_size);
+    }
+    else
+    {
+        _buffer = std::move(_free_buffers.back());
+        _free_buffers.pop_back();
+    }
+    lock.unlock();
+    _cv.notify_all();
+}
+
+void ResultsSink::write_to_file(std::string_view bytes)
+{
+    _file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!_file.good())
+    {
+        throw std::runtime_error(BAD_FILE_OPEN);
+    }
+}
+
+void ResultsSink::run_writer(std::stop_token token)
+{
+    std::unique_lock lock{_mutex};
+    while (true)
+    {
+        // Returns with nothing pending only once a stop has been requested
+        _cv.wait(lock, token, [this]() { return !_pending.empty(); });
+        if (_pending.empty()) return;
+
+        std::string bytes = std::move(_pending.front());
+        _pending.pop_front();
+        _writing = true;
+        lock.unlock();
+
+        try
+        {
+            write_to_file(bytes);
+            _file.flush();
+        }
+        catch (...)
+        {
+            lock.lock();
+            if (!_writer_error) _writer_error = std::current_exception();
+            lock.unlock();
+        }
+
+        bytes.clear();
+        lock.lock();
+        _free_buffers.push_back(std::move(bytes));
+        _writing = false;
+        _cv.notify_all();
+    }
+}
+
+void ResultsSink::rethrow_writer_error()
+{
+    if (_writer_error) std::rethrow_exception(std::exchange(_writer_error, nullptr));
+}
+
+void ResultsSink::flush()
+{
+    if (_options._format == Format::COLUMNAR) encode_block();
+    hand_off();
+
+    if (!_options._asynchronous)
+    {
+        _file.flush();
+        if (!_file.good()) throw std::runtime_error(BAD_FILE_OPEN);
+        return;
+    }
+
+    std::unique_lock lock{_mutex};
+    _cv.wait(lock, [this]() { return _pending.empty() && !_writing; });
+    rethrow_writer_error();
+}
+
+void ResultsSink::close()
+{
+    if (_closed) return;
+    _closed = true;
+
+    flush();
+    if (_writer.joinable())
+    {
+        _writer.request_stop();
+        _writer.join();
+    }
+    _file.close();
+
+    std::unique_lock lock{_mutex};
+    rethrow_writer_error();
+}
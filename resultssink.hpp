@@ -0,0 +1,206 @@
+#ifndef RESULTSSINK
+#define RESULTSSINK
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "constants.hpp"
+
+/**
+ * @brief Buffered writer of session results, as csv or in a binary columnar format.
+ *
+ * Results are formatted into a large userspace buffer, which is only handed to the file once it
+ * is full, on flush and on close; either directly or, in asynchronous mode, through a background
+ * thread so the caller never waits on the disk. In append mode the header is only written if the
+ * file is new or empty, so many sessions can go into a single file; a file that is already there
+ * has to start with the header of the same format and version, or the sink refuses to open it.
+ *
+ * The columnar format, in native byte order, is a header of char[8] magic "SCALERES", u32 version
+ * and u32 byte order mark 0x01020304, followed by blocks of
+ *
+ *     u32 rows, u8 difficulties[rows], u8 correct[rows], u32 milliseconds[rows],
+ *     u32 root name offsets[rows + 1], u32 scale name offsets[rows + 1], char root names[],
+ *     char scale names[]
+ *
+ * where a name i is the characters [offsets[i], offsets[i + 1]) of its block.
+ */
+class ResultsSink
+{
+   public:
+    /**
+     * @brief Enum for representing the output format
+     *
+     */
+    enum class Format
+    {
+        CSV = 0,
+        COLUMNAR
+    };
+
+    /**
+     * @brief Size of the userspace buffer unless set otherwise.
+     *
+     */
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 16;
+
+    /**
+     * @brief Version of the columnar format.
+     *
+     */
+    static constexpr std::uint32_t COLUMNAR_VERSION = 2;
+
+    /**
+     * @brief How a ResultsSink writes.
+     *
+     */
+    struct Options
+    {
+        Format _format = Format::CSV;
+        // Keep what is already in the file and add to it
+        bool _append = false;
+        // Write from a background thread
+        bool _asynchronous = false;
+        // How many bytes are gathered before they are written
+        size_t _buffer_size = DEFAULT_BUFFER_SIZE;
+    };
+
+    /**
+     * @brief A single answered question. The views only have to live until write returns.
+     *
+     */
+    struct Result
+    {
+        std::string_view _root_name;
+        std::string_view _scale_name;
+        std::uint8_t _difficulty;
+        bool _correct;
+        // How long answering took
+        std::uint32_t _milliseconds = 0;
+    };
+
+   private:
+    Options _options;
+    std::ofstream _file;
+
+    /**
+     * @brief Formatted bytes not yet handed to the file.
+     *
+     */
+    std::string _buffer;
+
+    // The columns of the block being gathered in the columnar format
+    std::vector<std::uint8_t> _difficulties;
+    std::vector<std::uint8_t> _correct;
+    std::vector<std::uint32_t> _milliseconds;
+    std::vector<std::uint32_t> _root_name_offsets{0};
+    std::vector<std::uint32_t> _scale_name_offsets{0};
+    std::string _root_names;
+    std::string _scale_names;
+
+    // Everything shared with the background writer
+    std::mutex _mutex;
+    std::condition_variable_any _cv;
+    std::deque<std::string> _pending;
+    std::vector<std::string> _free_buffers;
+    bool _writing = false;
+    std::exception_ptr _writer_error;
+    bool _closed = false;
+
+    /**
+     * @brief The background writer; declared last so it is stopped before anything it uses goes.
+     *
+     */
+    std::jthread _writer;
+
+    /**
+     * @brief Appends the gathered columnar block to _buffer and starts a new one.
+     *
+     */
+    void encode_block();
+
+    /**
+     * @brief Hands _buffer to the file (or the writer) and starts a new one.
+     *
+     */
+    void hand_off();
+
+    /**
+     * @brief Writes bytes into the file. Throws an std::runtime_error exception if that fails.
+     *
+     * @param bytes - the bytes to write
+     */
+    void write_to_file(std::string_view bytes);
+
+    /**
+     * @brief Loop of the background writer; drains everything pending before stopping.
+     *
+     * @param token - stop token of _writer
+     */
+    void run_writer(std::stop_token token);
+
+    /**
+     * @brief Rethrows an error of the background writer, if there was any.
+     *
+     */
+    void rethrow_writer_error();
+
+   public:
+    /**
+     * @brief Construct a new Results Sink object writing csv to a file, replacing its contents.
+     * Throws an std::runtime_error exception if the file cannot be opened.
+     *
+     * @param path - reference to the path of the file to write to
+     */
+    explicit ResultsSink(const std::string& path);
+
+    /**
+     * @brief Construct a new Results Sink object writing to a file. Throws an std::runtime_error
+     * exception if the file cannot be opened, or if it is appended to and holds results of another
+     * format or version.
+     *
+     * @param path - reference to the path of the file to write to
+     * @param options - reference to how to write
+     */
+    ResultsSink(const std::string& path, const Options& options);
+
+    ResultsSink(const ResultsSink&) = delete;
+    ResultsSink& operator=(const ResultsSink&) = delete;
+
+    /**
+     * @brief Destroy the Results Sink object, closing it. Errors are swallowed; call close first
+     * to see them.
+     *
+     */
+    ~ResultsSink();
+
+    /**
+     * @brief Adds a single result to the buffer, writing the buffer out if it is full.
+     *
+     * @param result - reference to the result to add
+     */
+    void write(const Result& result);
+
+    /**
+     * @brief Writes every buffered result to the file and waits until it is written.
+     *
+     */
+    void flush();
+
+    /**
+     * @brief Flushes, stops the background writer and closes the file. Any write error of the
+     * background writer is rethrown here at the latest.
+     *
+     */
+    void close();
+};
+
+#endif
@@ -0,0 +1,370 @@
+#include "scalecatalogue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "constants.hpp"
+#include "parallel.hpp"
+
+// ====COMPILED FORMAT HELPERS====
+namespace
+{
+/**
+ * @brief The fixed size part at the start of a compiled catalogue.
+ *
+ */
+struct CompiledHeader
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t byte_order_mark;
+    std::uint32_t number_of_scales;
+    std::uint32_t number_of_names;
+    std::uint32_t number_of_difficulties;
+    std::uint32_t string_table_size;
+    std::uint64_t number_of_degrees;
+};
+
+static_assert(std::is_trivially_copyable_v<CompiledHeader>);
+static_assert(sizeof(CompiledHeader) == 40, "Compiled header has to have no padding");
+
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * @brief Writes the raw bytes of trivially copyable values.
+ *
+ */
+template <typename T>
+void write_raw(std::ostream& stream, std::span<const T> values)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    stream.write(reinterpret_cast<const char*>(values.data()),
+                 static_cast<std::streamsize>(values.size_bytes()));
+}
+
+/**
+ * @brief Narrows a size to a field of the format, throwing if it does not fit.
+ *
+ */
+template <typename T>
+T checked_narrow(size_t value)
+{
+    if (value > std::numeric_limits<T>::max()) throw std::runtime_error(CANNOT_COMPILE_CATALOGUE);
+    return static_cast<T>(value);
+}
+
+/**
+ * @brief Walks over the sections of a compiled catalogue, checking none runs past the end.
+ *
+ */
+class SectionReader
+{
+   private:
+    std::string_view _bytes;
+
+   public:
+    explicit SectionReader(std::string_view bytes) : _bytes(bytes) {}
+
+    /**
+     * @brief Copies the next count values into output, which is resized to fit.
+     *
+     */
+    template <typename T>
+    void read(std::vector<T>& output, std::uint64_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (count > _bytes.size() / sizeof(T)) throw std::runtime_error(BAD_COMPILED_CATALOGUE);
+        output.resize(static_cast<size_t>(count));
+        std::memcpy(output.data(), _bytes.data(), output.size() * sizeof(T));
+        _bytes.remove_prefix(output.size() * sizeof(T));
+    }
+
+    /**
+     * @brief Takes the next size bytes as they are.
+     *
+     */
+    std::string_view take(size_t size)
+    {
+        if (size > _bytes.size()) throw std::runtime_error(BAD_COMPILED_CATALOGUE);
+        std::string_view taken = _bytes.substr(0, size);
+        _bytes.remove_prefix(size);
+        return taken;
+    }
+
+    inline bool at_end() const { return _bytes.empty(); }
+};
+}  // namespace
+
+void ScaleCatalogue::add(NamePool::NameId name_id, difficulty_value difficulty,
+                         std::span<const Scale::scale_degree> degrees)
+{
+    _name_ids.push_back(name_id);
+    _difficulties.push_back(difficulty);
+    _degree_offsets.push_back(static_cast<std::uint32_t>(_degrees.size()));
+    _degree_lengths.push_back(static_cast<std::uint32_t>(degrees.size()));
+    _degrees.insert(_degrees.end(), degrees.begin(), degrees.end());
+}
+
+std::optional<size_t> ScaleCatalogue::find_duplicate_name() const
+{
+    // Equal names are interned once, so scales with the same name have the same id
+    std::vector<bool> seen(_names.size());
+    for (size_t i = 0; i < _name_ids.size(); ++i)
+    {
+        if (seen[_name_ids[i]]) return i;
+        seen[_name_ids[i]] = true;
+    }
+    return std::nullopt;
+}
+
+void ScaleCatalogue::append(const ScaleCatalogue& other)
+{
+    // Ids of other are in order of first use, so interning them in id order hands out the same ids
+    // as adding the scales of other one by one would
+    std::vector<NamePool::NameId> remapped_ids(other._names.size());
+    for (NamePool::NameId id = 0; id < other._names.size(); ++id)
+    {
+        remapped_ids[id] = intern_name(other._names.view(id));
+    }
+
+    _name_ids.reserve(size() + other.size());
+    for (auto&& id : other._name_ids)
+    {
+        _name_ids.push_back(remapped_ids[id]);
+    }
+
+    auto degree_base = static_cast<std::uint32_t>(_degrees.size());
+    _degree_offsets.reserve(size() + other.size());
+    for (auto&& offset : other._degree_offsets)
+    {
+        _degree_offsets.push_back(degree_base + offset);
+    }
+
+    _difficulties.insert(_difficulties.end(), other._difficulties.begin(),
+                         other._difficulties.end());
+    _degree_lengths.insert(_degree_lengths.end(), other._degree_lengths.begin(),
+                           other._degree_lengths.end());
+    _degrees.insert(_degrees.end(), other._degrees.begin(), other._degrees.end());
+}
+
+// A counting sort: difficulties are few, so this is linear and stable by construction. Every
+// worker counts and then moves a contiguous block of the scales; a worker's scales of a difficulty
+// go after those of all earlier workers, which keeps the order stable.
+void ScaleCatalogue::sort_by_difficulty(size_t number_of_threads)
+{
+    size_t number_of_difficulties =
+        empty() ? 0 : static_cast<size_t>(*std::max_element(_difficulties.begin(),
+                                                            _difficulties.end())) + 1;
+    size_t number_of_workers =
+        std::clamp<size_t>(number_of_threads, 1, std::max<size_t>(size(), 1));
+
+    // Counts of every difficulty per worker, then turned into where each worker starts writing
+    std::vector<std::vector<size_t>> positions(number_of_workers,
+                                               std::vector<size_t>(number_of_difficulties, 0));
+    fork_join(number_of_workers,
+              [&](size_t w)
+              {
+                  auto [first, last] = block_range(size(), number_of_workers, w);
+                  for (size_t i = first; i < last; ++i) ++positions[w][_difficulties[i]];
+              });
+
+    _difficulty_starts.assign(number_of_difficulties + 1, 0);
+    size_t position = 0;
+    for (size_t d = 0; d < number_of_difficulties; ++d)
+    {
+        _difficulty_starts[d] = position;
+        for (auto&& worker_positions : positions)
+        {
+            position += std::exchange(worker_positions[d], position);
+        }
+    }
+    _difficulty_starts[number_of_difficulties] = position;
+
+    // Already in order, e.g. when read from a compiled catalogue
+    if (std::is_sorted(_difficulties.begin(), _difficulties.end())) return;
+
+    // Which scale ends up at every index
+    std::vector<size_t> sources(size());
+    fork_join(number_of_workers,
+              [&](size_t w)
+              {
+                  auto [first, last] = block_range(size(), number_of_workers, w);
+                  for (size_t i = first; i < last; ++i)
+                  {
+                      sources[positions[w][_difficulties[i]]++] = i;
+                  }
+              });
+
+    std::vector<NamePool::NameId> name_ids(size());
+    std::vector<difficulty_value> difficulties(size());
+    std::vector<std::uint32_t> degree_offsets(size());
+    std::vector<std::uint32_t> degree_lengths(size());
+    for (size_t i = 0; i < size(); ++i)
+    {
+        degree_lengths[i] = _degree_lengths[sources[i]];
+    }
+    std::exclusive_scan(degree_lengths.begin(), degree_lengths.end(), degree_offsets.begin(),
+                        std::uint32_t{0});
+
+    // Also repacks the degrees in the new order, so walking the scales in order stays sequential
+    std::vector<Scale::scale_degree> degrees(_degrees.size());
+    fork_join(number_of_workers,
+              [&](size_t w)
+              {
+                  auto [first, last] = block_range(size(), number_of_workers, w);
+                  for (size_t i = first; i < last; ++i)
+                  {
+                      size_t source = sources[i];
+                      name_ids[i] = _name_ids[source];
+                      difficulties[i] = _difficulties[source];
+                      auto source_degrees = this->degrees(source);
+                      std::copy(source_degrees.begin(), source_degrees.end(),
+                                degrees.begin() + degree_offsets[i]);
+                  }
+              });
+
+    _name_ids = std::move(name_ids);
+    _difficulties = std::move(difficulties);
+    _degree_offsets = std::move(degree_offsets);
+    _degree_lengths = std::move(degree_lengths);
+    _degrees = std::move(degrees);
+}
+
+void ScaleCatalogue::clear()
+{
+    _names.clear();
+    _name_ids.clear();
+    _difficulties.clear();
+    _degree_offsets.clear();
+    _degree_lengths.clear();
+    _degrees.clear();
+    _difficulty_starts.clear();
+}
+
+void ScaleCatalogue::write_compiled(std::ostream& stream) const
+{
+    std::vector<std::uint32_t> name_offsets{0};
+    std::string string_table;
+    for (NamePool::NameId id = 0; id < _names.size(); ++id)
+    {
+        string_table += _names.view(id);
+        name_offsets.push_back(checked_narrow<std::uint32_t>(string_table.size()));
+    }
+
+    std::vector<std::uint16_t> scale_degrees;
+    std::vector<std::int16_t> accidentals;
+    scale_degrees.reserve(_degrees.size());
+    accidentals.reserve(_degrees.size());
+    for (auto&& [scale_degree, accidental] : _degrees)
+    {
+        scale_degrees.push_back(checked_narrow<std::uint16_t>(scale_degree));
+        if (accidental < std::numeric_limits<std::int16_t>::min() ||
+            accidental > std::numeric_limits<std::int16_t>::max())
+        {
+            throw std::runtime_error(CANNOT_COMPILE_CATALOGUE);
+        }
+        accidentals.push_back(static_cast<std::int16_t>(accidental));
+    }
+
+    // A catalogue that was never sorted has no ranges, which is only fine if it is empty
+    std::vector<std::uint64_t> difficulty_starts(_difficulty_starts.begin(),
+                                                 _difficulty_starts.end());
+    if (difficulty_starts.empty()) difficulty_starts.push_back(0);
+    if (difficulty_starts.back() != size()) throw std::runtime_error(CANNOT_COMPILE_CATALOGUE);
+
+    CompiledHeader header{};
+    std::copy(COMPILED_MAGIC.begin(), COMPILED_MAGIC.end(), header.magic.begin());
+    header.version = COMPILED_VERSION;
+    header.byte_order_mark = BYTE_ORDER_MARK;
+    header.number_of_scales = checked_narrow<std::uint32_t>(size());
+    header.number_of_names = checked_narrow<std::uint32_t>(_names.size());
+    header.number_of_difficulties = checked_narrow<std::uint32_t>(difficulty_starts.size() - 1);
+    header.string_table_size = checked_narrow<std::uint32_t>(string_table.size());
+    header.number_of_degrees = _degrees.size();
+
+    write_raw(stream, std::span<const CompiledHeader>{&header, 1});
+    write_raw(stream, std::span<const std::uint32_t>{name_offsets});
+    write_raw(stream, std::span<const char>{string_table});
+    write_raw(stream, std::span<const NamePool::NameId>{_name_ids});
+    write_raw(stream, std::span<const difficulty_value>{_difficulties});
+    write_raw(stream, std::span<const std::uint32_t>{_degree_offsets});
+    write_raw(stream, std::span<const std::uint32_t>{_degree_lengths});
+    write_raw(stream, std::span<const std::uint64_t>{difficulty_starts});
+    write_raw(stream, std::span<const std::uint16_t>{scale_degrees});
+    write_raw(stream, std::span<const std::int16_t>{accidentals});
+}
+
+ScaleCatalogue ScaleCatalogue::read_compiled(std::string_view bytes,
+                                             size_t number_of_difficulties)
+{
+    SectionReader reader{bytes};
+
+    CompiledHeader header;
+    std::memcpy(&header, reader.take(sizeof(CompiledHeader)).data(), sizeof(CompiledHeader));
+    if (std::string_view{header.magic.data(), header.magic.size()} != COMPILED_MAGIC ||
+        header.version != COMPILED_VERSION || header.byte_order_mark != BYTE_ORDER_MARK ||
+        header.number_of_difficulties > number_of_difficulties)
+    {
+        throw std::runtime_error(BAD_COMPILED_CATALOGUE);
+    }
+
+    ScaleCatalogue catalogue;
+    std::vector<std::uint32_t> name_offsets;
+    std::vector<std::uint64_t> difficulty_starts;
+    std::vector<std::uint16_t> scale_degrees;
+    std::vector<std::int16_t> accidentals;
+
+    reader.read(name_offsets, std::uint64_t{header.number_of_names} + 1);
+    std::string_view string_table = reader.take(header.string_table_size);
+    reader.read(catalogue._name_ids, header.number_of_scales);
+    reader.read(catalogue._difficulties, header.number_of_scales);
+    reader.read(catalogue._degree_offsets, header.number_of_scales);
+    reader.read(catalogue._degree_lengths, header.number_of_scales);
+    reader.read(difficulty_starts, std::uint64_t{header.number_of_difficulties} + 1);
+    reader.read(scale_degrees, header.number_of_degrees);
+    reader.read(accidentals, header.number_of_degrees);
+    if (!reader.at_end()) throw std::runtime_error(BAD_COMPILED_CATALOGUE);
+
+    // Everything an index is later taken from is checked once here, so a corrupt file cannot
+    // cause out of bounds reads
+    auto bad = [](bool condition)
+    {
+        if (condition) throw std::runtime_error(BAD_COMPILED_CATALOGUE);
+    };
+
+    bad(name_offsets.front() != 0 || name_offsets.back() != header.string_table_size ||
+        !std::is_sorted(name_offsets.begin(), name_offsets.end()));
+    bad(std::any_of(catalogue._name_ids.begin(), catalogue._name_ids.end(),
+                    [&](NamePool::NameId id) { return id >= header.number_of_names; }));
+    for (size_t i = 0; i < header.number_of_scales; ++i)
+    {
+        bad(std::uint64_t{catalogue._degree_offsets[i]} + catalogue._degree_lengths[i] >
+            header.number_of_degrees);
+    }
+    // Every scale is in one of the ranges, so no difficulty is number_of_difficulties or above
+    bad(difficulty_starts.front() != 0 || difficulty_starts.back() != header.number_of_scales ||
+        !std::is_sorted(difficulty_starts.begin(), difficulty_starts.end()));
+    for (size_t d = 0; d < header.number_of_difficulties; ++d)
+    {
+        bad(std::any_of(catalogue._difficulties.begin() + static_cast<long>(difficulty_starts[d]),
+                        catalogue._difficulties.begin() +
+                            static_cast<long>(difficulty_starts[d + 1]),
+                        [d](difficulty_value difficulty) { return difficulty != d; }));
+    }
+
+    catalogue._names.assign(string_table, name_offsets);
+    catalogue._difficulty_starts.assign(difficulty_starts.begin(), difficulty_starts.end());
+    catalogue._degrees.reserve(scale_degrees.size());
+    for (size_t i = 0; i < scale_degrees.size(); ++i)
+    {
+        catalogue._degrees.emplace_back(scale_degrees[i], accidentals[i]);
+    }
+
+    return catalogue;
+}
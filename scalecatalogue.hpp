@@ -0,0 +1,265 @@
+#ifndef SCALECATALOGUE
+#define SCALECATALOGUE
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "musiclibrary.hpp"
+#include "namepool.hpp"
+
+/**
+ * @brief Flat structure-of-arrays storage of every loaded scale.
+ *
+ * Instead of one heap block per scale, names live in a NamePool and all scale degrees are packed
+ * into a single vector, with each scale being an offset and length into it. Any per-scale property
+ * is a plain vector indexed by the scale index, so scales are passed around as indices.
+ *
+ * After sort_by_difficulty the scales are ordered by difficulty (keeping the order in which they
+ * were added otherwise), so the scales of every difficulty form one contiguous index range.
+ *
+ * The same arrays can be written out as a compiled catalogue and read back with a handful of bulk
+ * copies, without parsing anything. The format, in native byte order, is a header
+ *
+ *     char[8] magic "SCALECAT", u32 version, u32 byte order mark 0x01020304,
+ *     u32 scales, u32 names, u32 difficulties, u32 string table size, u64 degrees
+ *
+ * followed by the sections
+ *
+ *     u32 name offsets[names + 1], char string table[string table size], u32 name ids[scales],
+ *     u8 difficulties[scales], u32 degree offsets[scales], u32 degree lengths[scales],
+ *     u64 difficulty starts[difficulties + 1], u16 scale degrees[degrees],
+ *     i16 accidentals[degrees]
+ *
+ * Any change to it has to bump COMPILED_VERSION.
+ */
+class ScaleCatalogue
+{
+   public:
+    /**
+     * @brief Underlying value of a difficulty; ScaleCatalogue itself does not care what they mean.
+     *
+     */
+    using difficulty_value = std::uint8_t;
+
+    /**
+     * @brief First bytes of every compiled catalogue.
+     *
+     */
+    static constexpr std::string_view COMPILED_MAGIC{"SCALECAT"};
+
+    /**
+     * @brief Version of the compiled catalogue format written by write_compiled.
+     *
+     */
+    static constexpr std::uint32_t COMPILED_VERSION = 1;
+
+   private:
+    /**
+     * @brief Arena holding every scale name once.
+     *
+     */
+    NamePool _names;
+
+    /**
+     * @brief Id in _names of the name of every scale.
+     *
+     */
+    std::vector<NamePool::NameId> _name_ids;
+
+    /**
+     * @brief Difficulty of every scale.
+     *
+     */
+    std::vector<difficulty_value> _difficulties;
+
+    /**
+     * @brief Where the degrees of every scale start in _degrees.
+     *
+     */
+    std::vector<std::uint32_t> _degree_offsets;
+
+    /**
+     * @brief How many degrees every scale has.
+     *
+     */
+    std::vector<std::uint32_t> _degree_lengths;
+
+    /**
+     * @brief The degrees of all scales, back to back.
+     *
+     */
+    std::vector<Scale::scale_degree> _degrees;
+
+    /**
+     * @brief First scale index of every difficulty, plus one past the last scale at the end.
+     *
+     * Only describes the catalogue as of the last sort_by_difficulty call.
+     */
+    std::vector<size_t> _difficulty_starts;
+
+   public:
+    /**
+     * @brief Construct a new empty Scale Catalogue object
+     *
+     */
+    ScaleCatalogue() = default;
+
+    /**
+     * @brief Interns a name into the catalogue's pool, so it can be given to add.
+     *
+     * @param name - the name to intern
+     * @return NamePool::NameId
+     */
+    inline NamePool::NameId intern_name(std::string_view name) { return _names.intern(name); }
+
+    /**
+     * @brief Appends a scale at the next index; the difficulty ranges are stale until the next
+     * sort_by_difficulty call.
+     *
+     * @param name_id - id returned by intern_name
+     * @param difficulty - the difficulty of the scale
+     * @param degrees - the scale degrees of the scale, which are copied into the catalogue
+     */
+    void add(NamePool::NameId name_id, difficulty_value difficulty,
+             std::span<const Scale::scale_degree> degrees);
+
+    /**
+     * @brief Appends every scale of other, in order, re-interning the names into this catalogue.
+     *
+     * @param other - reference to the catalogue to append
+     */
+    void append(const ScaleCatalogue& other);
+
+    /**
+     * @brief Stably reorders the scales by difficulty and rebuilds the difficulty ranges.
+     *
+     * Invalidates every scale index handed out before. The result does not depend on the amount
+     * of threads used.
+     *
+     * @param number_of_threads - how many threads to count and move the scales with
+     */
+    void sort_by_difficulty(size_t number_of_threads = 1);
+
+    /**
+     * @brief Writes the catalogue in the compiled format, with the difficulty ranges as of the last
+     * sort_by_difficulty call. Throws an std::runtime_error exception if it does not fit the
+     * format.
+     *
+     * @param stream - reference to the (binary) output stream to write to
+     */
+    void write_compiled(std::ostream& stream) const;
+
+    /**
+     * @brief Returns whether the bytes start like a compiled catalogue.
+     *
+     * @param bytes - view of the file contents
+     * @return true
+     * @return false
+     */
+    static inline bool is_compiled(std::string_view bytes)
+    {
+        return bytes.starts_with(COMPILED_MAGIC);
+    }
+
+    /**
+     * @brief Reads a compiled catalogue. Throws an std::runtime_error exception if the bytes are
+     * not a well-formed catalogue of the current version, or hold more difficulties than asked
+     * for.
+     *
+     * Every section is checked and then copied out in bulk; nothing gets parsed or hashed.
+     *
+     * @param bytes - view of the file contents
+     * @param number_of_difficulties - how many difficulties the caller knows of; every difficulty
+     * read is below it
+     * @return ScaleCatalogue
+     */
+    static ScaleCatalogue read_compiled(std::string_view bytes, size_t number_of_difficulties);
+
+    /**
+     * @brief Removes every scale and name.
+     *
+     */
+    void clear();
+
+    /**
+     * @brief Returns the amount of scales.
+     *
+     * @return size_t
+     */
+    inline size_t size() const { return _difficulties.size(); }
+
+    /**
+     * @brief Returns whether there are no scales.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool empty() const { return _difficulties.empty(); }
+
+    /**
+     * @brief Get the name of a scale, valid for as long as the catalogue lives.
+     *
+     * @param index - the scale index
+     * @return std::string_view
+     */
+    inline std::string_view name(size_t index) const { return _names.view(_name_ids[index]); }
+
+    /**
+     * @brief Get the id of the name of a scale.
+     *
+     * @param index - the scale index
+     * @return NamePool::NameId
+     */
+    inline NamePool::NameId name_id(size_t index) const { return _name_ids[index]; }
+
+    /**
+     * @brief Returns the index of the first scale with the same name as an earlier one, if any.
+     *
+     * @return std::optional<size_t>
+     */
+    std::optional<size_t> find_duplicate_name() const;
+
+    /**
+     * @brief Get the difficulty of a scale.
+     *
+     * @param index - the scale index
+     * @return difficulty_value
+     */
+    inline difficulty_value difficulty(size_t index) const { return _difficulties[index]; }
+
+    /**
+     * @brief Get the scale degrees of a scale.
+     *
+     * @param index - the scale index
+     * @return std::span<const Scale::scale_degree>
+     */
+    inline std::span<const Scale::scale_degree> degrees(size_t index) const
+    {
+        return std::span<const Scale::scale_degree>{_degrees}.subspan(_degree_offsets[index],
+                                                                      _degree_lengths[index]);
+    }
+
+    /**
+     * @brief Get the half-open range of scale indices with the given difficulty, as of the last
+     * sort_by_difficulty call. Difficulties without any scales give an empty range.
+     *
+     * @param difficulty - the difficulty
+     * @return std::pair<size_t, size_t> - first index and one past the last index
+     */
+    inline std::pair<size_t, size_t> difficulty_range(difficulty_value difficulty) const
+    {
+        if (static_cast<size_t>(difficulty) + 1 >= _difficulty_starts.size())
+        {
+            size_t end = _difficulty_starts.empty() ? 0 : _difficulty_starts.back();
+            return {end, end};
+        }
+        return {_difficulty_starts[difficulty], _difficulty_starts[difficulty + 1]};
+    }
+};
+
+#endif
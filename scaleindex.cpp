@@ -0,0 +1,359 @@
+#include "scaleindex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+
+#include "batchrealiser.hpp"
+#include "parallel.hpp"
+
+namespace
+{
+/**
+ * @brief Finaliser of splitmix64, spreading every input bit over the whole result.
+ *
+ * @param x - value to mix
+ * @return std::uint64_t
+ */
+constexpr std::uint64_t mix(std::uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+inline std::uint64_t hash_key(ScaleIndex::pitch_class_mask key) { return mix(key); }
+
+inline std::uint64_t hash_key(std::uint64_t key) { return mix(key); }
+
+inline std::uint64_t hash_key(const ScaleIndex::MidiMask& key)
+{
+    return mix(key._low ^ mix(key._high));
+}
+
+/**
+ * @brief Spellings with up to this many flats or sharps are keyed by a bit, see spelling_bit.
+ *
+ */
+constexpr int MAX_MASKED_ACCIDENTALS = 4;
+
+/**
+ * @brief Returns the bit standing for a spelling in a set of spellings.
+ *
+ * Bit base_degree * 9 + accidentals + 4 covers up to four flats or sharps on every note name root,
+ * which fits exactly into 63 bits; anything beyond that has no bit and gets 0.
+ *
+ * @param spelling - the spelling
+ * @return std::uint64_t
+ */
+inline std::uint64_t spelling_bit(Spelling spelling)
+{
+    int accidentals = spelling.accidentals;
+    if (accidentals < -MAX_MASKED_ACCIDENTALS || accidentals > MAX_MASKED_ACCIDENTALS) return 0;
+    return std::uint64_t{1} << (spelling.base_degree * (2 * MAX_MASKED_ACCIDENTALS + 1) +
+                                static_cast<size_t>(accidentals + MAX_MASKED_ACCIDENTALS));
+}
+
+inline size_t pitch_class(int offset_from_c)
+{
+    int pitch_class = offset_from_c % NOTES_PER_OCTAVE;
+    return static_cast<size_t>(pitch_class < 0 ? pitch_class + NOTES_PER_OCTAVE : pitch_class);
+}
+
+/**
+ * @brief Collects the indices i in [0, count) for which matches(i) holds, in increasing order.
+ *
+ * Every index is written and the count only advances on a match, so the loop has no branch on
+ * the masks.
+ *
+ * @tparam Predicate - callable taking the realisation index
+ * @param count - the amount of realisations
+ * @param matches - which realisations to keep
+ * @return std::vector<std::uint32_t>
+ */
+template <typename Predicate>
+std::vector<std::uint32_t> scan(size_t count, Predicate matches)
+{
+    std::vector<std::uint32_t> result(count);
+    size_t found = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        result[found] = static_cast<std::uint32_t>(i);
+        found += matches(i);
+    }
+    result.resize(found);
+    return result;
+}
+}  // namespace
+
+template <typename Key>
+size_t ScaleIndex::Lookup<Key>::probe(const Key& key) const
+{
+    size_t mask = _slots.size() - 1;
+    size_t slot = hash_key(key) & mask;
+    while (_slots[slot]._count != 0 && !(_slots[slot]._key == key))
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+template <typename Key>
+void ScaleIndex::Lookup<Key>::grow()
+{
+    std::vector<Slot> old_slots(_slots.size() * 2);
+    std::swap(old_slots, _slots);
+    for (auto&& slot : old_slots)
+    {
+        if (slot._count != 0) _slots[probe(slot._key)] = slot;
+    }
+}
+
+template <typename Key>
+void ScaleIndex::Lookup<Key>::build(std::span<const Key> keys)
+{
+    // Sized by the distinct keys rather than the realisations, as catalogues realise the same
+    // notes over and over (most scales are modes of a few others), which keeps the table in cache
+    _slots.assign(16, Slot{});
+    size_t used = 0;
+
+    // Count the realisations of every key first, so each key's run can be laid out contiguously
+    for (auto&& key : keys)
+    {
+        size_t slot = probe(key);
+        if (_slots[slot]._count == 0)
+        {
+            if ((used + 1) * 2 > _slots.size())
+            {
+                grow();
+                slot = probe(key);
+            }
+            _slots[slot]._key = key;
+            ++used;
+        }
+        ++_slots[slot]._count;
+    }
+
+    std::uint32_t first = 0;
+    for (auto&& slot : _slots)
+    {
+        slot._first = first;
+        first += slot._count;
+    }
+
+    _realisations.resize(keys.size());
+    std::vector<std::uint32_t> filled(_slots.size(), 0);
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        size_t slot = probe(keys[i]);
+        _realisations[_slots[slot]._first + filled[slot]++] = static_cast<std::uint32_t>(i);
+    }
+}
+
+template <typename Key>
+std::span<const std::uint32_t> ScaleIndex::Lookup<Key>::find(const Key& key) const
+{
+    if (_slots.empty()) return {};
+    const Slot& slot = _slots[probe(key)];
+    return {_realisations.data() + slot._first, slot._count};
+}
+
+template class ScaleIndex::Lookup<ScaleIndex::pitch_class_mask>;
+template class ScaleIndex::Lookup<ScaleIndex::MidiMask>;
+template class ScaleIndex::Lookup<std::uint64_t>;
+
+ScaleIndex::ScaleIndex(const ScaleCatalogue& catalogue, const std::vector<Note>& roots,
+                       size_t number_of_threads)
+{
+    _roots.reserve(roots.size());
+    for (auto&& root : roots)
+    {
+        _roots.emplace_back(root);
+    }
+
+    size_t total = catalogue.size() * _roots.size();
+    _pitch_classes.resize(total);
+    _spelling_hashes.resize(total);
+    std::vector<MidiMask> midi(total);
+
+    size_t workers = std::clamp<size_t>(catalogue.size() / MIN_PARALLEL_SCALES, 1,
+                                        number_of_threads == 0 ? 1 : number_of_threads);
+    if (workers == 1)
+    {
+        index_scales(catalogue, 0, catalogue.size(), midi);
+    }
+    else
+    {
+        // Every worker writes its own block of realisations, so they never touch the same keys
+        fork_join(workers,
+                  [&](size_t w)
+                  {
+                      auto [first, last] = block_range(catalogue.size(), workers, w);
+                      index_scales(catalogue, first, last, midi);
+                  });
+    }
+
+    _midi_low.resize(total);
+    _midi_high.resize(total);
+    for (size_t i = 0; i < total; ++i)
+    {
+        _midi_low[i] = midi[i]._low;
+        _midi_high[i] = midi[i]._high;
+    }
+
+    _by_pitch_classes.build(_pitch_classes);
+    _by_midi.build(midi);
+    _by_spellings.build(_spelling_hashes);
+}
+
+void ScaleIndex::index_scales(const ScaleCatalogue& catalogue, size_t first, size_t last,
+                              std::span<MidiMask> midi)
+{
+    // Throws for roots without a MIDI value or single spelling, before anything is indexed
+    BatchRealiser realiser{_roots};
+    std::vector<PackedNote> notes;
+    for (size_t s = first; s < last; ++s)
+    {
+        auto degrees = catalogue.degrees(s);
+        realiser.realise(degrees);
+
+        // The keys are gathered straight from the realised lanes, one degree at a time
+        size_t first_index = s * _roots.size();
+        std::span<pitch_class_mask> pitch_classes{_pitch_classes.data() + first_index,
+                                                  _roots.size()};
+        std::span<MidiMask> midi_values = midi.subspan(first_index, _roots.size());
+        std::span<std::uint64_t> spellings{_spelling_hashes.data() + first_index, _roots.size()};
+        std::fill(pitch_classes.begin(), pitch_classes.end(), 0);
+        std::fill(midi_values.begin(), midi_values.end(), MidiMask{});
+        std::fill(spellings.begin(), spellings.end(), 0);
+
+        bool every_spelling_has_a_bit = true;
+        for (size_t d = 0; d < degrees.size(); ++d)
+        {
+            // Same as BatchRealiser::note, the 1st degree is the root itself
+            bool is_root = degrees[d].first == 1;
+            for (size_t r = 0; r < _roots.size(); ++r)
+            {
+                midi_value midi_value = is_root ? _roots[r].get_midi() : realiser.midi(r, d);
+                Spelling spelling =
+                    is_root ? Spelling{_roots[r].get_base_degree(), _roots[r].get_accidentals()}
+                            : realiser.spelling(r, d);
+                pitch_classes[r] |= static_cast<pitch_class_mask>(1u << pitch_class(midi_value));
+                midi_values[r].add(midi_value);
+                std::uint64_t bit = spelling_bit(spelling);
+                spellings[r] |= bit;
+                every_spelling_has_a_bit &= bit != 0;
+            }
+        }
+
+        for (size_t r = 0; r < _roots.size(); ++r)
+        {
+            if (every_spelling_has_a_bit)
+            {
+                spellings[r] = mix(spellings[r]);
+                continue;
+            }
+            notes.clear();
+            realiser.write_scale(r, std::back_inserter(notes));
+            spellings[r] = spellings_hash_of(notes);
+        }
+    }
+}
+
+ScaleIndex::pitch_class_mask ScaleIndex::pitch_classes_of(std::span<const PackedNote> notes)
+{
+    pitch_class_mask mask = 0;
+    for (auto&& note : notes)
+    {
+        int offset;
+        if (note.has_midi())
+        {
+            offset = note.get_midi();
+        }
+        else if (note.has_name())
+        {
+            offset = scale_degree_to_midi_diff[note.get_base_degree()] + note.get_accidentals();
+        }
+        else
+        {
+            continue;
+        }
+        mask |= static_cast<pitch_class_mask>(1u << pitch_class(offset));
+    }
+    return mask;
+}
+
+ScaleIndex::MidiMask ScaleIndex::midi_of(std::span<const PackedNote> notes)
+{
+    MidiMask mask;
+    for (auto&& note : notes)
+    {
+        if (note.has_midi()) mask.add(note.get_midi());
+    }
+    return mask;
+}
+
+std::uint64_t ScaleIndex::spellings_hash_of(std::span<const PackedNote> notes)
+{
+    // The set of spellings as bits dedupes repeats for free
+    std::uint64_t mask = 0;
+    // Spellings without a bit are rare enough to be sorted separately
+    std::vector<std::uint32_t> others;
+    for (auto&& note : notes)
+    {
+        if (!note.has_name()) continue;
+        Spelling spelling{note.get_base_degree(), note.get_accidentals()};
+        std::uint64_t bit = spelling_bit(spelling);
+        if (bit != 0)
+        {
+            mask |= bit;
+        }
+        else
+        {
+            others.push_back(static_cast<std::uint32_t>(spelling.base_degree) << 16 |
+                             static_cast<std::uint16_t>(spelling.accidentals));
+        }
+    }
+
+    std::uint64_t hash = mix(mask);
+    if (others.empty()) return hash;
+
+    std::sort(others.begin(), others.end());
+    others.erase(std::unique(others.begin(), others.end()), others.end());
+    for (auto spelling : others)
+    {
+        hash = mix(hash ^ spelling);
+    }
+    return hash;
+}
+
+std::vector<std::uint32_t> ScaleIndex::find_subsets_of(pitch_class_mask mask) const
+{
+    return scan(size(), [&](size_t i) { return (_pitch_classes[i] & ~mask) == 0; });
+}
+
+std::vector<std::uint32_t> ScaleIndex::find_supersets_of(pitch_class_mask mask) const
+{
+    return scan(size(), [&](size_t i) { return (_pitch_classes[i] & mask) == mask; });
+}
+
+std::vector<std::uint32_t> ScaleIndex::find_subsets_of(const MidiMask& mask) const
+{
+    return scan(size(),
+                [&](size_t i)
+                {
+                    return ((_midi_low[i] & ~mask._low) | (_midi_high[i] & ~mask._high)) == 0;
+                });
+}
+
+std::vector<std::uint32_t> ScaleIndex::find_supersets_of(const MidiMask& mask) const
+{
+    return scan(size(),
+                [&](size_t i)
+                {
+                    return (_midi_low[i] & mask._low) == mask._low &&
+                           (_midi_high[i] & mask._high) == mask._high;
+                });
+}
@@ -0,0 +1,324 @@
+#ifndef SCALEINDEX
+#define SCALEINDEX
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "musiclibrary.hpp"
+#include "scalecatalogue.hpp"
+
+/**
+ * @brief Reverse lookup from a set of notes to the (scale, root) realisations made of them.
+ *
+ * Every loaded scale realised on every possible root gets three keys: the set of its pitch classes
+ * as a 12-bit mask, the set of its MIDI values as a 128-bit mask, and a hash of the set of its
+ * spellings. Each key has a flat open-addressing table pointing at the realisations that have it,
+ * so an exact lookup is a single probe sequence. Subset and superset queries are a bitwise scan
+ * over the contiguous masks of all realisations instead.
+ *
+ * Notes are compared as sets: order and repeats don't matter (a scale with its octave on top has
+ * the same pitch classes as one without). Realisations are numbered as in RealisationCache, i.e.
+ * index = scale_index * number_of_roots + root_index.
+ */
+class ScaleIndex
+{
+   public:
+    /**
+     * @brief Set of pitch classes, bit n standing for n half steps above C.
+     *
+     */
+    using pitch_class_mask = std::uint16_t;
+
+    /**
+     * @brief Set of MIDI values, bit n standing for MIDI value n. Values outside [0, 128) can't be
+     * represented and are left out.
+     *
+     */
+    struct MidiMask
+    {
+        std::uint64_t _low = 0;
+        std::uint64_t _high = 0;
+
+        /**
+         * @brief Adds a MIDI value to the set.
+         *
+         * @param midi - the MIDI value
+         */
+        inline constexpr void add(midi_value midi)
+        {
+            // Scales straddle MIDI value 64 all the time, so which word gets the bit is not
+            // branched on
+            std::uint64_t bit = std::uint64_t{1} << (midi & 63);
+            bool in_range = static_cast<unsigned>(midi) < 128;
+            _low |= bit * (in_range && midi < 64);
+            _high |= bit * (in_range && midi >= 64);
+        }
+
+        friend constexpr bool operator==(const MidiMask&, const MidiMask&) = default;
+    };
+
+    /**
+     * @brief Below this many scales per thread, the index is built on a single thread.
+     *
+     */
+    static constexpr size_t MIN_PARALLEL_SCALES = 1 << 12;
+
+   private:
+    /**
+     * @brief Flat open-addressing multimap from a key to the realisations that have it.
+     *
+     * Built once from every realisation's key and never changed afterwards; the realisations of a
+     * key are stored back to back, so a lookup gives out a span.
+     *
+     * @tparam Key - the key type, hashed with hash_key
+     */
+    template <typename Key>
+    class Lookup
+    {
+       private:
+        struct Slot
+        {
+            Key _key{};
+            std::uint32_t _first = 0;
+            // 0 marks an empty slot
+            std::uint32_t _count = 0;
+        };
+
+        // Power-of-two sized, at most half full
+        std::vector<Slot> _slots;
+        std::vector<std::uint32_t> _realisations;
+
+        /**
+         * @brief Doubles the amount of slots, moving every key to its new slot.
+         *
+         */
+        void grow();
+
+        /**
+         * @brief Returns the slot holding key, or the empty slot where it would go.
+         *
+         * @param key - the key to look for
+         * @return size_t
+         */
+        size_t probe(const Key& key) const;
+
+       public:
+        /**
+         * @brief Builds the table, keys[i] being the key of realisation i.
+         *
+         * @param keys - the key of every realisation
+         */
+        void build(std::span<const Key> keys);
+
+        /**
+         * @brief Returns the realisations with the given key, in increasing order.
+         *
+         * @param key - the key to look up
+         * @return std::span<const std::uint32_t>
+         */
+        std::span<const std::uint32_t> find(const Key& key) const;
+    };
+
+    /**
+     * @brief The roots every scale is realised on, in the order they were given.
+     *
+     */
+    std::vector<PackedNote> _roots;
+
+    /**
+     * @brief Keys of every realisation, indexed by realisation. The MIDI masks are split in two
+     * arrays so the scans go over contiguous words.
+     *
+     */
+    std::vector<pitch_class_mask> _pitch_classes;
+    std::vector<std::uint64_t> _midi_low;
+    std::vector<std::uint64_t> _midi_high;
+    std::vector<std::uint64_t> _spelling_hashes;
+
+    Lookup<pitch_class_mask> _by_pitch_classes;
+    Lookup<MidiMask> _by_midi;
+    Lookup<std::uint64_t> _by_spellings;
+
+    /**
+     * @brief Realises the scales in [first, last) of the catalogue and stores their keys.
+     *
+     * @param catalogue - reference to the catalogue being indexed
+     * @param first - first scale index
+     * @param last - one past the last scale index
+     * @param midi - where to store the MIDI masks of every realisation
+     */
+    void index_scales(const ScaleCatalogue& catalogue, size_t first, size_t last,
+                      std::span<MidiMask> midi);
+
+   public:
+    /**
+     * @brief Construct a new empty Scale Index object
+     *
+     */
+    ScaleIndex() = default;
+
+    /**
+     * @brief Construct a new Scale Index object of every scale in a catalogue realised on every
+     * root.
+     *
+     * Every root needs a MIDI value and a single spelling (see BatchRealiser); throws
+     * std::invalid_argument otherwise.
+     *
+     * @param catalogue - reference to the scales to index, in their current order
+     * @param roots - reference to the roots every scale is realised on
+     * @param number_of_threads - how many threads may realise the scales
+     */
+    ScaleIndex(const ScaleCatalogue& catalogue, const std::vector<Note>& roots,
+               size_t number_of_threads = 1);
+
+    /**
+     * @brief Returns the pitch classes of some notes. Notes without a MIDI value count by their
+     * spelling; notes without either are left out.
+     *
+     * @param notes - the notes
+     * @return pitch_class_mask
+     */
+    static pitch_class_mask pitch_classes_of(std::span<const PackedNote> notes);
+
+    /**
+     * @brief Returns the MIDI values of some notes; notes without one are left out.
+     *
+     * @param notes - the notes
+     * @return MidiMask
+     */
+    static MidiMask midi_of(std::span<const PackedNote> notes);
+
+    /**
+     * @brief Returns the hash of the set of spellings of some notes; notes without one are left
+     * out. Enharmonic notes are spelled by their first spelling.
+     *
+     * @param notes - the notes
+     * @return std::uint64_t
+     */
+    static std::uint64_t spellings_hash_of(std::span<const PackedNote> notes);
+
+    /**
+     * @brief Returns the amount of indexed realisations.
+     *
+     * @return size_t
+     */
+    inline size_t size() const { return _pitch_classes.size(); }
+
+    /**
+     * @brief Returns whether nothing is indexed.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool empty() const { return _pitch_classes.empty(); }
+
+    /**
+     * @brief Returns the amount of roots every scale is realised on.
+     *
+     * @return size_t
+     */
+    inline size_t number_of_roots() const { return _roots.size(); }
+
+    /**
+     * @brief Returns the index of the scale a realisation belongs to.
+     *
+     * @param index - realisation index
+     * @return size_t
+     */
+    inline size_t scale_index(size_t index) const { return index / _roots.size(); }
+
+    /**
+     * @brief Returns the index of the root a realisation is realised on.
+     *
+     * @param index - realisation index
+     * @return size_t
+     */
+    inline size_t root_index(size_t index) const { return index % _roots.size(); }
+
+    /**
+     * @brief Returns the pitch classes of a realisation.
+     *
+     * @param index - realisation index
+     * @return pitch_class_mask
+     */
+    inline pitch_class_mask pitch_classes(size_t index) const { return _pitch_classes[index]; }
+
+    /**
+     * @brief Returns the MIDI values of a realisation.
+     *
+     * @param index - realisation index
+     * @return MidiMask
+     */
+    inline MidiMask midi(size_t index) const { return {_midi_low[index], _midi_high[index]}; }
+
+    /**
+     * @brief Returns the realisations with exactly these pitch classes, in any octave and
+     * spelling.
+     *
+     * @param mask - the pitch classes
+     * @return std::span<const std::uint32_t>
+     */
+    inline std::span<const std::uint32_t> find_pitch_classes(pitch_class_mask mask) const
+    {
+        return _by_pitch_classes.find(mask);
+    }
+
+    /**
+     * @brief Returns the realisations with exactly these MIDI values, in any spelling.
+     *
+     * @param mask - the MIDI values
+     * @return std::span<const std::uint32_t>
+     */
+    inline std::span<const std::uint32_t> find_midi(const MidiMask& mask) const
+    {
+        return _by_midi.find(mask);
+    }
+
+    /**
+     * @brief Returns the realisations spelled with exactly the spellings with this hash (see
+     * spellings_hash_of), in any octave.
+     *
+     * @param hash - hash of the spellings
+     * @return std::span<const std::uint32_t>
+     */
+    inline std::span<const std::uint32_t> find_spellings(std::uint64_t hash) const
+    {
+        return _by_spellings.find(hash);
+    }
+
+    /**
+     * @brief Returns the realisations all of whose pitch classes are in mask, in increasing order.
+     *
+     * @param mask - the pitch classes
+     * @return std::vector<std::uint32_t>
+     */
+    std::vector<std::uint32_t> find_subsets_of(pitch_class_mask mask) const;
+
+    /**
+     * @brief Returns the realisations that contain every pitch class in mask, in increasing order.
+     *
+     * @param mask - the pitch classes
+     * @return std::vector<std::uint32_t>
+     */
+    std::vector<std::uint32_t> find_supersets_of(pitch_class_mask mask) const;
+
+    /**
+     * @brief Returns the realisations all of whose MIDI values are in mask, in increasing order.
+     *
+     * @param mask - the MIDI values
+     * @return std::vector<std::uint32_t>
+     */
+    std::vector<std::uint32_t> find_subsets_of(const MidiMask& mask) const;
+
+    /**
+     * @brief Returns the realisations that contain every MIDI value in mask, in increasing order.
+     *
+     * @param mask - the MIDI values
+     * @return std::vector<std::uint32_t>
+     */
+    std::vector<std::uint32_t> find_supersets_of(const MidiMask& mask) const;
+};
+
+#endif
@@ -2,11 +2,101 @@
 
 #include <algorithm>
 #include <format>
+#include <numeric>
 #include <random>
-#include <set>
+#include <utility>
 
-void ScaleManager::handle_file(const std::string& path)
+#include "defaultcatalogue.hpp"
+#include "mappedfile.hpp"
+#include "parallel.hpp"
+#include "profiler.hpp"
+
+ScaleManager::Snapshot::Snapshot()
+{
+    for (size_t d = 0; d < NUMBER_OF_DIFFICULTIES; ++d)
+    {
+        _root_samplers_by_difficulty[d] = WeightedSampler{_root_note_weights_by_difficulty[d]};
+    }
+}
+
+ScaleManager::ScaleManager() : _snapshot(std::make_shared<const Snapshot>())
+{
+    _root_names.reserve(_possible_roots.size());
+    for (auto&& root : _possible_roots)
+    {
+        _root_names.emplace_back(std::as_const(root).get_name());
+    }
+}
+
+namespace
+{
+/**
+ * @brief Reads a whole file into memory with plain reads. Throws an std::runtime_error exception
+ * if it can't be opened or read.
+ *
+ * @param path - reference to the path of the file to read
+ * @return std::string
+ */
+std::string read_file(const std::string& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    if (!file.good())
+    {
+        throw std::runtime_error(BAD_FILE_OPEN);
+    }
+
+    constexpr size_t CHUNK_SIZE = 1 << 16;
+    std::string contents;
+    while (file)
+    {
+        size_t read = contents.size();
+        contents.resize(read + CHUNK_SIZE);
+        file.read(contents.data() + read, CHUNK_SIZE);
+        contents.resize(read + static_cast<size_t>(file.gcount()));
+    }
+    if (file.bad())
+    {
+        throw std::runtime_error(BAD_FILE_OPEN);
+    }
+    return contents;
+}
+}  // namespace
+
+void ScaleManager::handle_contents(std::string_view contents, size_t number_of_threads,
+                                   ScaleCatalogue& catalogue)
 {
+    if (!ScaleCatalogue::is_compiled(contents))
+    {
+        parse_view(contents, number_of_threads, catalogue);
+    }
+    else if (catalogue.empty())
+    {
+        catalogue = ScaleCatalogue::read_compiled(contents, NUMBER_OF_DIFFICULTIES);
+    }
+    else
+    {
+        catalogue.append(ScaleCatalogue::read_compiled(contents, NUMBER_OF_DIFFICULTIES));
+    }
+}
+
+void ScaleManager::handle_file(const std::string& path, size_t number_of_threads,
+                               ScaleCatalogue& catalogue, bool map_file)
+{
+    SCALES_PROFILE_PHASE(FILE_LOAD);
+    if (!map_file)
+    {
+        handle_contents(read_file(path), number_of_threads, catalogue);
+        return;
+    }
+
+    MappedFile mapped{path};
+    if (mapped.is_mapped())
+    {
+        handle_contents(mapped.view(), number_of_threads, catalogue);
+        return;
+    }
+
+    // Pipes and other non-regular files cannot be mapped, so they are streamed instead
     std::ifstream file;
     file.open(path);
     if (!file.good())
@@ -14,225 +104,542 @@ void ScaleManager::handle_file(const std::string& path)
         throw std::runtime_error(BAD_FILE_OPEN);
     }
 
-    parse_fstream(file);
+    parse_fstream(file, catalogue);
 
     file.close();
 }
 
-void ScaleManager::parse_fstream(std::ifstream& stream)
+void ScaleManager::parse_row(std::string_view line, size_t row, Scale& scale,
+                             ScaleCatalogue& catalogue)
 {
-    std::string line;
-    std::string column_string;
+    NamePool::NameId name_id = 0;
+    ScaleManager::Difficulty difficulty = ScaleManager::Difficulty::EASY;
+
+    // Mirrors std::getline over the line: a trailing separator does not start an empty column
     size_t column = 0;
-    size_t row = 0;
-    // Iterate over all lines
-    while (std::getline(stream, line))
+    while (line.size() > 0)
     {
-        if (row == 0)
-        {
-            ++row;
-            continue;
-        }
-
-        std::stringstream line_stream(line);
-
-        // In each line, iterate over columns
-        std::string name;
-        ScaleManager::Difficulty difficulty;
-        Scale scale;
+        size_t seperator = line.find(CSV_SEPERATOR);
+        std::string_view column_string = line.substr(0, seperator);
+        line.remove_prefix(seperator == std::string_view::npos ? line.size() : seperator + 1);
 
-        column = 0;
-        while (std::getline(line_stream, column_string, CSV_SEPERATOR))
+        switch (column)
         {
-            switch (column)
+            // Reading name, straight into the pool
+            case (0):
             {
-                // Reading name
-                case (0):
+                name_id = catalogue.intern_name(column_string);
+                break;
+            }
+            case (1):
+            {
+                if (column_string == "Easy")
+                {
+                    difficulty = ScaleManager::Difficulty::EASY;
+                }
+                else if (column_string == "Medium")
                 {
-                    name = column_string;
-                    break;
+                    difficulty = ScaleManager::Difficulty::MEDIUM;
                 }
-                case (1):
+                else if (column_string == "Hard")
                 {
-                    if (column_string == "Easy")
-                    {
-                        difficulty = ScaleManager::Difficulty::EASY;
-                    }
-                    else if (column_string == "Medium")
-                    {
-                        difficulty = ScaleManager::Difficulty::MEDIUM;
-                    }
-                    else if (column_string == "Hard")
-                    {
-                        difficulty = ScaleManager::Difficulty::HARD;
-                    }
-                    else
-                    {
-                        throw std::runtime_error(std::format(INVALID_DIFFICULTY, row, column));
-                    }
-                    break;
+                    difficulty = ScaleManager::Difficulty::HARD;
                 }
-                case (2):
+                else
                 {
-                    try
-                    {
-                        scale.clear();
-                        std::istringstream sstream(column_string);
-                        sstream >> scale;
-                    }
-                    catch (std::exception& e)
-                    {
-                        throw std::runtime_error(std::format(FAILED_PARSING_SCALE, row));
-                    }
-                    break;
+                    throw std::runtime_error(std::format(INVALID_DIFFICULTY, row, column));
                 }
+                break;
+            }
+            case (2):
+            {
+                try
+                {
+                    column_string >> scale;
+                }
+                catch (std::exception& e)
+                {
+                    throw std::runtime_error(std::format(FAILED_PARSING_SCALE, row));
+                }
+                break;
             }
-            ++column;
         }
+        ++column;
+    }
+
+    if (column != 3)
+    {
+        throw std::runtime_error(std::format(NOT_ENOUGH_COLUMNS, row));
+    }
+
+    catalogue.add(name_id, static_cast<ScaleCatalogue::difficulty_value>(difficulty),
+                  scale.degrees());
+}
 
-        if (column != 3)
+void ScaleManager::parse_fstream(std::ifstream& stream, ScaleCatalogue& catalogue)
+{
+    std::string line;
+    Scale scale;
+    size_t row = 0;
+    // Iterate over all lines
+    while (std::getline(stream, line))
+    {
+        // Skipping the header
+        if (row != 0)
         {
-            throw std::runtime_error(std::format(NOT_ENOUGH_COLUMNS, row));
+            parse_row(line, row, scale, catalogue);
         }
+        ++row;
+    }
+}
 
-        _scale_names.emplace_back(name);
-        _entries.push_back(
-            std::make_shared<ScaleManager::ScaleEntry<Scale>>(scale, difficulty, name));
+void ScaleManager::parse_lines(std::string_view lines, size_t first_row,
+                               ScaleCatalogue& catalogue)
+{
+    Scale scale;
+    size_t row = first_row;
+    // Iterate over all lines, split the same way std::getline would
+    while (lines.size() > 0)
+    {
+        size_t newline = lines.find('\n');
+        std::string_view line = lines.substr(0, newline);
+        lines.remove_prefix(newline == std::string_view::npos ? lines.size() : newline + 1);
+
+        // Skipping the header
+        if (row != 0)
+        {
+            parse_row(line, row, scale, catalogue);
+        }
         ++row;
     }
 }
 
-void ScaleManager::build_maps()
+void ScaleManager::parse_view(std::string_view contents, size_t number_of_threads,
+                              ScaleCatalogue& catalogue)
 {
-    for (auto&& entry : _entries)
+    size_t number_of_chunks =
+        std::clamp<size_t>(contents.size() / MIN_PARALLEL_CHUNK_SIZE, 1, number_of_threads);
+    if (number_of_chunks <= 1)
+    {
+        parse_lines(contents, 0, catalogue);
+        return;
+    }
+
+    // Chunk boundaries are moved forward to just past the next line break
+    std::vector<size_t> bounds(number_of_chunks + 1, contents.size());
+    bounds[0] = 0;
+    for (size_t c = 1; c < number_of_chunks; ++c)
     {
-        _difficulty_map.emplace((*entry).get_difficulty(), entry);
+        size_t newline = contents.find('\n', std::max(c * contents.size() / number_of_chunks,
+                                                      bounds[c - 1]));
+        bounds[c] = newline == std::string_view::npos ? contents.size() : newline + 1;
+    }
+    auto chunk = [&](size_t c) { return contents.substr(bounds[c], bounds[c + 1] - bounds[c]); };
+
+    // Every chunk but the last ends in a line break, so these give the row of each chunk's start
+    std::vector<size_t> first_rows(number_of_chunks, 0);
+    fork_join(number_of_chunks - 1,
+              [&](size_t c)
+              {
+                  auto lines = chunk(c);
+                  first_rows[c + 1] = static_cast<size_t>(std::count(lines.begin(), lines.end(),
+                                                                     '\n'));
+              });
+    std::partial_sum(first_rows.begin(), first_rows.end(), first_rows.begin());
+
+    // The first error of the file is in the earliest failing chunk, which fork_join rethrows
+    std::vector<ScaleCatalogue> partials(number_of_chunks);
+    fork_join(number_of_chunks,
+              [&](size_t c) { parse_lines(chunk(c), first_rows[c], partials[c]); });
+
+    for (auto&& partial : partials)
+    {
+        catalogue.append(partial);
     }
 }
 
-void ScaleManager::load_scales_from_file(const std::string& path)
+void ScaleManager::Snapshot::build_maps(size_t number_of_threads)
 {
-    handle_file(path);
-    build_maps();
+    SCALES_PROFILE_PHASE(BUILD_MAPS);
+    _catalogue.sort_by_difficulty(number_of_threads);
+
+    std::vector<double> weights(_catalogue.size());
+    for (size_t max_difficulty = 0; max_difficulty < NUMBER_OF_DIFFICULTIES; ++max_difficulty)
+    {
+        auto scale_weights = difficulty_weights(max_difficulty);
+        std::fill(weights.begin(), weights.end(), 0.0);
+        for (size_t d = 0; d <= max_difficulty; ++d)
+        {
+            auto [first, last] =
+                _catalogue.difficulty_range(static_cast<ScaleCatalogue::difficulty_value>(d));
+            std::fill(weights.begin() + static_cast<long>(first),
+                      weights.begin() + static_cast<long>(last), scale_weights[d]);
+        }
+
+        _scale_samplers_by_difficulty[max_difficulty] = WeightedSampler{weights};
+    }
 }
 
-std::vector<std::shared_ptr<ScaleManager::ScaleEntry<Scale>>> ScaleManager::get_random_scales(
-    size_t number_of_scales)
+std::array<double, ScaleManager::NUMBER_OF_DIFFICULTIES>
+ScaleManager::Snapshot::difficulty_weights(size_t max_difficulty) const
 {
-    if (number_of_scales > _entries.size())
+    std::array<std::pair<size_t, size_t>, NUMBER_OF_DIFFICULTIES> ranges;
+    for (size_t d = 0; d < NUMBER_OF_DIFFICULTIES; ++d)
     {
-        throw std::invalid_argument(TOO_MANY_SAMPLES);
+        ranges[d] = _catalogue.difficulty_range(static_cast<ScaleCatalogue::difficulty_value>(d));
     }
 
-    std::vector<std::shared_ptr<ScaleEntry<Scale>>> pointers;
-    pointers.reserve(_entries.size());
+    // Difficulties without any scales present are left out, so they never get picked
+    size_t present_difficulties = static_cast<size_t>(
+        std::count_if(ranges.begin(), ranges.begin() + max_difficulty + 1,
+                      [](auto range) { return range.second > range.first; }));
 
-    // Fill with pointers
-    for (auto& entry : _entries)
+    std::array<double, NUMBER_OF_DIFFICULTIES> weights{};
+    for (size_t d = 0; d <= max_difficulty; ++d)
     {
-        pointers.push_back(entry);
+        auto [first, last] = ranges[d];
+        if (last > first)
+        {
+            weights[d] = 1.0 / static_cast<double>(present_difficulties * (last - first));
+        }
     }
+    return weights;
+}
 
-    std::vector<std::shared_ptr<ScaleEntry<Scale>>> result;
-    result.reserve(number_of_scales);
+void ScaleManager::load_scales_from_file(const std::string& path, bool build_realisation_cache,
+                                         size_t number_of_threads, bool build_scale_index)
+{
+    std::lock_guard lock{_load_mutex};
+    auto next = extend_current();
+    handle_file(path, number_of_threads, next->_catalogue);
+    finish_loading(std::move(next), build_realisation_cache, number_of_threads, build_scale_index);
+}
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
+void ScaleManager::reload_scales_from_file(const std::string& path, bool build_realisation_cache,
+                                           size_t number_of_threads, bool build_scale_index)
+{
+    std::lock_guard lock{_load_mutex};
+    auto next = std::make_shared<Snapshot>();
+    // Whatever replaces or rewrites the file while it is read, a copy can't fault like a mapping
+    handle_file(path, number_of_threads, next->_catalogue, false);
+    validate(*next);
+    finish_loading(std::move(next), build_realisation_cache, number_of_threads, build_scale_index);
+}
 
-    // Sample n pointers into result
-    // Using the std::ranges sampling method
-    std::ranges::sample(pointers, std::back_inserter(result), static_cast<long>(number_of_scales),
-                        gen);
+void ScaleManager::load_default_scales(bool build_realisation_cache, size_t number_of_threads,
+                                       bool build_scale_index)
+{
+    std::lock_guard lock{_load_mutex};
+    auto next = extend_current();
+    {
+        SCALES_PROFILE_PHASE(FILE_LOAD);
+        if (next->_catalogue.empty())
+        {
+            next->_catalogue = DefaultCatalogue::build();
+        }
+        else
+        {
+            next->_catalogue.append(DefaultCatalogue::build());
+        }
+    }
+    finish_loading(std::move(next), build_realisation_cache, number_of_threads, build_scale_index);
+}
 
-    return result;
+void ScaleManager::load_catalogue(ScaleCatalogue catalogue, bool build_realisation_cache,
+                                  size_t number_of_threads, bool build_scale_index)
+{
+    std::lock_guard lock{_load_mutex};
+    auto next = extend_current();
+    if (next->_catalogue.empty())
+    {
+        next->_catalogue = std::move(catalogue);
+    }
+    else
+    {
+        next->_catalogue.append(catalogue);
+    }
+    finish_loading(std::move(next), build_realisation_cache, number_of_threads, build_scale_index);
 }
 
-std::vector<std::shared_ptr<ScaleManager::ScaleEntry<Scale>>>
-ScaleManager::get_random_scales_by_difficulty(size_t number_of_scales,
-                                              ScaleManager::Difficulty difficulty)
+std::shared_ptr<ScaleManager::Snapshot> ScaleManager::extend_current() const
 {
-    std::vector<std::shared_ptr<ScaleManager::ScaleEntry<Scale>>> sampled_scales;
+    // Only the scales are carried over; whatever was built from them is stale once more are added.
+    // Catalogues can't be copied (their names are pooled), but appending to an empty one is a copy
+    auto next = std::make_shared<Snapshot>();
+    next->_catalogue.append(snapshot()->_catalogue);
+    return next;
+}
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
+void ScaleManager::validate(const Snapshot& snapshot)
+{
+    if (snapshot.number_of_scales() < NUMBER_OF_CHOICES)
+    {
+        throw std::runtime_error(NOT_ENOUGH_SCALES_FOR_CHOICES);
+    }
+    // Easy questions can only ever be about easy scales
+    const ScaleCatalogue& catalogue = snapshot._catalogue;
+    bool has_easy_scales = false;
+    for (size_t i = 0; i < catalogue.size() && !has_easy_scales; ++i)
+    {
+        has_easy_scales = catalogue.difficulty(i) ==
+                          static_cast<ScaleCatalogue::difficulty_value>(Difficulty::EASY);
+    }
+    if (!has_easy_scales)
+    {
+        throw std::runtime_error(NO_EASY_SCALES);
+    }
+}
 
-    std::discrete_distribution<size_t> diff_dist(static_cast<size_t>(difficulty) + 1, 0,
-                                                 static_cast<size_t>(difficulty),
-                                                 [](double) { return 1.0; });
+void ScaleManager::finish_loading(std::shared_ptr<Snapshot> next, bool build_realisation_cache,
+                                  size_t number_of_threads, bool build_scale_index)
+{
+    // Options are told apart by scale index, so two scales with one name could look the same
+    if (auto duplicate = next->_catalogue.find_duplicate_name(); duplicate.has_value())
+    {
+        throw std::runtime_error(
+            std::format(DUPLICATE_SCALE_NAME, next->_catalogue.name(duplicate.value())));
+    }
+    next->build_maps(number_of_threads);
+    if (build_realisation_cache) next->build_realisation_cache();
+    if (build_scale_index) next->build_scale_index(number_of_threads);
+    // Sessions that started from the old snapshot keep it alive until they end
+    _snapshot.store(std::move(next), std::memory_order_release);
+}
+
+void ScaleManager::save_compiled_catalogue(const std::string& path) const
+{
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if (!file.good())
+    {
+        throw std::runtime_error(BAD_FILE_OPEN);
+    }
+
+    snapshot()->_catalogue.write_compiled(file);
+    if (!file.good())
+    {
+        throw std::runtime_error(BAD_FILE_OPEN);
+    }
+}
 
-    std::vector<size_t> diff_counts{_difficulty_map.count(ScaleManager::Difficulty::EASY),
-                                    _difficulty_map.count(ScaleManager::Difficulty::MEDIUM),
-                                    _difficulty_map.count(ScaleManager::Difficulty::HARD)};
+void ScaleManager::build_realisation_cache()
+{
+    std::lock_guard lock{_load_mutex};
+    auto previous = snapshot();
+    auto next = extend_current();
+    // Appending leaves the difficulty ranges to be found again, which is linear once sorted
+    next->build_maps();
+    next->_scale_index = previous->_scale_index;
+    next->build_realisation_cache();
+    _snapshot.store(std::move(next), std::memory_order_release);
+}
 
-    // In this method we have to the sampling more manually, as std::ranges::sample does not support
-    // weighted sampling.
+void ScaleManager::build_scale_index(size_t number_of_threads)
+{
+    std::lock_guard lock{_load_mutex};
+    auto previous = snapshot();
+    auto next = extend_current();
+    next->build_maps(number_of_threads);
+    next->_realisation_cache = previous->_realisation_cache;
+    next->build_scale_index(number_of_threads);
+    _snapshot.store(std::move(next), std::memory_order_release);
+}
 
-    std::vector<size_t> sampled_difficulties;
-    for (size_t i = 0; i < number_of_scales; ++i)
+void ScaleManager::Snapshot::build_realisation_cache()
+{
+    SCALES_PROFILE_PHASE(REALISATION);
+    RealisationCache cache{_possible_roots};
+    for (size_t i = 0; i < _catalogue.size(); ++i)
     {
-        // Logic to prevent sampling a difficulty without any scales present
-        size_t sampled_difficulty;
-        bool sampled = false;
-        while (!sampled || diff_counts[sampled_difficulty] == 0)
-        {
-            sampled_difficulty = diff_dist(gen);
-            sampled = true;
-        }
-        sampled_difficulties.emplace_back(sampled_difficulty);
+        cache.add_scale(_catalogue.degrees(i));
     }
+    _realisation_cache = std::move(cache);
+}
 
-    std::vector<std::discrete_distribution<size_t>> individual_difficulty_distributions;
-    for (auto&& diff_count : diff_counts)
+void ScaleManager::Snapshot::build_scale_index(size_t number_of_threads)
+{
+    SCALES_PROFILE_PHASE(REALISATION);
+    _scale_index.emplace(_catalogue, _possible_roots, number_of_threads);
+}
+
+std::vector<size_t> ScaleManager::get_random_scales(size_t number_of_scales)
+{
+    size_t loaded_scales = snapshot()->number_of_scales();
+    if (number_of_scales > loaded_scales)
     {
-        individual_difficulty_distributions.emplace_back(
-            diff_count, (double)0, (double)(diff_count - 1), [](double) { return 1.0; });
+        throw std::invalid_argument(TOO_MANY_SAMPLES);
     }
 
-    for (auto&& d : sampled_difficulties)
+    std::vector<size_t> indices(loaded_scales);
+    std::iota(indices.begin(), indices.end(), 0);
+
+    std::vector<size_t> result;
+    result.reserve(number_of_scales);
+
+    // Sample n indices into result
+    // Using the std::ranges sampling method
+    std::ranges::sample(indices, std::back_inserter(result), static_cast<long>(number_of_scales),
+                        _engine);
+
+    return result;
+}
+
+std::vector<size_t> ScaleManager::Snapshot::sample_scale_indices_by_difficulty(
+    size_t number_of_scales, ScaleManager::Difficulty difficulty, RandomEngine& gen) const
+{
+    SCALES_PROFILE_PHASE(SCALE_SAMPLING);
+    std::vector<size_t> sampled_scales;
+    sampled_scales.reserve(number_of_scales);
+
+    for (size_t i = 0; i < number_of_scales; ++i)
     {
-        auto scales_for_d = _difficulty_map.equal_range(static_cast<ScaleManager::Difficulty>(d));
-        auto chosen_scale_in_diff = individual_difficulty_distributions[d](gen);
-        std::advance(scales_for_d.first, chosen_scale_in_diff);
-        sampled_scales.push_back(scales_for_d.first->second);
+        sampled_scales.push_back(sample_scale_index(difficulty, gen));
     }
 
     return sampled_scales;
 }
 
-std::vector<Note*> ScaleManager::get_random_roots_by_difficulty(size_t number_of_roots,
-                                                                ScaleManager::Difficulty difficulty)
+std::vector<size_t> ScaleManager::get_random_scales_by_difficulty(
+    size_t number_of_scales, ScaleManager::Difficulty difficulty)
 {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    auto pinned = snapshot();
+    return pinned->sample_scale_indices_by_difficulty(number_of_scales, difficulty, _engine);
+}
+
+std::vector<size_t> ScaleManager::Snapshot::sample_root_indices_by_difficulty(
+    size_t number_of_roots, ScaleManager::Difficulty difficulty, RandomEngine& gen) const
+{
+    SCALES_PROFILE_PHASE(ROOT_SAMPLING);
+    std::vector<size_t> sampled_indices;
+    sampled_indices.reserve(number_of_roots);
+
+    for (size_t i = 0; i < number_of_roots; ++i)
+    {
+        sampled_indices.push_back(sample_root_index(difficulty, gen));
+    }
 
-    std::discrete_distribution<size_t> root_note_dist(
-        _possible_roots.size(), 0, _possible_roots.size() - 1, [difficulty](size_t i)
-        { return _root_note_weights_by_difficulty[static_cast<size_t>(difficulty)][i]; });
+    return sampled_indices;
+}
 
+std::vector<Note*> ScaleManager::get_random_roots_by_difficulty(size_t number_of_roots,
+                                                                ScaleManager::Difficulty difficulty)
+{
     std::vector<Note*> sampled_notes;
+    sampled_notes.reserve(number_of_roots);
 
-    for (size_t i = 0; i < number_of_roots; ++i)
+    auto pinned = snapshot();
+    for (auto&& index :
+         pinned->sample_root_indices_by_difficulty(number_of_roots, difficulty, _engine))
     {
-        size_t sampled_index = root_note_dist(gen);
-        sampled_notes.push_back(&_possible_roots[sampled_index]);
+        sampled_notes.push_back(&_possible_roots[index]);
     }
 
     return sampled_notes;
 }
 
+ScaleManager::ScaleEntry<RealisedScale> ScaleManager::Snapshot::realise_entry(
+    size_t scale_index, size_t root_index, const RealisedScale::allocator_type& alloc) const
+{
+    SCALES_PROFILE_PHASE(REALISATION);
+    // Moving the scale into the entry keeps its allocator, so nothing is copied
+    return {RealisedScale{_possible_roots[root_index], _catalogue.degrees(scale_index), alloc},
+            static_cast<Difficulty>(_catalogue.difficulty(scale_index)),
+            _catalogue.name(scale_index)};
+}
+
+size_t ScaleManager::Snapshot::sample_options(size_t correct_index,
+                                              std::span<std::uint32_t, NUMBER_OF_CHOICES> options,
+                                              RandomEngine& gen) const
+{
+    SCALES_PROFILE_PHASE(DISTRACTOR_SELECTION);
+    if (_catalogue.size() < NUMBER_OF_CHOICES)
+    {
+        throw std::runtime_error(NOT_ENOUGH_SCALES_FOR_CHOICES);
+    }
+
+    // Draws from every index except correct_index, by drawing from one fewer and skipping over it
+    std::uniform_int_distribution<size_t> other_dist(0, _catalogue.size() - 2);
+
+    options[0] = static_cast<std::uint32_t>(correct_index);
+    for (size_t chosen = 1; chosen < NUMBER_OF_CHOICES; ++chosen)
+    {
+        std::uint32_t candidate;
+        do
+        {
+            size_t drawn = other_dist(gen);
+            candidate = static_cast<std::uint32_t>(drawn >= correct_index ? drawn + 1 : drawn);
+        } while (std::find(options.begin() + 1, options.begin() + chosen, candidate) !=
+                 options.begin() + chosen);
+        options[chosen] = candidate;
+    }
+
+    // The other options already come in random order, so moving the correct one to a random
+    // position is enough to shuffle them all
+    size_t correct_position = std::uniform_int_distribution<size_t>(0, NUMBER_OF_CHOICES - 1)(gen);
+    std::swap(options[0], options[correct_position]);
+
+    return correct_position;
+}
+
 std::vector<ScaleManager::ScaleEntry<RealisedScale>>
 ScaleManager::generate_realised_scales_by_difficulty(size_t number_of_scales,
                                                      ScaleManager::Difficulty difficulty)
 {
-    auto scales = get_random_scales_by_difficulty(number_of_scales, difficulty);
-    auto roots = get_random_roots_by_difficulty(number_of_scales, difficulty);
+    return generate_realised_scales_by_difficulty(number_of_scales, difficulty, _engine);
+}
+
+std::vector<ScaleManager::ScaleEntry<RealisedScale>>
+ScaleManager::generate_realised_scales_by_difficulty(size_t number_of_scales,
+                                                     ScaleManager::Difficulty difficulty,
+                                                     RandomEngine& gen) const
+{
+    auto pinned = snapshot();
+    return pinned->generate_realised_scales_by_difficulty(number_of_scales, difficulty, gen);
+}
+
+std::vector<ScaleManager::ScaleEntry<RealisedScale>>
+ScaleManager::Snapshot::generate_realised_scales_by_difficulty(size_t number_of_scales,
+                                                               ScaleManager::Difficulty difficulty,
+                                                               RandomEngine& gen) const
+{
+    auto scales = sample_scale_indices_by_difficulty(number_of_scales, difficulty, gen);
+    auto roots = sample_root_indices_by_difficulty(number_of_scales, difficulty, gen);
 
     std::vector<ScaleManager::ScaleEntry<RealisedScale>> output;
+    output.reserve(number_of_scales);
     for (size_t i = 0; i < number_of_scales; ++i)
     {
-        output.emplace_back(RealisedScale{*roots[i], scales[i]->get_scale()},
-                            scales[i]->get_difficulty(), scales[i]->get_name());
+        output.emplace_back(realise_entry(scales[i], roots[i]));
     }
 
     return output;
+}
+
+std::vector<size_t> ScaleManager::generate_cached_realisations_by_difficulty(
+    size_t number_of_scales, ScaleManager::Difficulty difficulty)
+{
+    return generate_cached_realisations_by_difficulty(number_of_scales, difficulty, _engine);
+}
+
+std::vector<size_t> ScaleManager::generate_cached_realisations_by_difficulty(
+    size_t number_of_scales, ScaleManager::Difficulty difficulty, RandomEngine& gen) const
+{
+    auto pinned = snapshot();
+    return pinned->generate_cached_realisations_by_difficulty(number_of_scales, difficulty, gen);
+}
+
+std::vector<size_t> ScaleManager::Snapshot::generate_cached_realisations_by_difficulty(
+    size_t number_of_scales, ScaleManager::Difficulty difficulty, RandomEngine& gen) const
+{
+    const RealisationCache& cache = get_realisation_cache();
+
+    auto scales = sample_scale_indices_by_difficulty(number_of_scales, difficulty, gen);
+    auto roots = sample_root_indices_by_difficulty(number_of_scales, difficulty, gen);
+
+    // Reusing the scale index vector for the output
+    for (size_t i = 0; i < number_of_scales; ++i)
+    {
+        scales[i] = cache.index_of(scales[i], roots[i]);
+    }
+
+    return scales;
 }
\ No newline at end of file
@@ -1,17 +1,35 @@
 #ifndef SCALEMANAGER
 #define SCALEMANAGER
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <fstream>
-#include <map>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 
 #include "constants.hpp"
 #include "musiclibrary.hpp"
+#include "randomengine.hpp"
+#include "realisationcache.hpp"
+#include "scalecatalogue.hpp"
+#include "scaleindex.hpp"
+#include "weightedsampler.hpp"
 
 /**
  * @brief Class responsible for handling the loading of scales and generating questions
  *
+ * The loaded scales are published as an immutable Snapshot. Every load builds a new snapshot off
+ * to the side and swaps it in atomically, so sessions can keep being generated on any number of
+ * threads, without taking any lock, while the scales are reloaded (see reload_scales_from_file).
+ *
+ * Every loaded scale needs a name of its own: the options of a question are told apart by scale
+ * index, so two scales sharing a name could show the same answer twice. Loads throw if they do.
  */
 class ScaleManager
 {
@@ -27,20 +45,33 @@ class ScaleManager
         HARD
     };
 
+    /**
+     * @brief The amount of values in Difficulty
+     *
+     */
+    static constexpr size_t NUMBER_OF_DIFFICULTIES = 3;
+
    private:
     /**
      * @brief Templated structure for holding information about a scale and its associated name and
      * difficulty
      *
+     * Allocator-aware: the alloc overloads construct the scale with std::make_obj_using_allocator,
+     * so an allocator-aware T (i.e. RealisedScale) is allocated with it and any other T ignores it.
+     *
      * @tparam T generally reserved for Scale and RealisedScale
      */
     template <typename T>
     struct ScaleEntry
     {
+       public:
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
        private:
         T _scale;
         ScaleManager::Difficulty _difficulty;
-        std::string _name;
+        // Points into the ScaleCatalogue of the Snapshot, so entries never copy the characters
+        std::string_view _name;
 
        public:
         /**
@@ -48,10 +79,10 @@ class ScaleManager
          *
          * @param scale - reference to an object we want to copy into this entry
          * @param difficulty - the difficulty we want to associate with this entry
-         * @param name - reference to the name associated with this entry (is copied)
+         * @param name - view of the interned name associated with this entry
          */
         inline ScaleEntry(const T& scale, const ScaleManager::Difficulty& difficulty,
-                          const std::string& name)
+                          std::string_view name)
             : _scale(scale), _difficulty(difficulty), _name(name)
         {
         }
@@ -61,10 +92,69 @@ class ScaleManager
          *
          * @param scale - object we want to steal for this entry
          * @param difficulty - the difficulty we want to associate with this entry
-         * @param name - name associated with this entry (is stolen)
+         * @param name - view of the interned name associated with this entry
+         */
+        inline ScaleEntry(T&& scale, ScaleManager::Difficulty&& difficulty, std::string_view name)
+            : _scale(std::move(scale)), _difficulty(std::move(difficulty)), _name(name)
+        {
+        }
+
+        /**
+         * @brief Construct a new Scale Entry object (copying), allocating with alloc
+         *
+         * @param scale - reference to an object we want to copy into this entry
+         * @param difficulty - the difficulty we want to associate with this entry
+         * @param name - view of the interned name associated with this entry
+         * @param alloc - allocator for the scale
+         */
+        inline ScaleEntry(const T& scale, const ScaleManager::Difficulty& difficulty,
+                          std::string_view name, const allocator_type& alloc)
+            : _scale(std::make_obj_using_allocator<T>(alloc, scale)),
+              _difficulty(difficulty),
+              _name(name)
+        {
+        }
+
+        /**
+         * @brief Construct a new Scale Entry object (stealing), allocating with alloc
+         *
+         * @param scale - object we want to steal for this entry
+         * @param difficulty - the difficulty we want to associate with this entry
+         * @param name - view of the interned name associated with this entry
+         * @param alloc - allocator for the scale
+         */
+        inline ScaleEntry(T&& scale, ScaleManager::Difficulty&& difficulty, std::string_view name,
+                          const allocator_type& alloc)
+            : _scale(std::make_obj_using_allocator<T>(alloc, std::move(scale))),
+              _difficulty(std::move(difficulty)),
+              _name(name)
+        {
+        }
+
+        ScaleEntry(const ScaleEntry&) = default;
+        ScaleEntry(ScaleEntry&&) = default;
+        ScaleEntry& operator=(const ScaleEntry&) = default;
+        ScaleEntry& operator=(ScaleEntry&&) = default;
+
+        /**
+         * @brief Construct a new Scale Entry object copying other, allocating with alloc
+         *
+         * @param other - reference to the entry to copy
+         * @param alloc - allocator for the scale
+         */
+        inline ScaleEntry(const ScaleEntry& other, const allocator_type& alloc)
+            : ScaleEntry(other._scale, other._difficulty, other._name, alloc)
+        {
+        }
+
+        /**
+         * @brief Construct a new Scale Entry object moving other, allocating with alloc
+         *
+         * @param other - reference to the entry to move
+         * @param alloc - allocator for the scale
          */
-        inline ScaleEntry(T&& scale, ScaleManager::Difficulty&& difficulty, std::string&& name)
-            : _scale(std::move(scale)), _difficulty(std::move(difficulty)), _name(std::move(name))
+        inline ScaleEntry(ScaleEntry&& other, const allocator_type& alloc)
+            : ScaleEntry(std::move(other._scale), std::move(other._difficulty), other._name, alloc)
         {
         }
 
@@ -83,37 +173,13 @@ class ScaleManager
         inline const ScaleManager::Difficulty& get_difficulty() const { return _difficulty; }
 
         /**
-         * @brief Get the scale name string
+         * @brief Get the scale name, valid for as long as the Snapshot it came from
          *
-         * @return const std::string&
+         * @return std::string_view
          */
-        inline const std::string& get_name() const { return _name; }
+        inline std::string_view get_name() const { return _name; }
     };
 
-    /**
-     * @brief Vector holding shared_ptr to all the scales that were loaded
-     *
-     */
-    std::vector<std::shared_ptr<ScaleEntry<Scale>>> _entries;
-
-    /**
-     * @brief Multimap for easier filtering by difficulty
-     *
-     */
-    std::multimap<Difficulty, std::shared_ptr<ScaleEntry<Scale>>> _difficulty_map;
-
-    /**
-     * @brief Holds copies of the names (strings) of all loaded scales
-     *
-     * The fact that this holds the strings as a copy and not as pointer to the ScaleEntries
-     * themselves is simply because this is more resilient to changes in the code and the copying
-     * here relatively cheap. The amount of possible scale entries is not large enough for this to
-     * be a problem where some memory is being doubled. Can be refactored when/if needed.
-     *
-     *
-     */
-    std::vector<std::string> _scale_names;
-
     /**
      * @brief Used static middle C Note for use when generating the roots
      *
@@ -132,6 +198,12 @@ class ScaleManager
         {_middle_c, 5, 0}, {_middle_c, 6, -1}, {_middle_c, 6, 0}, {_middle_c, 7, -1},
         {_middle_c, 7, 0}};
 
+    /**
+     * @brief The names of _possible_roots, rendered once so printing a root never regenerates it.
+     *
+     */
+    std::vector<std::string> _root_names;
+
     /**
      * @brief Certain roots are more difficult due to a lack of exposure or a larger amount of
      * accidentals, so they only appear in higher difficulties.
@@ -142,59 +214,454 @@ class ScaleManager
         {1, 0, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 0},
         {2, 1, 2, 2, 2, 2, 1, 1, 2, 1, 2, 2, 1}};
 
+   public:
+    /**
+     * @brief The loaded scales and everything built from them, as they were at one point in time.
+     *
+     * A snapshot is never modified once it is published, so it can be read from any number of
+     * threads at once. Everything it hands out (indices, names, the realisation cache and the
+     * scale index) stays valid for as long as the snapshot is held, even after a newer one was
+     * published; sessions hold on to the snapshot they started with, so a reload never changes the
+     * questions under them.
+     */
+    class Snapshot
+    {
+       private:
+        /**
+         * @brief Every loaded scale, ordered by difficulty once build_maps has run.
+         *
+         */
+        ScaleCatalogue _catalogue;
+
+        /**
+         * @brief Alias-table samplers over indices into _catalogue, one per maximum difficulty.
+         *
+         */
+        std::array<WeightedSampler, NUMBER_OF_DIFFICULTIES> _scale_samplers_by_difficulty;
+
+        /**
+         * @brief Alias-table samplers over indices into _possible_roots, built from
+         * _root_note_weights_by_difficulty.
+         *
+         */
+        std::array<WeightedSampler, NUMBER_OF_DIFFICULTIES> _root_samplers_by_difficulty;
+
+        /**
+         * @brief Every loaded scale realised on every possible root; only present if it was built.
+         *
+         */
+        std::optional<RealisationCache> _realisation_cache;
+
+        /**
+         * @brief Reverse lookup from note sets to every loaded scale realised on every possible
+         * root; only present if it was built.
+         *
+         */
+        std::optional<ScaleIndex> _scale_index;
+
+        /**
+         * @brief Used to sort the catalogue by difficulty and build the difficulty samplers after
+         * all scales are loaded.
+         *
+         * The sampler for a given maximum difficulty gives each difficulty up to it that has any
+         * scales an equal likelihood, and each scale within a difficulty an equal likelihood.
+         *
+         * @param number_of_threads - how many threads to sort the catalogue with
+         */
+        void build_maps(size_t number_of_threads = 1);
+
+        /**
+         * @brief Returns the weight a single scale of each difficulty is sampled with, when
+         * sampling up to max_difficulty (see build_maps).
+         *
+         * @param max_difficulty - the maximum difficulty sampled
+         * @return std::array<double, NUMBER_OF_DIFFICULTIES>
+         */
+        std::array<double, NUMBER_OF_DIFFICULTIES> difficulty_weights(size_t max_difficulty) const;
+
+        /**
+         * @brief Builds the cache of every scale realised and rendered on every possible root.
+         *
+         */
+        void build_realisation_cache();
+
+        /**
+         * @brief Builds the index of every scale realised on every possible root.
+         *
+         * @param number_of_threads - how many threads may realise the scales
+         */
+        void build_scale_index(size_t number_of_threads);
+
+        /**
+         * @brief Realises the scale at scale_index on the root at root_index into a new
+         * ScaleEntry.
+         *
+         * @param scale_index - index into _catalogue
+         * @param root_index - index into _possible_roots
+         * @param alloc - allocator the realised scale is built with
+         * @return ScaleEntry<RealisedScale>
+         */
+        ScaleEntry<RealisedScale> realise_entry(
+            size_t scale_index, size_t root_index,
+            const RealisedScale::allocator_type& alloc = {}) const;
+
+        /**
+         * @brief Samples indices into _catalogue by difficulty.
+         *
+         * Each difficulty up to the set one has an equal likelihood, then each scale within the
+         * difficulty has an equal likelihood. Each draw is O(1) through the alias table.
+         *
+         * @param number_of_scales - the number of scales we want to sample
+         * @param difficulty - the max difficulty of scales we want to sample
+         * @param gen - reference to the random engine to draw with
+         * @return std::vector<size_t>
+         */
+        std::vector<size_t> sample_scale_indices_by_difficulty(size_t number_of_scales,
+                                                               ScaleManager::Difficulty difficulty,
+                                                               RandomEngine& gen) const;
+
+        /**
+         * @brief Samples indices into _possible_roots, weighted by the given difficulty's weights.
+         *
+         * @param number_of_roots - the number of roots we want to sample
+         * @param difficulty - the maximum difficulty of the scales we sample
+         * @param gen - reference to the random engine to draw with
+         * @return std::vector<size_t>
+         */
+        std::vector<size_t> sample_root_indices_by_difficulty(size_t number_of_roots,
+                                                              ScaleManager::Difficulty difficulty,
+                                                              RandomEngine& gen) const;
+
+       public:
+        /**
+         * @brief Construct a new Snapshot object without any scales.
+         *
+         */
+        Snapshot();
+
+        /**
+         * @brief Samples a single index into _catalogue by difficulty, in O(1) through the
+         * alias table; see sample_scale_indices_by_difficulty.
+         *
+         * @param difficulty - the max difficulty of the scale we want to sample
+         * @param gen - reference to the random engine to draw with
+         * @return size_t
+         */
+        inline size_t sample_scale_index(ScaleManager::Difficulty difficulty,
+                                         RandomEngine& gen) const
+        {
+            return _scale_samplers_by_difficulty[static_cast<size_t>(difficulty)](gen);
+        }
+
+        /**
+         * @brief Samples a single index into _possible_roots by difficulty, in O(1) through the
+         * alias table.
+         *
+         * @param difficulty - the maximum difficulty of the scale we sample the root for
+         * @param gen - reference to the random engine to draw with
+         * @return size_t
+         */
+        inline size_t sample_root_index(ScaleManager::Difficulty difficulty,
+                                        RandomEngine& gen) const
+        {
+            return _root_samplers_by_difficulty[static_cast<size_t>(difficulty)](gen);
+        }
+
+        /**
+         * @brief Returns whether the realisation cache has been built.
+         *
+         * @return true
+         * @return false
+         */
+        inline bool has_realisation_cache() const { return _realisation_cache.has_value(); }
+
+        /**
+         * @brief Get the realisation cache. Throws an std::runtime_error exception if it was not
+         * built.
+         *
+         * @return const RealisationCache&
+         */
+        inline const RealisationCache& get_realisation_cache() const
+        {
+            if (!_realisation_cache.has_value()) throw std::runtime_error(NO_REALISATION_CACHE);
+            return _realisation_cache.value();
+        }
+
+        /**
+         * @brief Returns whether the scale index has been built.
+         *
+         * @return true
+         * @return false
+         */
+        inline bool has_scale_index() const { return _scale_index.has_value(); }
+
+        /**
+         * @brief Get the scale index. Its realisation indices are the same as those of the
+         * realisation cache. Throws an std::runtime_error exception if it was not built.
+         *
+         * @return const ScaleIndex&
+         */
+        inline const ScaleIndex& get_scale_index() const
+        {
+            if (!_scale_index.has_value()) throw std::runtime_error(NO_SCALE_INDEX);
+            return _scale_index.value();
+        }
+
+        /**
+         * @brief Picks the multiple choice options for a question about the scale at
+         * correct_index.
+         *
+         * The options are the correct scale and NUMBER_OF_CHOICES - 1 distinct other scales, in
+         * random order, all as indices into the loaded scales. The other scales are found by
+         * rejection sampling over the indices, so this is O(NUMBER_OF_CHOICES) expected regardless
+         * of how many scales are loaded, and nothing gets copied or compared by name. Throws an
+         * std::runtime_error exception if fewer than NUMBER_OF_CHOICES scales are loaded.
+         *
+         * @param correct_index - index of the scale the question is about
+         * @param options - where to write the options
+         * @param gen - reference to the random engine to draw with
+         * @return size_t - position of correct_index in options
+         */
+        size_t sample_options(size_t correct_index,
+                              std::span<std::uint32_t, NUMBER_OF_CHOICES> options,
+                              RandomEngine& gen) const;
+
+        /**
+         * @brief Returns the name of a loaded scale by its index into the catalogue.
+         *
+         * @param scale_index - index of the scale in the catalogue
+         * @return std::string_view
+         */
+        inline std::string_view get_scale_name(size_t scale_index) const
+        {
+            return _catalogue.name(scale_index);
+        }
+
+        /**
+         * @brief Returns the amount of loaded scales.
+         *
+         * @return size_t
+         */
+        inline size_t number_of_scales() const { return _catalogue.size(); }
+
+        /**
+         * @brief Returns the weight the scale at scale_index is sampled with up to the given
+         * maximum difficulty, relative to the other scales (0 if it is never sampled).
+         *
+         * @param difficulty - the maximum difficulty sampled
+         * @param scale_index - index of the scale in the catalogue
+         * @return double
+         */
+        inline double scale_weight(ScaleManager::Difficulty difficulty, size_t scale_index) const
+        {
+            auto scale_difficulty = static_cast<size_t>(_catalogue.difficulty(scale_index));
+            if (scale_difficulty > static_cast<size_t>(difficulty)) return 0.0;
+            return difficulty_weights(static_cast<size_t>(difficulty))[scale_difficulty];
+        }
+
+        /**
+         * @brief Get the catalogue of loaded scales.
+         *
+         * @return const ScaleCatalogue&
+         */
+        inline const ScaleCatalogue& get_catalogue() const { return _catalogue; }
+
+        /**
+         * @brief Generates a set amount of RealisedScale ScaleEntries as questions, drawing from
+         * the given engine.
+         *
+         * This combines difficulty-based sampling of scales and root notes.
+         *
+         * @param number_of_scales - the number of scales to generate
+         * @param difficulty - the maximum difficulty of scales to generate
+         * @param gen - reference to the random engine to draw with
+         * @return std::vector<ScaleManager::ScaleEntry<RealisedScale>>
+         */
+        std::vector<ScaleManager::ScaleEntry<RealisedScale>>
+        generate_realised_scales_by_difficulty(size_t number_of_scales,
+                                               ScaleManager::Difficulty difficulty,
+                                               RandomEngine& gen) const;
+
+        /**
+         * @brief Generates a set amount of questions as indices into the realisation cache,
+         * drawing from the given engine.
+         *
+         * Same sampling as generate_realised_scales_by_difficulty, but nothing is realised; the
+         * notes and display string of each question are looked up in get_realisation_cache().
+         * Throws an std::runtime_error exception if the cache was not built.
+         *
+         * @param number_of_scales - the number of scales to generate
+         * @param difficulty - the maximum difficulty of scales to generate
+         * @param gen - reference to the random engine to draw with
+         * @return std::vector<size_t>
+         */
+        std::vector<size_t> generate_cached_realisations_by_difficulty(
+            size_t number_of_scales, ScaleManager::Difficulty difficulty, RandomEngine& gen) const;
+
+        friend class ScaleManager;
+        friend class ApplicationManager;
+        friend class SessionGenerator;
+    };
+
+   private:
+    /**
+     * @brief The snapshot every reader starts from. Loads replace it as a whole and never modify
+     * the one already published.
+     *
+     */
+    std::atomic<std::shared_ptr<const Snapshot>> _snapshot;
+
+    /**
+     * @brief Held by loads while they build their snapshot, so that two loads at once can't both
+     * start from the same snapshot and lose the other's scales. Readers never take it.
+     *
+     */
+    std::mutex _load_mutex;
+
+    /**
+     * @brief The engine used by every sampling call that is not handed an engine of its own.
+     *
+     * Seeded from std::random_device unless set_seed is called.
+     */
+    RandomEngine _engine{random_seed()};
+
     /**
      * @brief Wrapper function around the file opening and closing procedure.
      *
+     * Regular files are memory mapped, unless map_file is false, and read with handle_contents.
+     * Anything else is read through parse_fstream. A mapped file that is truncated while it is
+     * read raises SIGBUS, so files that may change under the load must not be mapped; those are
+     * read into memory whole first.
+     *
      * @param path - reference to the file path we want to read from
+     * @param number_of_threads - how many threads parse_view may use
+     * @param catalogue - reference to the catalogue the scales are added to
+     * @param map_file - whether the file may be memory mapped
      */
-    void handle_file(const std::string& path);
+    static void handle_file(const std::string& path, size_t number_of_threads,
+                            ScaleCatalogue& catalogue, bool map_file = true);
 
     /**
-     * @brief Implements the actual parsing of the file stream into a bunch of ScaleEntry objects.
+     * @brief Adds the scales of a whole file's contents to catalogue: compiled catalogues are read
+     * straight from the contents and csv files are parsed in place with parse_view.
+     *
+     * @param contents - the contents of the file
+     * @param number_of_threads - how many threads parse_view may use
+     * @param catalogue - reference to the catalogue the scales are added to
+     */
+    static void handle_contents(std::string_view contents, size_t number_of_threads,
+                                ScaleCatalogue& catalogue);
+
+    /**
+     * @brief Parses a single csv row into the catalogue. Throws an std::runtime_error exception
+     * with the row number if the row is malformed.
+     *
+     * @param line - the row, without its line break
+     * @param row - the row number, for error messages
+     * @param scale - scratch Scale parsed into, so its storage is reused between rows
+     * @param catalogue - reference to the catalogue the scale is added to
+     */
+    static void parse_row(std::string_view line, size_t row, Scale& scale,
+                          ScaleCatalogue& catalogue);
+
+    /**
+     * @brief Implements the actual parsing of the file stream into the catalogue.
      *
      * @param stream - reference to the input stream we want to parse from
+     * @param catalogue - reference to the catalogue the scales are added to
+     */
+    static void parse_fstream(std::ifstream& stream, ScaleCatalogue& catalogue);
+
+    /**
+     * @brief Parses csv lines into a catalogue, tokenising the characters in place without copying
+     * any fields.
+     *
+     * @param lines - view of whole lines of the file
+     * @param first_row - the row number of the first line; row 0 is the header and is skipped
+     * @param catalogue - reference to the catalogue the scales are added to
+     */
+    static void parse_lines(std::string_view lines, size_t first_row, ScaleCatalogue& catalogue);
+
+    /**
+     * @brief Parses the whole contents of a file into the catalogue. Gives the same results and
+     * errors as parse_fstream, however many threads are used.
+     *
+     * Above MIN_PARALLEL_CHUNK_SIZE bytes per thread, the contents are split at line boundaries
+     * into one chunk per thread. The first rows of the chunks are found by counting line breaks,
+     * every chunk is parsed into a catalogue of its own and these are appended in order.
+     *
+     * @param contents - view of the file contents
+     * @param number_of_threads - the most threads to parse with
+     * @param catalogue - reference to the catalogue the scales are added to
+     */
+    static void parse_view(std::string_view contents, size_t number_of_threads,
+                           ScaleCatalogue& catalogue);
+
+    /**
+     * @brief Smallest chunk of a file worth parsing on a thread of its own.
+     *
+     */
+    static constexpr size_t MIN_PARALLEL_CHUNK_SIZE = 1 << 16;
+
+    /**
+     * @brief Returns a new unpublished snapshot holding the scales of the current one, for a load
+     * to add its scales to. Only called with _load_mutex held.
+     *
+     * @return std::shared_ptr<Snapshot>
+     */
+    std::shared_ptr<Snapshot> extend_current() const;
+
+    /**
+     * @brief Throws an std::runtime_error exception if sessions can't be generated from the
+     * snapshot, i.e. if it has fewer scales than there are options to pick from, or no easy ones.
+     *
+     * @param snapshot - reference to the snapshot to check
      */
-    void parse_fstream(std::ifstream& stream);
+    static void validate(const Snapshot& snapshot);
 
     /**
-     * @brief Used to build the difficulty to ScaleEntry map after all scales are loaded.
+     * @brief Everything that happens after new scales are added to a snapshot, however they were
+     * loaded: checks that no two scales share a name (throwing an std::runtime_error exception
+     * otherwise), builds what was asked for and publishes the snapshot. Only called with
+     * _load_mutex held.
      *
+     * @param next - the snapshot to publish
+     * @param build_realisation_cache - if true, the realisation cache is built
+     * @param number_of_threads - how many threads may be used
+     * @param build_scale_index - if true, the scale index is built
      */
-    void build_maps();
+    void finish_loading(std::shared_ptr<Snapshot> next, bool build_realisation_cache,
+                        size_t number_of_threads, bool build_scale_index);
 
     /**
-     * @brief Get a set amount of random (shared_ptrs to) ScaleEntries of Scales.
+     * @brief Get a set amount of distinct random scales, as indices into the current catalogue.
      *
-     * Pointers are used so we don't keep copying ScaleEntries.
      * This function is generally not used, as we don't have control of difficulty.
      *
      * @param number_of_scales - the number of scales we want to generate
-     * @return std::vector<std::shared_ptr<ScaleEntry<Scale>>>
+     * @return std::vector<size_t>
      */
-    std::vector<std::shared_ptr<ScaleEntry<Scale>>> get_random_scales(size_t number_of_scales);
+    std::vector<size_t> get_random_scales(size_t number_of_scales);
 
     /**
-     * @brief Get a set amount of random (shared_ptrs to) ScaleEntreis of Scales sampled by
-     * difficulty.
+     * @brief Get a set amount of random scales sampled by difficulty, as indices into the current
+     * catalogue.
      *
-     * Pointers are used so we don't keep copying ScaleEntries.
-     * We first sample questions by difficulty (each difficulty up to the set one has an equal
-     * likelihood), then for each question we sample from scales within the question's difficulty.
+     * Each difficulty up to the set one has an equal likelihood, then each scale within the
+     * difficulty has an equal likelihood.
      *
      * @param number_of_scales - the number of scales we want to sample
      * @param difficulty - the max difficulty of scales we want to sample
-     * @return std::vector<std::shared_ptr<ScaleEntry<Scale>>>
+     * @return std::vector<size_t>
      */
-    std::vector<std::shared_ptr<ScaleEntry<Scale>>> get_random_scales_by_difficulty(
-        size_t number_of_scales, ScaleManager::Difficulty difficulty);
+    std::vector<size_t> get_random_scales_by_difficulty(size_t number_of_scales,
+                                                        ScaleManager::Difficulty difficulty);
 
     /**
      * @brief Get a set amount of random root notes, sampled by the given difficulty's weights.
      *
      * We can use raw pointers here, as the vector of Notes _possible_roots is constructed once and
-     * never changes, so the vector entries don't move. This is not the case for get_random_scales
-     * methods, as they emplace into a new vector, where the container might move during the
-     * sampling process.
+     * never changes, so the vector entries don't move.
      *
      * @param number_of_roots - the number of scales we want to sample
      * @param difficulty - the maximum difficulty of the scales we sample
@@ -205,11 +672,229 @@ class ScaleManager
 
    public:
     /**
-     * @brief Public calling function to load the scales from a .csv file.
+     * @brief Construct a new Scale Manager object. Scales still have to be loaded.
+     *
+     */
+    ScaleManager();
+
+    ScaleManager(const ScaleManager&) = delete;
+    ScaleManager& operator=(const ScaleManager&) = delete;
+
+    /**
+     * @brief Public calling function to load the scales from a .csv file or compiled catalogue,
+     * adding them to the ones already loaded.
+     *
+     * Large files can be parsed and sorted on several threads; the loaded scales, their order and
+     * any error messages are the same as with a single thread. If loading throws, the scales
+     * loaded before stay as they were.
      *
      * @param path - path to file we want to read from
+     * @param build_realisation_cache - if true, the realisation cache is built once loading is done
+     * @param number_of_threads - how many threads loading may use
+     * @param build_scale_index - if true, the scale index is built once loading is done
+     */
+    void load_scales_from_file(const std::string& path, bool build_realisation_cache = false,
+                               size_t number_of_threads = 1, bool build_scale_index = false);
+
+    /**
+     * @brief Replaces every loaded scale with those of a .csv file or compiled catalogue.
+     *
+     * Meant for updating the scales of a running server: sessions already in progress keep the
+     * snapshot they started with, and only sessions started afterwards see the new scales. The
+     * new scales are checked (see validate) before they are published; if reading or checking
+     * them throws, the scales loaded before stay in place. The file is read into memory rather
+     * than mapped, so it can safely be rewritten in place while it is reloaded.
+     *
+     * @param path - path to file we want to read from
+     * @param build_realisation_cache - if true, the realisation cache is built before publishing
+     * @param number_of_threads - how many threads loading may use
+     * @param build_scale_index - if true, the scale index is built before publishing
+     */
+    void reload_scales_from_file(const std::string& path, bool build_realisation_cache = false,
+                                 size_t number_of_threads = 1, bool build_scale_index = false);
+
+    /**
+     * @brief Loads the built-in scales (see DefaultCatalogue), which are compiled into the program,
+     * so nothing is read or parsed.
+     *
+     * @param build_realisation_cache - if true, the realisation cache is built once loading is done
+     * @param number_of_threads - how many threads loading may use
+     * @param build_scale_index - if true, the scale index is built once loading is done
+     */
+    void load_default_scales(bool build_realisation_cache = false, size_t number_of_threads = 1,
+                             bool build_scale_index = false);
+
+    /**
+     * @brief Loads the scales of an already built catalogue (e.g. a generated one), adding them to
+     * the ones already loaded. Nothing is read or parsed; if no scales were loaded yet, the
+     * catalogue is moved in as it is.
+     *
+     * @param catalogue - the catalogue to load
+     * @param build_realisation_cache - if true, the realisation cache is built once loading is done
+     * @param number_of_threads - how many threads loading may use
+     * @param build_scale_index - if true, the scale index is built once loading is done
+     */
+    void load_catalogue(ScaleCatalogue catalogue, bool build_realisation_cache = false,
+                        size_t number_of_threads = 1, bool build_scale_index = false);
+
+    /**
+     * @brief Writes every loaded scale to a compiled catalogue (see ScaleCatalogue), which
+     * load_scales_from_file then loads without any parsing.
+     *
+     * @param path - path to the file we want to write to
+     */
+    void save_compiled_catalogue(const std::string& path) const;
+
+    /**
+     * @brief Publishes the loaded scales again, along with the cache of every one of them realised
+     * and rendered on every possible root.
+     *
+     * Only has to be called manually if the cache was not requested when loading.
+     */
+    void build_realisation_cache();
+
+    /**
+     * @brief Publishes the loaded scales again, along with the index of every one of them realised
+     * on every possible root, for finding which scales on which roots are made of a given set of
+     * notes.
+     *
+     * Only has to be called manually if the index was not requested when loading.
+     *
+     * @param number_of_threads - how many threads may realise the scales
+     */
+    void build_scale_index(size_t number_of_threads = 1);
+
+    /**
+     * @brief Returns the current snapshot of the loaded scales, which stays valid (and unchanged)
+     * for as long as it is held, whatever is loaded afterwards. Safe to call from any thread.
+     *
+     * @return std::shared_ptr<const Snapshot>
+     */
+    inline std::shared_ptr<const Snapshot> snapshot() const
+    {
+        return _snapshot.load(std::memory_order_acquire);
+    }
+
+    // The readers below pin the current snapshot for the length of the call, so they are safe to
+    // call while the scales are reloaded. The ones returning references (get_realisation_cache,
+    // get_scale_index, get_scale_name and get_catalogue) hand out something the snapshot owns,
+    // which a reload may free as soon as they return: only use those while nothing is loaded
+    // concurrently, and hold on to a snapshot() otherwise.
+
+    /**
+     * @brief Returns whether the realisation cache has been built.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool has_realisation_cache() const { return snapshot()->has_realisation_cache(); }
+
+    /**
+     * @brief Get the realisation cache. Throws an std::runtime_error exception if it was not built.
+     *
+     * @return const RealisationCache&
+     */
+    inline const RealisationCache& get_realisation_cache() const
+    {
+        return snapshot()->get_realisation_cache();
+    }
+
+    /**
+     * @brief Returns whether the scale index has been built.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool has_scale_index() const { return snapshot()->has_scale_index(); }
+
+    /**
+     * @brief Get the scale index. Its realisation indices are the same as those of the realisation
+     * cache. Throws an std::runtime_error exception if it was not built.
+     *
+     * @return const ScaleIndex&
+     */
+    inline const ScaleIndex& get_scale_index() const { return snapshot()->get_scale_index(); }
+
+    /**
+     * @brief Picks the multiple choice options for a question about the scale at correct_index;
+     * see Snapshot::sample_options.
+     *
+     * @param correct_index - index of the scale the question is about
+     * @param options - where to write the options
+     * @param gen - reference to the random engine to draw with
+     * @return size_t - position of correct_index in options
+     */
+    inline size_t sample_options(size_t correct_index,
+                                 std::span<std::uint32_t, NUMBER_OF_CHOICES> options,
+                                 RandomEngine& gen) const
+    {
+        auto pinned = snapshot();
+        return pinned->sample_options(correct_index, options, gen);
+    }
+
+    /**
+     * @brief Returns the name of a loaded scale by its index into the catalogue.
+     *
+     * @param scale_index - index of the scale in the catalogue
+     * @return std::string_view
+     */
+    inline std::string_view get_scale_name(size_t scale_index) const
+    {
+        return snapshot()->get_scale_name(scale_index);
+    }
+
+    /**
+     * @brief Returns the name of a possible root by its index. The roots never change, so this is
+     * valid for as long as the ScaleManager.
+     *
+     * @param root_index - index of the root among the possible roots
+     * @return std::string_view
+     */
+    inline std::string_view get_root_name(size_t root_index) const
+    {
+        return _root_names[root_index];
+    }
+
+    /**
+     * @brief Returns the amount of possible roots.
+     *
+     * @return size_t
+     */
+    inline static size_t number_of_roots() { return _possible_roots.size(); }
+
+    /**
+     * @brief Returns the weight the root at root_index is sampled with for the given difficulty,
+     * relative to the other roots (0 if it is never sampled).
+     *
+     * @param difficulty - the maximum difficulty of the scales the root is sampled for
+     * @param root_index - index of the root among the possible roots
+     * @return double
+     */
+    inline static double root_weight(Difficulty difficulty, size_t root_index)
+    {
+        return _root_note_weights_by_difficulty[static_cast<size_t>(difficulty)][root_index];
+    }
+
+    /**
+     * @brief Returns the amount of loaded scales.
+     *
+     * @return size_t
+     */
+    inline size_t number_of_scales() const { return snapshot()->number_of_scales(); }
+
+    /**
+     * @brief Get the catalogue of loaded scales.
+     *
+     * @return const ScaleCatalogue&
      */
-    void load_scales_from_file(const std::string& path);
+    inline const ScaleCatalogue& get_catalogue() const { return snapshot()->get_catalogue(); }
+
+    /**
+     * @brief Reseeds the engine used by the sampling calls that are not handed an engine.
+     *
+     * @param seed - the seed to use
+     */
+    inline void set_seed(std::uint64_t seed) { _engine = RandomEngine{seed}; }
 
     /**
      * @brief Generates a set amount of RealisedScale ScaleEntries as questions.
@@ -223,7 +908,49 @@ class ScaleManager
     std::vector<ScaleManager::ScaleEntry<RealisedScale>> generate_realised_scales_by_difficulty(
         size_t number_of_scales, ScaleManager::Difficulty difficulty);
 
+    /**
+     * @brief Generates a set amount of RealisedScale ScaleEntries as questions, drawing from the
+     * given engine.
+     *
+     * This does not touch any state of the ScaleManager, so it can be called from many threads at
+     * once as long as each has its own engine.
+     *
+     * @param number_of_scales - the number of scales to generate
+     * @param difficulty - the maximum difficulty of scales to generate
+     * @param gen - reference to the random engine to draw with
+     * @return std::vector<ScaleManager::ScaleEntry<RealisedScale>>
+     */
+    std::vector<ScaleManager::ScaleEntry<RealisedScale>> generate_realised_scales_by_difficulty(
+        size_t number_of_scales, ScaleManager::Difficulty difficulty, RandomEngine& gen) const;
+
+    /**
+     * @brief Generates a set amount of questions as indices into the realisation cache.
+     *
+     * Same sampling as generate_realised_scales_by_difficulty, but nothing is realised; the notes
+     * and display string of each question are looked up in get_realisation_cache(). Throws an
+     * std::runtime_error exception if the cache was not built.
+     *
+     * @param number_of_scales - the number of scales to generate
+     * @param difficulty - the maximum difficulty of scales to generate
+     * @return std::vector<size_t>
+     */
+    std::vector<size_t> generate_cached_realisations_by_difficulty(
+        size_t number_of_scales, ScaleManager::Difficulty difficulty);
+
+    /**
+     * @brief Generates a set amount of questions as indices into the realisation cache, drawing
+     * from the given engine. Safe to call from many threads at once, each with its own engine.
+     *
+     * @param number_of_scales - the number of scales to generate
+     * @param difficulty - the maximum difficulty of scales to generate
+     * @param gen - reference to the random engine to draw with
+     * @return std::vector<size_t>
+     */
+    std::vector<size_t> generate_cached_realisations_by_difficulty(
+        size_t number_of_scales, ScaleManager::Difficulty difficulty, RandomEngine& gen) const;
+
     friend class ApplicationManager;
+    friend class SessionGenerator;
 };
 
-#endif
\ No newline at end of file
+#endif
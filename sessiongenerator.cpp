@@ -0,0 +1,68 @@
+#include "sessiongenerator.hpp"
+
+#include <algorithm>
+
+#include "parallel.hpp"
+
+SessionGenerator::SessionGenerator(const ScaleManager& sm, size_t number_of_threads,
+                                   std::uint64_t seed)
+    : _snapshot(sm.snapshot())
+{
+    // hardware_concurrency is allowed to return 0 when it does not know
+    number_of_threads = std::max<size_t>(number_of_threads, 1);
+    _engines.reserve(number_of_threads);
+    for (size_t i = 0; i < number_of_threads; ++i)
+    {
+        _engines.push_back(make_stream(seed, i));
+    }
+}
+
+void SessionGenerator::generate_chunk(std::span<GeneratedQuestion> output,
+                                      ScaleManager::Difficulty difficulty, RandomEngine& gen) const
+{
+    for (auto&& question : output)
+    {
+        size_t scale_index = _snapshot->sample_scale_index(difficulty, gen);
+        question._scale_index = static_cast<std::uint32_t>(scale_index);
+        question._root_index =
+            static_cast<std::uint32_t>(_snapshot->sample_root_index(difficulty, gen));
+        question._correct_index = static_cast<std::uint32_t>(
+            _snapshot->sample_options(scale_index, question._options, gen));
+    }
+}
+
+void SessionGenerator::generate(std::span<GeneratedQuestion> output, size_t questions_per_session,
+                                ScaleManager::Difficulty difficulty)
+{
+    if (_snapshot->number_of_scales() == 0) throw std::runtime_error(FORGOT_TO_LOAD_SCALES);
+    if (_snapshot->number_of_scales() < NUMBER_OF_CHOICES)
+    {
+        throw std::runtime_error(NOT_ENOUGH_SCALES_FOR_CHOICES);
+    }
+    if (questions_per_session == 0 || output.size() % questions_per_session != 0)
+    {
+        throw std::invalid_argument(BAD_BATCH_BUFFER);
+    }
+
+    size_t batch_size = output.size() / questions_per_session;
+    size_t number_of_workers = std::min(_engines.size(), batch_size);
+
+    fork_join(number_of_workers,
+              [&](size_t w)
+              {
+                  auto [first_session, last_session] =
+                      block_range(batch_size, number_of_workers, w);
+                  generate_chunk(output.subspan(first_session * questions_per_session,
+                                                (last_session - first_session) *
+                                                    questions_per_session),
+                                 difficulty, _engines[w]);
+              });
+}
+
+std::vector<SessionGenerator::GeneratedQuestion> SessionGenerator::generate(
+    size_t batch_size, size_t questions_per_session, ScaleManager::Difficulty difficulty)
+{
+    std::vector<GeneratedQuestion> output(batch_size * questions_per_session);
+    generate(output, questions_per_session, difficulty);
+    return output;
+}
@@ -0,0 +1,122 @@
+#ifndef SESSIONGENERATOR
+#define SESSIONGENERATOR
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "constants.hpp"
+#include "randomengine.hpp"
+#include "scalemanager.hpp"
+
+/**
+ * @brief Class for generating many independent sessions at once across worker threads.
+ *
+ * Meant for pre-generating quiz sets for many learners, where going through an interactive
+ * ApplicationManager per session would be silly. All workers share one read-only snapshot of the
+ * scales, each worker draws from its own stream of the seed, and every question is written
+ * straight into a caller-provided buffer; nothing is realised or copied. Questions refer to scales
+ * and roots by index, so they can be looked up in snapshot() (or its realisation cache) when
+ * needed.
+ *
+ * Sessions are split between workers in contiguous chunks, so a given seed and number of threads
+ * always produces the same batch.
+ */
+class SessionGenerator
+{
+   public:
+    /**
+     * @brief A single generated question, referring to everything by index.
+     *
+     */
+    struct GeneratedQuestion
+    {
+        // Index of the scale (in load order) the question is about
+        std::uint32_t _scale_index;
+        // Index of the root the scale is realised on
+        std::uint32_t _root_index;
+        // Scale indices of the multiple choice options, one of which is _scale_index
+        std::array<std::uint32_t, NUMBER_OF_CHOICES> _options;
+        // Index of the correct answer in _options
+        std::uint32_t _correct_index;
+    };
+
+   private:
+    /**
+     * @brief The scales every worker samples from, as loaded when the generator was constructed.
+     *
+     */
+    std::shared_ptr<const ScaleManager::Snapshot> _snapshot;
+
+    /**
+     * @brief One engine per worker, kept between batches so that their streams continue.
+     *
+     */
+    std::vector<RandomEngine> _engines;
+
+    /**
+     * @brief Fills a chunk of sessions; this is what a single worker runs.
+     *
+     * @param output - the questions of the sessions in the chunk, back to back
+     * @param difficulty - the maximum difficulty of the questions
+     * @param gen - reference to the worker's random engine
+     */
+    void generate_chunk(std::span<GeneratedQuestion> output, ScaleManager::Difficulty difficulty,
+                        RandomEngine& gen) const;
+
+   public:
+    /**
+     * @brief Construct a new Session Generator object.
+     *
+     * @param sm - reference to the loaded ScaleManager, whose current scales are kept for every
+     * batch; scales it loads later are not seen
+     * @param number_of_threads - how many worker threads to use (at least one)
+     * @param seed - the seed the workers' streams are derived from
+     */
+    SessionGenerator(const ScaleManager& sm,
+                     size_t number_of_threads = std::thread::hardware_concurrency(),
+                     std::uint64_t seed = random_seed());
+
+    /**
+     * @brief Generates a batch of sessions into a preallocated buffer.
+     *
+     * The buffer holds the sessions back to back, so session i is
+     * output[i * questions_per_session, (i + 1) * questions_per_session).
+     *
+     * @param output - the buffer to fill; its size must be a multiple of questions_per_session
+     * @param questions_per_session - the number of questions in each session
+     * @param difficulty - the maximum difficulty of the questions
+     */
+    void generate(std::span<GeneratedQuestion> output, size_t questions_per_session,
+                  ScaleManager::Difficulty difficulty);
+
+    /**
+     * @brief Generates a batch of sessions into a new buffer. See the span overload for the layout.
+     *
+     * @param batch_size - the number of sessions to generate
+     * @param questions_per_session - the number of questions in each session
+     * @param difficulty - the maximum difficulty of the questions
+     * @return std::vector<GeneratedQuestion>
+     */
+    std::vector<GeneratedQuestion> generate(size_t batch_size, size_t questions_per_session,
+                                            ScaleManager::Difficulty difficulty);
+
+    /**
+     * @brief Returns the scales every batch is drawn from, which the question indices refer to.
+     *
+     * @return const ScaleManager::Snapshot&
+     */
+    inline const ScaleManager::Snapshot& snapshot() const { return *_snapshot; }
+
+    /**
+     * @brief Returns the number of worker threads.
+     *
+     * @return size_t
+     */
+    inline size_t number_of_threads() const { return _engines.size(); }
+};
+
+#endif
@@ -0,0 +1,605 @@
+#include "sessionserver.hpp"
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+
+#include "constants.hpp"
+#include "randomengine.hpp"
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <unordered_map>
+#endif
+
+struct SessionServer::Connection
+{
+    int _fd;
+    // Bytes read but not yet split into lines
+    std::string _input;
+    // Replies not yet written, from _output_sent on
+    std::string _output;
+    size_t _output_sent = 0;
+    // Whether epoll is also waiting for the socket to become writable
+    bool _waiting_to_write = false;
+    // Close once the output is flushed (QUIT, or a line too long); nothing more is read
+    bool _closing = false;
+    // The client shut down its side, so what it sent is answered and then the connection closed
+    bool _peer_closed = false;
+    // The learner picked with LEARNER, if any
+    std::optional<size_t> _learner;
+    // Everything a session allocates comes from here and is freed in one go when it ends; a
+    // typical session fits into the buffer, bigger ones spill over to the heap
+    std::array<std::byte, SESSION_ARENA_SIZE> _arena_buffer;
+    std::pmr::monotonic_buffer_resource _arena{_arena_buffer.data(), _arena_buffer.size()};
+    // Only present while a session is in progress, declared after the arena it allocates from
+    std::unique_ptr<ApplicationManager> _session;
+};
+
+namespace
+{
+/**
+ * @brief Splits the next whitespace-separated token off the front of a line.
+ *
+ * @param line - reference to the rest of the line, which is advanced past the token
+ * @return std::string_view - the token, empty if there are none left
+ */
+std::string_view next_token(std::string_view& line)
+{
+    size_t start = line.find_first_not_of(" \t");
+    if (start == std::string_view::npos)
+    {
+        line = {};
+        return {};
+    }
+    size_t end = line.find_first_of(" \t", start);
+    if (end == std::string_view::npos) end = line.size();
+    std::string_view token = line.substr(start, end - start);
+    line.remove_prefix(end);
+    return token;
+}
+
+/**
+ * @brief Parses a whole token as an unsigned number.
+ *
+ * @param token - the token to parse
+ * @param value - reference to where to store the number
+ * @return true - if the entire token was a number
+ * @return false - otherwise
+ */
+bool parse_number(std::string_view token, size_t& value)
+{
+    auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+    return error == std::errc{} && end == token.data() + token.size();
+}
+
+void append_line(std::string& out, std::string_view line)
+{
+    out.append(line);
+    out.push_back('\n');
+}
+}  // namespace
+
+SessionServer::SessionServer(std::shared_ptr<const ScaleManager> sm, const Options& options)
+    : _sm(std::move(sm)), _options(options), _answer_times(_sm->snapshot())
+{
+    if (_options._threads == 0) _options._threads = 1;
+    if (_options._learners_path.has_value())
+    {
+        _learners = std::make_unique<LearnerStore>(_options._learners_path.value(),
+                                                   _options._max_learners);
+    }
+}
+
+SessionServer::~SessionServer() { stop(); }
+
+void SessionServer::handle_line(Connection& connection, std::string_view line)
+{
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    std::string_view command = next_token(line);
+    if (command.empty()) return;
+
+    if (command == "START")
+    {
+        size_t questions = _options._questions;
+        size_t difficulty = static_cast<size_t>(_options._difficulty);
+        std::string_view token = next_token(line);
+        if (!token.empty() && !parse_number(token, questions)) questions = 0;
+        token = next_token(line);
+        if (!token.empty() && !parse_number(token, difficulty)) difficulty = 3;
+
+        if (questions == 0 || questions > MAX_QUESTIONS || difficulty > 2 ||
+            !next_token(line).empty())
+        {
+            append_line(connection._output, SERVE_BAD_ARGUMENTS);
+            return;
+        }
+        start_session(connection, questions, static_cast<ScaleManager::Difficulty>(difficulty));
+    }
+    else if (command == "ANSWER")
+    {
+        size_t answer = 0;
+        if (!parse_number(next_token(line), answer) || !next_token(line).empty())
+        {
+            append_line(connection._output, SERVE_BAD_ARGUMENTS);
+            return;
+        }
+        answer_question(connection, answer);
+    }
+    else if (command == "LEARNER")
+    {
+        size_t learner = 0;
+        if (!parse_number(next_token(line), learner) || !next_token(line).empty())
+        {
+            append_line(connection._output, SERVE_BAD_ARGUMENTS);
+            return;
+        }
+        select_learner(connection, learner);
+    }
+    else if (command == "QUIT")
+    {
+        append_line(connection._output, "BYE");
+        connection._closing = true;
+    }
+    else
+    {
+        append_line(connection._output, SERVE_UNKNOWN_COMMAND);
+    }
+}
+
+void SessionServer::start_session(Connection& connection, size_t questions,
+                                  ScaleManager::Difficulty difficulty)
+{
+    // The arena only holds one session at a time, so a session in progress is dropped first
+    end_session(connection);
+    connection._session = std::make_unique<ApplicationManager>(_sm, &connection._arena);
+    connection._session->set_latency_stats(&_answer_times);
+    if (connection._learner.has_value())
+    {
+        connection._session->set_learner(&(*_learners)[connection._learner.value()]);
+    }
+    std::uint64_t session_number = _sessions_started.fetch_add(1, std::memory_order_relaxed);
+    if (_options._seed.has_value())
+    {
+        connection._session->set_seed(derive_seed(_options._seed.value(), session_number));
+    }
+
+    try
+    {
+        connection._session->generate_session(questions, difficulty);
+    }
+    catch (const std::exception& e)
+    {
+        end_session(connection);
+        connection._output.append("ERROR ");
+        append_line(connection._output, e.what());
+        return;
+    }
+
+    connection._output.append("QUESTION ");
+    connection._session->write_question_line(connection._output);
+    connection._output.push_back('\n');
+}
+
+void SessionServer::answer_question(Connection& connection, size_t answer)
+{
+    ApplicationManager* session = connection._session.get();
+    if (session == nullptr)
+    {
+        append_line(connection._output, SERVE_NO_SESSION);
+        return;
+    }
+
+    append_line(connection._output, session->submit_answer(answer) ? CORRECT : INCORRECT);
+    session->next_question();
+    if (session->can_print_more())
+    {
+        connection._output.append("QUESTION ");
+        session->write_question_line(connection._output);
+        connection._output.push_back('\n');
+        return;
+    }
+
+    auto it = std::back_inserter(connection._output);
+    it = format_string_to(it, "DONE ");
+    it = format_integer_to(it, session->get_correct());
+    *it++ = '/';
+    it = format_integer_to(it, session->number_of_questions());
+    *it++ = ' ';
+    it = format_integer_to(it, session->get_success_percentage());
+    *it++ = '\n';
+
+    if (_results != nullptr)
+    {
+        std::lock_guard lock{_results_mutex};
+        try
+        {
+            session->write_session_results(*_results);
+        }
+        catch (const std::exception& e)
+        {
+            // The learner still gets their score, the server just can't keep it
+            std::cerr << e.what() << std::endl;
+        }
+    }
+    end_session(connection);
+}
+
+void SessionServer::select_learner(Connection& connection, size_t learner)
+{
+    if (_learners == nullptr)
+    {
+        append_line(connection._output, SERVE_NO_LEARNERS);
+        return;
+    }
+    if (learner >= _learners->size())
+    {
+        append_line(connection._output, SERVE_NO_SUCH_LEARNER);
+        return;
+    }
+
+    if (connection._learner != learner)
+    {
+        {
+            std::lock_guard lock{_learners_mutex};
+            if (!_connected_learners.insert(learner).second)
+            {
+                append_line(connection._output, SERVE_LEARNER_IN_USE);
+                return;
+            }
+        }
+        // The session in progress keeps updating the learner it started with, so it has to go
+        end_session(connection);
+        release_learner(connection);
+        connection._learner = learner;
+    }
+
+    auto it = std::back_inserter(connection._output);
+    it = format_string_to(it, "WELCOME ");
+    it = format_integer_to(it, (*_learners)[learner]._answers);
+    *it++ = '\n';
+}
+
+void SessionServer::release_learner(Connection& connection)
+{
+    if (!connection._learner.has_value()) return;
+    std::lock_guard lock{_learners_mutex};
+    _connected_learners.erase(connection._learner.value());
+    connection._learner.reset();
+}
+
+void SessionServer::end_session(Connection& connection)
+{
+    connection._session.reset();
+    connection._arena.release();
+}
+
+void SessionServer::close_results()
+{
+    if (_results == nullptr) return;
+    try
+    {
+        _results->close();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+    _results.reset();
+}
+
+void SessionServer::write_latency_report(std::ostream& stream) const
+{
+    _answer_times.write_report(stream);
+    stream << '\n';
+    LatencyHistogram::write_header(stream, "Server");
+    _command_times.write_row(stream, "Command handling");
+}
+
+#ifdef __linux__
+namespace
+{
+constexpr int MAX_EVENTS = 64;
+// How often a worker without any traffic checks whether it should stop
+constexpr int STOP_CHECK_MS = 250;
+constexpr size_t READ_CHUNK = 4096;
+
+int open_listener(const sockaddr_in& address)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int enable = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(fd, SOMAXCONN) < 0)
+    {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Writes as much of the connection's pending output as the socket takes.
+ *
+ * @return true - if the connection is still usable
+ * @return false - if writing failed and the connection should be dropped
+ */
+template <typename Connection>
+bool flush_output(Connection& connection)
+{
+    while (connection._output_sent < connection._output.size())
+    {
+        ssize_t sent =
+            ::send(connection._fd, connection._output.data() + connection._output_sent,
+                   connection._output.size() - connection._output_sent, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        connection._output_sent += static_cast<size_t>(sent);
+    }
+    connection._output.clear();
+    connection._output_sent = 0;
+    return true;
+}
+}  // namespace
+
+void SessionServer::start()
+{
+    if (!_workers.empty()) return;
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(_options._port);
+    if (::inet_pton(AF_INET, _options._address.c_str(), &address.sin_addr) != 1)
+    {
+        throw std::runtime_error(SERVE_BAD_ADDRESS);
+    }
+
+    if (_options._results_path.has_value() && _results == nullptr)
+    {
+        ResultsSink::Options results_options;
+        results_options._append = true;
+        results_options._asynchronous = true;
+        _results = std::make_unique<ResultsSink>(_options._results_path.value(), results_options);
+    }
+
+    for (size_t i = 0; i < _options._threads; ++i)
+    {
+        int fd = open_listener(address);
+        if (fd < 0)
+        {
+            close_listeners();
+            close_results();
+            throw std::runtime_error(SERVE_CANNOT_LISTEN);
+        }
+        _listeners.push_back(fd);
+
+        // If the system picked the port, the other workers have to share that one
+        if (i == 0)
+        {
+            socklen_t length = sizeof(address);
+            ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+            _port = ntohs(address.sin_port);
+        }
+    }
+
+    for (int listener : _listeners)
+    {
+        _workers.emplace_back([this, listener](std::stop_token stop)
+                              { run_worker(listener, std::move(stop)); });
+    }
+}
+
+void SessionServer::stop()
+{
+    for (auto& worker : _workers) worker.request_stop();
+    // jthread joins on destruction
+    _workers.clear();
+    close_listeners();
+    // Only once no worker can write to it any more
+    close_results();
+}
+
+void SessionServer::close_listeners()
+{
+    for (int fd : _listeners) ::close(fd);
+    _listeners.clear();
+}
+
+void SessionServer::run_worker(int listener, std::stop_token stop)
+{
+    int epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epoll < 0)
+    {
+        std::cerr << SERVE_CANNOT_LISTEN << std::endl;
+        return;
+    }
+
+    // The listener is the only registration without a Connection behind it
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    ::epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event);
+
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    auto drop = [&](Connection& connection)
+    {
+        int fd = connection._fd;
+        release_learner(connection);
+        ::epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        connections.erase(fd);
+    };
+
+    std::array<epoll_event, MAX_EVENTS> events;
+    char buffer[READ_CHUNK];
+    while (!stop.stop_requested())
+    {
+        int ready = ::epoll_wait(epoll, events.data(), MAX_EVENTS, STOP_CHECK_MS);
+        if (ready < 0)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        for (int e = 0; e < ready; ++e)
+        {
+            if (events[e].data.ptr == nullptr)
+            {
+                // The listener is this worker's own (SO_REUSEPORT), so every connection the
+                // kernel queued on it is ours; accept until EAGAIN says the queue is empty
+                int fd;
+                while ((fd = ::accept4(listener, nullptr, nullptr,
+                                       SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+                {
+                    auto connection = std::make_unique<Connection>();
+                    connection->_fd = fd;
+                    epoll_event client{};
+                    client.events = EPOLLIN | EPOLLRDHUP;
+                    client.data.ptr = connection.get();
+                    if (::epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &client) < 0)
+                    {
+                        ::close(fd);
+                        continue;
+                    }
+                    connections.emplace(fd, std::move(connection));
+                }
+                continue;
+            }
+
+            Connection& connection = *static_cast<Connection*>(events[e].data.ptr);
+            if (events[e].events & EPOLLERR)
+            {
+                drop(connection);
+                continue;
+            }
+
+            if (events[e].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))
+            {
+                for (;;)
+                {
+                    ssize_t received = ::recv(connection._fd, buffer, sizeof(buffer), 0);
+                    if (received > 0)
+                    {
+                        connection._input.append(buffer, static_cast<size_t>(received));
+                        continue;
+                    }
+                    if (received < 0 && errno == EINTR) continue;
+                    // Orderly shutdown from the client, finish answering what it sent
+                    if (received == 0) connection._peer_closed = true;
+                    break;
+                }
+
+                // Nothing is read after QUIT, even if the client sent more
+                size_t start = 0;
+                size_t end;
+                while (!connection._closing &&
+                       (end = connection._input.find('\n', start)) != std::string::npos)
+                {
+                    auto started = std::chrono::steady_clock::now();
+                    try
+                    {
+                        handle_line(connection, std::string_view{connection._input}.substr(
+                                                    start, end - start));
+                    }
+                    catch (const std::exception& e)
+                    {
+                        // Only this connection is at fault, the worker serves the others on
+                        end_session(connection);
+                        connection._output.append("ERROR ");
+                        append_line(connection._output, e.what());
+                        connection._closing = true;
+                    }
+                    _command_times.record(std::chrono::steady_clock::now() - started);
+                    start = end + 1;
+                }
+                connection._input.erase(0, start);
+                // An unterminated last line is never going to be finished
+                if (connection._peer_closed) connection._closing = true;
+                if (connection._input.size() > MAX_LINE_LENGTH)
+                {
+                    append_line(connection._output, SERVE_LINE_TOO_LONG);
+                    connection._input.clear();
+                    connection._closing = true;
+                }
+            }
+
+            if (!flush_output(connection))
+            {
+                drop(connection);
+                continue;
+            }
+
+            bool pending = !connection._output.empty();
+            if (!pending && connection._closing)
+            {
+                drop(connection);
+                continue;
+            }
+            if (pending != connection._waiting_to_write)
+            {
+                // Only ask for EPOLLOUT while there is something waiting, it'd fire constantly
+                epoll_event client{};
+                client.events = EPOLLIN | EPOLLRDHUP | (pending ? EPOLLOUT : 0u);
+                client.data.ptr = &connection;
+                ::epoll_ctl(epoll, EPOLL_CTL_MOD, connection._fd, &client);
+                connection._waiting_to_write = pending;
+            }
+        }
+    }
+
+    for (auto& [fd, connection] : connections)
+    {
+        release_learner(*connection);
+        ::close(fd);
+    }
+    ::close(epoll);
+}
+
+void SessionServer::block_termination_signals()
+{
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    ::pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+}
+
+void SessionServer::wait_for_termination_signal()
+{
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    int signal;
+    ::sigwait(&signals, &signal);
+}
+#else
+void SessionServer::start() { throw std::runtime_error(SERVE_NOT_SUPPORTED); }
+
+void SessionServer::stop() {}
+
+void SessionServer::close_listeners() {}
+
+void SessionServer::run_worker(int, std::stop_token) {}
+
+void SessionServer::block_termination_signals() {}
+
+void SessionServer::wait_for_termination_signal() {}
+#endif
@@ -0,0 +1,281 @@
+#ifndef SESSIONSERVER
+#define SESSIONSERVER
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "applicationmanager.hpp"
+#include "latencyhistogram.hpp"
+#include "learnerstore.hpp"
+#include "resultssink.hpp"
+#include "scalemanager.hpp"
+
+/**
+ * @brief Serves sessions to many learners over TCP from a single process.
+ *
+ * The scales are loaded once and shared by every session; if they are reloaded, every session
+ * carries on with the snapshot of the scales it started with. Each worker thread runs its own epoll
+ * event loop over its own listening socket (the kernel spreads new connections between them with
+ * SO_REUSEPORT), so a connection is only ever touched by one thread and needs no locking. Every
+ * connection owns an ApplicationManager holding its session, which is allocated from a monotonic
+ * arena of the connection and freed all at once when the session ends.
+ *
+ * The protocol is line-based, one command per line, one or more reply lines per command:
+ *
+ *     START [questions] [difficulty]  ->  QUESTION {n}/{total};{realised scale};{option 1};...
+ *     ANSWER {option}                 ->  CORRECT | INCORRECT, then QUESTION ... or
+ *                                         DONE {correct}/{total} {percentage}
+ *     LEARNER {id}                    ->  WELCOME {answers recorded so far}
+ *     QUIT                            ->  BYE (and the connection is closed)
+ *
+ * If the server keeps learners (Options::_learners_path), LEARNER picks whose sessions the
+ * connection's START from then on adapts (see LearnerModel); a learner can only be connected once
+ * at a time, and picking one ends the session in progress.
+ * Anything the server can't act on gets an "ERROR {reason}" line and the connection stays open,
+ * unless handling the command failed unexpectedly (threw), which also closes the connection.
+ * Only available on Linux; start() throws std::runtime_error elsewhere.
+ */
+class SessionServer
+{
+   public:
+    /**
+     * @brief Port used when none is given.
+     *
+     */
+    static constexpr std::uint16_t DEFAULT_PORT = 7383;
+
+    /**
+     * @brief Longest line a client may send; longer lines close the connection.
+     *
+     */
+    static constexpr size_t MAX_LINE_LENGTH = 1024;
+
+    /**
+     * @brief Most questions a client may ask for in a single session.
+     *
+     */
+    static constexpr size_t MAX_QUESTIONS = 1000;
+
+    /**
+     * @brief Bytes every connection keeps for allocating its session from, enough for a session of
+     * a few questions (about 1 KB each) without touching the heap.
+     *
+     */
+    static constexpr size_t SESSION_ARENA_SIZE = 1 << 13;
+
+    /**
+     * @brief How the server listens and what sessions it hands out by default.
+     *
+     */
+    struct Options
+    {
+        std::string _address = "127.0.0.1";
+        // 0 lets the system pick a free port, see port()
+        std::uint16_t _port = DEFAULT_PORT;
+        size_t _threads = 1;
+        // Used by START when the client doesn't give them
+        size_t _questions = 5;
+        ScaleManager::Difficulty _difficulty = ScaleManager::Difficulty::MEDIUM;
+        // If set, session n is seeded with derive_seed(seed, n), otherwise sessions are random
+        std::optional<std::uint64_t> _seed;
+        // If set, every finished session is appended here (as CSV) through a single asynchronous
+        // ResultsSink, opened by start(); results reach the file when its buffer fills or on stop()
+        std::optional<std::string> _results_path;
+        // If set, learners are kept here (see LearnerStore), which is grown to _max_learners
+        std::optional<std::string> _learners_path;
+        size_t _max_learners = 1 << 20;
+    };
+
+   private:
+    /**
+     * @brief State of a single client connection, see sessionserver.cpp.
+     *
+     */
+    struct Connection;
+
+    std::shared_ptr<const ScaleManager> _sm;
+    Options _options;
+
+    // One listening socket per worker, all bound to the same port
+    std::vector<int> _listeners;
+    std::uint16_t _port = 0;
+    std::vector<std::jthread> _workers;
+
+    // Numbers the sessions, for seeding them
+    std::atomic<std::uint64_t> _sessions_started{0};
+    // Finished sessions from any worker go into the same sink, which writes the file from its own
+    // thread; the mutex is only held while a session is formatted into the sink's buffer
+    std::unique_ptr<ResultsSink> _results;
+    std::mutex _results_mutex;
+
+    // Only present if the server keeps learners
+    std::unique_ptr<LearnerStore> _learners;
+    // Learners some connection has picked, so no two connections update the same state
+    std::unordered_set<size_t> _connected_learners;
+    std::mutex _learners_mutex;
+
+    // Answer times of every session, and how long handling a single command took, from every worker
+    LatencyStats _answer_times;
+    LatencyHistogram _command_times;
+
+    /**
+     * @brief Event loop of a worker: accepts on its listener, reads commands and writes replies
+     * until stopped.
+     *
+     * @param listener - the worker's listening socket
+     * @param stop - stop token of the worker thread
+     */
+    void run_worker(int listener, std::stop_token stop);
+
+    /**
+     * @brief Acts on a single command line and appends the reply to the connection's output.
+     *
+     * @param connection - the connection the line was read from
+     * @param line - the line, without the line ending
+     */
+    void handle_line(Connection& connection, std::string_view line);
+
+    /**
+     * @brief Starts a new session on a connection.
+     *
+     * @param connection - the connection to start the session on
+     * @param questions - number of questions
+     * @param difficulty - difficulty of the questions
+     */
+    void start_session(Connection& connection, size_t questions,
+                       ScaleManager::Difficulty difficulty);
+
+    /**
+     * @brief Records the answer to the current question and moves on to the next one.
+     *
+     * @param connection - the connection whose session is answered
+     * @param answer - the chosen option, 1-based
+     */
+    void answer_question(Connection& connection, size_t answer);
+
+    /**
+     * @brief Makes a connection's sessions adapt to a learner, if no other connection has them.
+     *
+     * @param connection - the connection picking the learner
+     * @param learner - number of the learner
+     */
+    void select_learner(Connection& connection, size_t learner);
+
+    /**
+     * @brief Lets go of the learner of a connection, if any, so another connection can pick them.
+     *
+     * @param connection - the connection whose learner is released
+     */
+    void release_learner(Connection& connection);
+
+    /**
+     * @brief Drops the session of a connection, if any, and frees everything it allocated.
+     *
+     * @param connection - the connection whose session ends
+     */
+    void end_session(Connection& connection);
+
+    /**
+     * @brief Closes every listening socket.
+     *
+     */
+    void close_listeners();
+
+    /**
+     * @brief Writes out and closes the results sink, if open; errors are reported on std::cerr.
+     *
+     */
+    void close_results();
+
+   public:
+    /**
+     * @brief Construct a new Session Server object, which doesn't listen until start(). Opens the
+     * learner file, if any, which throws an std::runtime_error exception if it can't be.
+     *
+     * @param sm - the loaded scales every session is generated from
+     * @param options - reference to how to listen and what sessions to serve
+     */
+    SessionServer(std::shared_ptr<const ScaleManager> sm, const Options& options);
+
+    SessionServer(const SessionServer&) = delete;
+    SessionServer& operator=(const SessionServer&) = delete;
+
+    /**
+     * @brief Destroy the Session Server object, stopping it first.
+     *
+     */
+    ~SessionServer();
+
+    /**
+     * @brief Opens the results file, if any, binds the listening sockets and starts the worker
+     * threads.
+     *
+     * Throws std::runtime_error if the results file can't be appended to (see ResultsSink) or the
+     * address can't be bound.
+     */
+    void start();
+
+    /**
+     * @brief Stops the worker threads, closes every connection and writes out the results of the
+     * finished sessions; sessions in progress are lost.
+     *
+     */
+    void stop();
+
+    /**
+     * @brief Blocks SIGINT and SIGTERM for the calling thread and every thread it starts later.
+     *
+     * Call on the main thread before start(), so that wait_for_termination_signal() is the only
+     * place those signals arrive.
+     */
+    static void block_termination_signals();
+
+    /**
+     * @brief Waits until the process gets SIGINT or SIGTERM (blocked by block_termination_signals).
+     *
+     */
+    static void wait_for_termination_signal();
+
+    /**
+     * @brief Returns the port the server listens on (the actual one, if 0 was asked for).
+     *
+     * @return std::uint16_t
+     */
+    inline std::uint16_t port() const { return _port; }
+
+    /**
+     * @brief Get the answer times of every session so far; scales are told apart for the scales
+     * loaded when the server was constructed.
+     *
+     * @return const LatencyStats&
+     */
+    inline const LatencyStats& answer_times() const { return _answer_times; }
+
+    /**
+     * @brief Get how long handling each command took so far, from reading its line until its
+     * reply was ready to send: the server's own overhead, without the network.
+     *
+     * @return const LatencyHistogram&
+     */
+    inline const LatencyHistogram& command_times() const { return _command_times; }
+
+    /**
+     * @brief Writes the percentiles of the answer and command times so far.
+     *
+     * @param stream - reference to the output stream to write to
+     */
+    void write_latency_report(std::ostream& stream) const;
+};
+
+#endif
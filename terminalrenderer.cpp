@@ -0,0 +1,75 @@
+#include "terminalrenderer.hpp"
+
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+#include "constants.hpp"
+#include "musiclibrary.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+
+#include <cerrno>
+#else
+#include <cstdio>
+#endif
+
+void TerminalRenderer::render(const std::vector<std::string>& lines)
+{
+    _output.clear();
+    auto out = std::back_inserter(_output);
+    if (!_drawn) out = format_string_to(out, "\033[2J");
+
+    for (size_t row = 0; row < lines.size(); ++row)
+    {
+        if (_drawn && row < _previous.size() && _previous[row] == lines[row]) continue;
+        // Rows are 1-based; \033[K clears what is left of a longer old line
+        out = format_string_to(out, "\033[");
+        out = format_integer_to(out, row + 1);
+        out = format_string_to(out, ";1H");
+        out = format_string_to(out, lines[row]);
+        out = format_string_to(out, "\033[K");
+    }
+
+    // Leaves the cursor below the frame, and clears whatever is left there
+    out = format_string_to(out, "\033[");
+    out = format_integer_to(out, lines.size() + 1);
+    out = format_string_to(out, ";1H\033[J");
+
+    // Copy-assigning the lines reuses their buffers
+    _previous.resize(lines.size());
+    for (size_t row = 0; row < lines.size(); ++row) _previous[row] = lines[row];
+    _drawn = true;
+
+    std::cout.flush();
+    write_output();
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+void TerminalRenderer::write_output()
+{
+    // A terminal takes it all at once, a pipe may only take part of it
+    std::string_view remaining{_output};
+    while (!remaining.empty())
+    {
+        ssize_t written = ::write(STDOUT_FILENO, remaining.data(), remaining.size());
+        if (written < 0)
+        {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(TERMINAL_WRITE_FAILED);
+        }
+        remaining.remove_prefix(static_cast<size_t>(written));
+    }
+}
+#else
+void TerminalRenderer::write_output()
+{
+    if (std::fwrite(_output.data(), 1, _output.size(), stdout) != _output.size() ||
+        std::fflush(stdout) != 0)
+    {
+        throw std::runtime_error(TERMINAL_WRITE_FAILED);
+    }
+}
+#endif
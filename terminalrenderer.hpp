@@ -0,0 +1,57 @@
+#ifndef TERMINALRENDERER
+#define TERMINALRENDERER
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Draws frames of text lines on the terminal, redrawing only the lines that changed.
+ *
+ * The first frame clears the screen. Every later one moves the cursor to each line that differs
+ * from the previous frame and overwrites it (clearing what is left of the old line), then clears
+ * everything below the frame, which also removes the echo of whatever was typed after the last
+ * frame. The whole frame is composed into one buffer and handed to standard output with a single
+ * write, so a frame costs one system call and is never seen half drawn, even over a slow SSH
+ * connection. std::cout is flushed first, so anything printed through it before stays in order.
+ *
+ * A frame should fit on the screen: lines are addressed by absolute row from the top left corner,
+ * so lines that make the terminal scroll end up drawn in the wrong place.
+ */
+class TerminalRenderer
+{
+   private:
+    // What is on the screen, line by line
+    std::vector<std::string> _previous;
+    // Whether anything was drawn yet, before which the screen is cleared
+    bool _drawn = false;
+    // Reused for composing every frame, so drawing allocates nothing once warmed up
+    std::string _output;
+
+    /**
+     * @brief Writes all of _output to standard output. Throws an std::runtime_error exception if
+     * that fails.
+     *
+     */
+    void write_output();
+
+   public:
+    /**
+     * @brief Draws a frame, replacing the previous one.
+     *
+     * @param lines - the lines of the frame, without line endings
+     */
+    void render(const std::vector<std::string>& lines);
+
+    /**
+     * @brief Forgets what is on the screen, so the next frame clears it and is drawn in full (e.g.
+     * after something else was printed).
+     *
+     */
+    inline void invalidate()
+    {
+        _previous.clear();
+        _drawn = false;
+    }
+};
+
+#endif
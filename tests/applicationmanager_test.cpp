@@ -0,0 +1,67 @@
+#include <stdexcept>
+
+#include "applicationmanager.hpp"
+#include "check.hpp"
+
+/*
+ * Switching between lazy and eager sessions on the same ApplicationManager.
+ */
+
+namespace
+{
+void answer_all(ApplicationManager& am)
+{
+    while (am.can_print_more())
+    {
+        am.submit_answer(1);
+        am.next_question();
+    }
+}
+
+bool generate_throws(ApplicationManager& am, size_t questions)
+{
+    try
+    {
+        am.generate_session(questions, ScaleManager::Difficulty::MEDIUM);
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+void test_eager_session_after_lazy_one()
+{
+    ApplicationManager am;
+    am.set_seed(1);
+    am.load_default_scales();
+
+    am.generate_lazy_session(3, ScaleManager::Difficulty::MEDIUM);
+    am.submit_answer(1);
+    am.next_question();
+    // Still in progress, so it can't be added to
+    CHECK(generate_throws(am, 2));
+    answer_all(am);
+
+    // Once finished, it is replaced with a fresh eager session
+    CHECK(!generate_throws(am, 2));
+    CHECK(am.number_of_questions() == 2);
+    CHECK(am.get_correct() == 0);
+    CHECK(am.can_print_more());
+    answer_all(am);
+
+    // Which can be added to and lazily replaced as before
+    CHECK(!generate_throws(am, 1));
+    CHECK(am.number_of_questions() == 3);
+    answer_all(am);
+    am.generate_lazy_session(2, ScaleManager::Difficulty::MEDIUM);
+    CHECK(am.number_of_questions() == 2);
+}
+}  // namespace
+
+int main()
+{
+    test_eager_session_after_lazy_one();
+    return check::result();
+}
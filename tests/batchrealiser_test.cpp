@@ -0,0 +1,113 @@
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "batchrealiser.hpp"
+#include "check.hpp"
+#include "defaultcatalogue.hpp"
+#include "musiclibrary.hpp"
+#include "scalecatalogue.hpp"
+#include "syntheticcatalogue.hpp"
+
+/*
+ * BatchRealiser has to give the same notes as PackedRealisedScale and RealisedScale, for every
+ * root and scale, with the best kernel built (SIMD where the standard library has it) as well as
+ * the scalar one.
+ */
+
+namespace
+{
+/**
+ * @brief Every spelling with up to two accidentals, in several octaves.
+ *
+ */
+std::vector<PackedNote> all_roots()
+{
+    std::vector<PackedNote> roots;
+    for (int octave = 1; octave <= 6; ++octave)
+    {
+        for (scale_degree_value base = 0; base < NUMBER_OF_SCALE_DEGREES; ++base)
+        {
+            for (accidentals_value accidentals = -2; accidentals <= 2; ++accidentals)
+            {
+                midi_value midi = MIDDLE_C_MIDI + (octave - MIDDLE_C_OCTAVE) * NOTES_PER_OCTAVE +
+                                  scale_degree_to_midi_diff[base] + accidentals;
+                roots.emplace_back(Spelling{base, accidentals}, midi);
+            }
+        }
+    }
+    return roots;
+}
+
+/**
+ * @brief Scales past the octave and with double accidentals, which the shipped ones barely have.
+ *
+ */
+ScaleCatalogue compound_scales()
+{
+    ScaleCatalogue catalogue;
+    for (auto&& scale : {"1,b9,#11,13,15", "1,bb3,##4,bb7,8", "1,#2,##9,b13,bb14,16,22"})
+    {
+        catalogue.add(catalogue.intern_name(scale), 0, Scale{scale}.degrees());
+    }
+    return catalogue;
+}
+
+void check_catalogue(const ScaleCatalogue& catalogue, BatchRealiser::Kernel kernel)
+{
+    std::vector<PackedNote> roots = all_roots();
+    BatchRealiser batch{roots, kernel};
+    CHECK(batch.number_of_roots() == roots.size());
+
+    size_t mismatches = 0;
+    std::vector<PackedNote> expected;
+    for (size_t i = 0; i < catalogue.size(); ++i)
+    {
+        std::span<const Scale::scale_degree> degrees = catalogue.degrees(i);
+        batch.realise(degrees);
+        CHECK(batch.number_of_degrees() == degrees.size());
+
+        for (size_t r = 0; r < roots.size(); ++r)
+        {
+            expected.clear();
+            PackedRealisedScale::realise_scale(roots[r], degrees, std::back_inserter(expected));
+            RealisedScale realised{Note{roots[r]}, degrees};
+
+            auto unpacked = realised.begin();
+            for (size_t d = 0; d < degrees.size(); ++d, ++unpacked)
+            {
+                PackedNote note = batch.note(r, d);
+                if (note == expected[d] && PackedNote{*unpacked} == expected[d]) continue;
+                // Only the first few, a broken kernel would flood the output otherwise
+                if (mismatches++ < 5)
+                {
+                    std::cerr << catalogue.name(i) << " on " << roots[r] << ", degree " << d + 1
+                              << ": " << note << " instead of " << expected[d] << " / "
+                              << *unpacked << std::endl;
+                }
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+}
+}  // namespace
+
+int main()
+{
+    SyntheticCatalogue::Options options;
+    options._number_of_scales = 2000;
+    options._min_degrees = 1;
+    options._max_degrees = SyntheticCatalogue::MAX_DEGREES;
+    options._max_accidentals = 2;
+    ScaleCatalogue synthetic = SyntheticCatalogue::generate(options);
+
+    for (auto kernel : {BatchRealiser::Kernel::BEST, BatchRealiser::Kernel::SCALAR})
+    {
+        check_catalogue(DefaultCatalogue::build(), kernel);
+        check_catalogue(compound_scales(), kernel);
+        check_catalogue(synthetic, kernel);
+    }
+    return check::result();
+}
@@ -0,0 +1,39 @@
+#ifndef TESTS_CHECK
+#define TESTS_CHECK
+
+#include <cstdlib>
+#include <iostream>
+
+/*
+ * The tests are plain executables run by ctest: every failed CHECK prints where it failed, and
+ * the test fails if any did.
+ */
+
+namespace check
+{
+inline int failures = 0;
+
+/**
+ * @brief Returns the exit code of a test: non-zero if any CHECK failed.
+ *
+ * @return int
+ */
+inline int result()
+{
+    if (failures > 0) std::cerr << failures << " check(s) failed" << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+}  // namespace check
+
+#define CHECK(condition)                                                                  \
+    do                                                                                    \
+    {                                                                                     \
+        if (!(condition))                                                                 \
+        {                                                                                 \
+            ++check::failures;                                                            \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": CHECK(" #condition ") failed" \
+                      << std::endl;                                                       \
+        }                                                                                 \
+    } while (false)
+
+#endif
@@ -0,0 +1,82 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+#include "check.hpp"
+#include "learnermodel.hpp"
+#include "randomengine.hpp"
+#include "scalecatalogue.hpp"
+#include "scalemanager.hpp"
+
+/*
+ * Sampling through a LearnerModel: draws follow the snapshot's weights times the learner's need,
+ * and an answer counts from the very next draw.
+ */
+
+namespace
+{
+constexpr std::array<Scale::scale_degree, 3> DEGREES{{{1, 0}, {2, 0}, {3, -1}}};
+constexpr size_t NUMBER_OF_SCALES = 4;
+constexpr size_t DRAWS = 40000;
+
+std::shared_ptr<const ScaleManager::Snapshot> loaded_snapshot()
+{
+    ScaleCatalogue catalogue;
+    for (std::string_view name : {"A", "B", "C", "D"})
+    {
+        catalogue.add(catalogue.intern_name(name), 0, DEGREES);
+    }
+    ScaleManager sm;
+    sm.load_catalogue(std::move(catalogue));
+    return sm.snapshot();
+}
+
+std::array<double, NUMBER_OF_SCALES> frequencies(LearnerModel& model, RandomEngine& gen)
+{
+    std::array<double, NUMBER_OF_SCALES> drawn{};
+    for (size_t i = 0; i < DRAWS; ++i) drawn[model.sample_scale_index(gen)] += 1.0 / DRAWS;
+    return drawn;
+}
+
+void test_needs_weight_the_draws()
+{
+    LearnerModel::State state{};
+    LearnerModel model{state, loaded_snapshot(), ScaleManager::Difficulty::EASY};
+    RandomEngine gen{1};
+
+    // A new learner needs every scale the same
+    for (double frequency : frequencies(model, gen))
+    {
+        CHECK(frequency > 0.22 && frequency < 0.28);
+    }
+
+    // Answered quickly and correctly on every root, a scale comes up far less often at once
+    for (size_t repeat = 0; repeat < 20; ++repeat)
+    {
+        for (size_t r = 0; r < ScaleManager::number_of_roots(); ++r)
+        {
+            if (ScaleManager::root_weight(ScaleManager::Difficulty::EASY, r) == 0.0) continue;
+            model.record(0, r, true, std::chrono::milliseconds{100});
+        }
+    }
+    auto adapted = frequencies(model, gen);
+    CHECK(adapted[0] < 0.08);
+    for (size_t i = 1; i < NUMBER_OF_SCALES; ++i) CHECK(adapted[i] > 0.28);
+
+    // Roots never sampled by the snapshot aren't sampled by the model either
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        size_t root_index = model.sample_root_index(gen);
+        CHECK(ScaleManager::root_weight(ScaleManager::Difficulty::EASY, root_index) > 0.0);
+    }
+}
+}  // namespace
+
+int main()
+{
+    test_needs_weight_the_draws();
+    return check::result();
+}
@@ -0,0 +1,57 @@
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "check.hpp"
+#include "namepool.hpp"
+
+/*
+ * Interning into a NamePool: equal strings share an id, and views stay valid as the pool grows
+ * and moves.
+ */
+
+namespace
+{
+void test_empty_names()
+{
+    // First into a new pool, which has no block yet
+    NamePool pool;
+    CHECK(pool.intern("") == 0);
+    CHECK(pool.intern("") == 0);
+    CHECK(pool.view(0).empty());
+    CHECK(pool.intern("Major") == 1);
+    CHECK(pool.view(1) == "Major");
+
+    // And into a pool left empty by a move
+    NamePool moved{std::move(pool)};
+    CHECK(moved.view(1) == "Major");
+    CHECK(pool.size() == 0);
+    CHECK(pool.intern("") == 0);
+    CHECK(pool.intern("Minor") == 1);
+    CHECK(pool.view(1) == "Minor");
+}
+
+void test_views_stay_valid()
+{
+    NamePool pool;
+    std::string_view first = pool.view(pool.intern("Dorian"));
+    // Enough to fill several blocks, and one longer than a block
+    for (size_t i = 0; i < 2000; ++i) pool.intern("Scale " + std::to_string(i));
+    std::string long_name(5000, 'x');
+    NamePool::NameId long_id = pool.intern(long_name);
+
+    NamePool moved{std::move(pool)};
+    CHECK(first == "Dorian");
+    CHECK(moved.view(0).data() == first.data());
+    CHECK(moved.view(long_id) == long_name);
+    CHECK(moved.intern("Scale 1999") == 2000);
+    CHECK(moved.size() == 2002);
+}
+}  // namespace
+
+int main()
+{
+    test_empty_names();
+    test_views_stay_valid();
+    return check::result();
+}
@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "check.hpp"
+#include "constants.hpp"
+#include "resultssink.hpp"
+
+/*
+ * Appending to results files: only ever to a file of the same format and version.
+ */
+
+namespace
+{
+const ResultsSink::Result RESULT{"C", "Major", 0, true, 1200};
+
+std::string read_file(const std::string& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+void write_file(const std::string& path, const std::string& contents)
+{
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file << contents;
+}
+
+bool append_throws(const std::string& path, ResultsSink::Format format)
+{
+    ResultsSink::Options options;
+    options._format = format;
+    options._append = true;
+    try
+    {
+        ResultsSink sink{path, options};
+        sink.write(RESULT);
+        sink.close();
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+void test_csv_append(const std::string& path)
+{
+    write_file(path, "");
+    CHECK(!append_throws(path, ResultsSink::Format::CSV));
+    CHECK(!append_throws(path, ResultsSink::Format::CSV));
+    CHECK(read_file(path) == std::string{RESULTS_FILE_HEADER} +
+                                 "\nC Major;0;CORRECT;1200\nC Major;0;CORRECT;1200\n");
+
+    // A file from before the Milliseconds column is left alone
+    std::string old_file = "Name;Difficulty;Correctness\nC Major;0;CORRECT\n";
+    write_file(path, old_file);
+    CHECK(append_throws(path, ResultsSink::Format::CSV));
+    CHECK(read_file(path) == old_file);
+
+    write_file(path, "");
+    CHECK(!append_throws(path, ResultsSink::Format::CSV));
+    CHECK(append_throws(path, ResultsSink::Format::COLUMNAR));
+}
+
+void test_columnar_append(const std::string& path)
+{
+    write_file(path, "");
+    CHECK(!append_throws(path, ResultsSink::Format::COLUMNAR));
+    CHECK(!append_throws(path, ResultsSink::Format::COLUMNAR));
+    CHECK(append_throws(path, ResultsSink::Format::CSV));
+
+    // The same magic with the version before
+    std::string contents = read_file(path);
+    std::uint32_t old_version = ResultsSink::COLUMNAR_VERSION - 1;
+    std::memcpy(contents.data() + 8, &old_version, sizeof(old_version));
+    write_file(path, contents);
+    CHECK(append_throws(path, ResultsSink::Format::COLUMNAR));
+
+    // Truncated within the header
+    write_file(path, "SCALERES");
+    CHECK(append_throws(path, ResultsSink::Format::COLUMNAR));
+}
+}  // namespace
+
+int main()
+{
+    std::string path =
+        (std::filesystem::temp_directory_path() / "scales_resultssink_test").string();
+    test_csv_append(path);
+    test_columnar_append(path);
+    std::filesystem::remove(path);
+    return check::result();
+}
@@ -0,0 +1,89 @@
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "check.hpp"
+#include "scalecatalogue.hpp"
+#include "scalemanager.hpp"
+
+/*
+ * Reading compiled catalogues: whatever a file holds, only catalogues the rest of the program can
+ * index into safely are read.
+ */
+
+namespace
+{
+constexpr std::array<Scale::scale_degree, 3> DEGREES{{{1, 0}, {2, 0}, {3, -1}}};
+
+std::string compiled_bytes(std::initializer_list<ScaleCatalogue::difficulty_value> difficulties)
+{
+    ScaleCatalogue catalogue;
+    size_t i = 0;
+    for (auto difficulty : difficulties)
+    {
+        catalogue.add(catalogue.intern_name("Scale " + std::to_string(i++)), difficulty, DEGREES);
+    }
+    catalogue.sort_by_difficulty();
+    std::ostringstream stream;
+    catalogue.write_compiled(stream);
+    return stream.str();
+}
+
+bool read_throws(std::string_view bytes, size_t number_of_difficulties)
+{
+    try
+    {
+        ScaleCatalogue::read_compiled(bytes, number_of_difficulties);
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+void test_difficulties_are_checked()
+{
+    std::string bytes = compiled_bytes({0, 2, 1, 2});
+    CHECK(!read_throws(bytes, ScaleManager::NUMBER_OF_DIFFICULTIES));
+    CHECK(ScaleCatalogue::read_compiled(bytes, ScaleManager::NUMBER_OF_DIFFICULTIES).size() == 4);
+    CHECK(read_throws(bytes, 2));
+
+    // A well-formed file with a difficulty ScaleManager doesn't know of doesn't load either
+    bytes = compiled_bytes({0, 1, 2, 3});
+    CHECK(read_throws(bytes, ScaleManager::NUMBER_OF_DIFFICULTIES));
+    CHECK(!read_throws(bytes, ScaleManager::NUMBER_OF_DIFFICULTIES + 1));
+
+    auto path = std::filesystem::temp_directory_path() /
+                ("scalecatalogue_test_" + std::to_string(std::random_device{}()) + ".bin");
+    {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        file << bytes;
+    }
+    ScaleManager sm;
+    bool threw = false;
+    try
+    {
+        sm.load_scales_from_file(path.string());
+    }
+    catch (const std::runtime_error& e)
+    {
+        threw = std::string_view{e.what()} == BAD_COMPILED_CATALOGUE;
+    }
+    CHECK(threw);
+    CHECK(sm.number_of_scales() == 0);
+    std::filesystem::remove(path);
+}
+}  // namespace
+
+int main()
+{
+    test_difficulties_are_checked();
+    return check::result();
+}
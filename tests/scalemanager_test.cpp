@@ -0,0 +1,114 @@
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "check.hpp"
+#include "scalecatalogue.hpp"
+#include "scalemanager.hpp"
+
+/*
+ * Loading scales into a ScaleManager: names have to be unique across everything loaded, and
+ * reloads replace the scales only once the whole file has loaded.
+ */
+
+namespace
+{
+constexpr std::array<Scale::scale_degree, 3> DEGREES{{{1, 0}, {2, 0}, {3, -1}}};
+
+ScaleCatalogue catalogue_of(std::initializer_list<std::string_view> names)
+{
+    ScaleCatalogue catalogue;
+    for (auto&& name : names) catalogue.add(catalogue.intern_name(name), 0, DEGREES);
+    return catalogue;
+}
+
+bool load_throws(ScaleManager& sm, ScaleCatalogue catalogue)
+{
+    try
+    {
+        sm.load_catalogue(std::move(catalogue));
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+void test_duplicate_names_are_rejected()
+{
+    ScaleManager sm;
+    CHECK(load_throws(sm, catalogue_of({"A", "B", "A", "C"})));
+    CHECK(sm.number_of_scales() == 0);
+
+    CHECK(!load_throws(sm, catalogue_of({"A", "B", "C", "D"})));
+    CHECK(sm.number_of_scales() == 4);
+
+    // Also against the scales loaded before, which stay as they were
+    CHECK(load_throws(sm, catalogue_of({"E", "B"})));
+    CHECK(sm.number_of_scales() == 4);
+    CHECK(!load_throws(sm, catalogue_of({"E", "F"})));
+    CHECK(sm.number_of_scales() == 6);
+
+    CHECK(catalogue_of({"A", "B", "C"}).find_duplicate_name() == std::nullopt);
+    CHECK(catalogue_of({"A", "B", "B", "A"}).find_duplicate_name() == 2);
+}
+
+void test_reload_reads_whole_files()
+{
+    auto stem = std::filesystem::temp_directory_path() /
+                ("scalemanager_test_" + std::to_string(std::random_device{}()));
+    std::string csv_path = stem.string() + ".csv";
+    std::string compiled_path = stem.string() + ".bin";
+    {
+        std::ofstream file{csv_path, std::ios::trunc};
+        file << "Name;Difficulty;Scale\nA;Easy;1,2,b3\nB;Medium;1,2,3\nC;Hard;1,b2,b3\n"
+             << "D;Hard;1,2,#4\n";
+    }
+
+    // Reloads read the file into memory rather than mapping it, csv and compiled alike
+    ScaleManager sm;
+    sm.load_catalogue(catalogue_of({"X"}));
+    sm.reload_scales_from_file(csv_path);
+    CHECK(sm.number_of_scales() == 4);
+    sm.save_compiled_catalogue(compiled_path);
+    sm.load_catalogue(catalogue_of({"E"}));
+    CHECK(sm.number_of_scales() == 5);
+    sm.reload_scales_from_file(compiled_path);
+    CHECK(sm.number_of_scales() == 4);
+
+    // A file that doesn't load leaves the scales as they were
+    {
+        std::ofstream file{csv_path, std::ios::trunc};
+        file << "Name;Difficulty;Scale\nA;Easy;1,2,b3\nB;Medium\n";
+    }
+    bool threw = false;
+    try
+    {
+        sm.reload_scales_from_file(csv_path);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(sm.number_of_scales() == 4);
+
+    std::filesystem::remove(csv_path);
+    std::filesystem::remove(compiled_path);
+}
+}  // namespace
+
+int main()
+{
+    test_duplicate_names_are_rejected();
+    test_reload_reads_whole_files();
+    return check::result();
+}
@@ -0,0 +1,198 @@
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "check.hpp"
+#include "scalemanager.hpp"
+#include "sessionserver.hpp"
+
+/*
+ * Talks the serve mode protocol to a SessionServer on a free port, the way a client would.
+ */
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace
+{
+/**
+ * @brief Sends request on a new connection, shuts down the sending side and returns everything
+ * the server replied until it closed the connection.
+ *
+ */
+std::string exchange(std::uint16_t port, std::string_view request)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    // A server that never closes fails the test instead of hanging it
+    timeval timeout{5, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    ::inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    std::string reply;
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0)
+    {
+        ::send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+        ::shutdown(fd, SHUT_WR);
+        char buffer[4096];
+        ssize_t received;
+        while ((received = ::recv(fd, buffer, sizeof(buffer), 0)) > 0)
+        {
+            reply.append(buffer, static_cast<size_t>(received));
+        }
+    }
+    ::close(fd);
+    return reply;
+}
+
+std::vector<std::string> split_lines(std::string_view reply)
+{
+    std::vector<std::string> lines;
+    size_t end;
+    while ((end = reply.find('\n')) != std::string_view::npos)
+    {
+        lines.emplace_back(reply.substr(0, end));
+        reply.remove_prefix(end + 1);
+    }
+    return lines;
+}
+
+bool starts_with(const std::string& line, std::string_view prefix)
+{
+    return std::string_view{line}.substr(0, prefix.size()) == prefix;
+}
+
+SessionServer::Options test_options()
+{
+    SessionServer::Options options;
+    options._port = 0;
+    options._seed = 1;
+    return options;
+}
+
+void test_commands_before_half_close_are_answered(std::shared_ptr<const ScaleManager> sm)
+{
+    SessionServer server{sm, test_options()};
+    server.start();
+
+    auto lines = split_lines(exchange(server.port(), "START 2 0\nANSWER 1\n"));
+    CHECK(lines.size() == 3);
+    if (lines.size() == 3)
+    {
+        CHECK(starts_with(lines[0], "QUESTION 1/2;"));
+        CHECK(lines[1] == CORRECT || lines[1] == INCORRECT);
+        CHECK(starts_with(lines[2], "QUESTION 2/2;"));
+    }
+
+    // A last line without its line break is dropped, not half-handled
+    lines = split_lines(exchange(server.port(), "START 1 0\nANSWER"));
+    CHECK(lines.size() == 1 && starts_with(lines[0], "QUESTION 1/1;"));
+}
+
+void test_nothing_is_read_after_quit(std::shared_ptr<const ScaleManager> sm)
+{
+    SessionServer server{sm, test_options()};
+    server.start();
+
+    auto lines = split_lines(exchange(server.port(), "QUIT\nSTART 1 0\n"));
+    CHECK(lines.size() == 1 && lines[0] == "BYE");
+}
+
+void test_errors_keep_the_connection(std::shared_ptr<const ScaleManager> sm)
+{
+    SessionServer server{sm, test_options()};
+    server.start();
+
+    auto lines = split_lines(exchange(server.port(), "ANSWER 1\nSTART 0\nHELLO\nSTART 1 0\n"));
+    CHECK(lines.size() == 4);
+    if (lines.size() == 4)
+    {
+        CHECK(lines[0] == SERVE_NO_SESSION);
+        CHECK(lines[1] == SERVE_BAD_ARGUMENTS);
+        CHECK(lines[2] == SERVE_UNKNOWN_COMMAND);
+        CHECK(starts_with(lines[3], "QUESTION 1/1;"));
+    }
+}
+
+void test_seeded_sessions_repeat(std::shared_ptr<const ScaleManager> sm)
+{
+    // Session n of a seed is the same on every server, whatever the other sessions were
+    std::vector<std::string> first;
+    std::vector<std::string> second;
+    {
+        SessionServer server{sm, test_options()};
+        server.start();
+        for (int i = 0; i < 3; ++i) first.push_back(exchange(server.port(), "START 3 2\n"));
+    }
+    {
+        SessionServer server{sm, test_options()};
+        server.start();
+        for (int i = 0; i < 3; ++i) second.push_back(exchange(server.port(), "START 3 2\n"));
+    }
+    CHECK(first == second);
+    CHECK(first[0] != first[1] || first[1] != first[2]);
+}
+
+std::vector<std::string> read_lines(const std::filesystem::path& path)
+{
+    std::ifstream file{path};
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return split_lines(contents.str());
+}
+
+void test_finished_sessions_are_kept(std::shared_ptr<const ScaleManager> sm)
+{
+    auto path = std::filesystem::temp_directory_path() /
+                ("sessionserver_test_" + std::to_string(::getpid()) + ".csv");
+    std::filesystem::remove(path);
+    SessionServer::Options options = test_options();
+    options._results_path = path.string();
+
+    // Every server appends to the same file, which only has the header once
+    for (size_t servers = 1; servers <= 2; ++servers)
+    {
+        SessionServer server{sm, options};
+        server.start();
+        exchange(server.port(), "START 2 0\nANSWER 1\nANSWER 1\n");
+        // Unfinished sessions keep no results
+        exchange(server.port(), "START 2 0\nANSWER 1\n");
+        server.stop();
+
+        auto lines = read_lines(path);
+        CHECK(lines.size() == 1 + 2 * servers);
+        if (!lines.empty()) CHECK(lines[0] == RESULTS_FILE_HEADER);
+    }
+    std::filesystem::remove(path);
+}
+}  // namespace
+
+int main()
+{
+    auto sm = std::make_shared<ScaleManager>();
+    sm->load_default_scales();
+
+    test_commands_before_half_close_are_answered(sm);
+    test_nothing_is_read_after_quit(sm);
+    test_errors_keep_the_connection(sm);
+    test_seeded_sessions_repeat(sm);
+    test_finished_sessions_are_kept(sm);
+    return check::result();
+}
+#else
+int main()
+{
+    // Tells ctest the test was skipped
+    return 77;
+}
+#endif
@@ -0,0 +1,78 @@
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "argparse.hpp"
+#include "constants.hpp"
+#include "scalemanager.hpp"
+#include "syntheticcatalogue.hpp"
+
+/*
+ * Writes a synthetic catalogue of random scales (see SyntheticCatalogue) as a scales .csv file, a
+ * compiled catalogue or both, for trying out and benchmarking ScaleManager at sizes far beyond
+ * scales.csv, e.g.
+ *
+ *     scales_generate -n 1000000 --csv big.csv --compiled big.bin
+ */
+
+/**
+ * @brief Command line arguments of the generator.
+ *
+ */
+struct GenerateArgs : public argparse::Args
+{
+    size_t& number_of_scales = kwarg("n", "Number of scales to generate").set_default(1000);
+    std::uint64_t& seed = kwarg("seed", "Seed, the same seed gives the same scales").set_default(0);
+    double& easy = kwarg("easy", "Relative share of Easy scales").set_default(1.0);
+    double& medium = kwarg("medium", "Relative share of Medium scales").set_default(1.0);
+    double& hard = kwarg("hard", "Relative share of Hard scales").set_default(1.0);
+    size_t& min_degrees =
+        kwarg("min-degrees", "Fewest degrees of a scale, root included").set_default(5);
+    size_t& max_degrees =
+        kwarg("max-degrees", "Most degrees of a scale, root included (up to 12)").set_default(8);
+    int& max_accidentals =
+        kwarg("max-accidentals", "Most accidentals on a degree (1 or 2)").set_default(1);
+    std::optional<std::string>& csv_path = kwarg("csv", "Write the scales to this .csv file");
+    std::optional<std::string>& compiled_path =
+        kwarg("compiled", "Write the scales to this compiled catalogue");
+};
+
+int main(int argc, char* argv[])
+{
+    auto args = argparse::parse<GenerateArgs>(argc, argv);
+    if (!args.csv_path.has_value() && !args.compiled_path.has_value())
+    {
+        args.help();
+        return 1;
+    }
+
+    SyntheticCatalogue::Options options;
+    options._number_of_scales = args.number_of_scales;
+    options._seed = args.seed;
+    options._difficulty_mix = {args.easy, args.medium, args.hard};
+    options._min_degrees = args.min_degrees;
+    options._max_degrees = args.max_degrees;
+    options._max_accidentals = args.max_accidentals;
+    ScaleCatalogue catalogue = SyntheticCatalogue::generate(options);
+
+    // Written before loading, which sorts the scales by difficulty
+    if (args.csv_path.has_value())
+    {
+        std::ofstream file{args.csv_path.value(), std::ios::trunc};
+        SyntheticCatalogue::write_csv(catalogue, file);
+        if (!file.good())
+        {
+            throw std::runtime_error(BAD_FILE_OPEN);
+        }
+    }
+    if (args.compiled_path.has_value())
+    {
+        ScaleManager sm;
+        sm.load_catalogue(std::move(catalogue));
+        sm.save_compiled_catalogue(args.compiled_path.value());
+    }
+    return 0;
+}
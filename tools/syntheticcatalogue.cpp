@@ -0,0 +1,130 @@
+#include "syntheticcatalogue.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <format>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "constants.hpp"
+#include "musiclibrary.hpp"
+#include "randomengine.hpp"
+#include "weightedsampler.hpp"
+
+namespace
+{
+constexpr std::array<std::string_view, ScaleManager::NUMBER_OF_DIFFICULTIES> difficulty_names{
+    "Easy", "Medium", "Hard"};
+
+// Every pitch class above the root, in semitones
+constexpr size_t NUMBER_OF_UPPER_PITCH_CLASSES = SyntheticCatalogue::MAX_DEGREES - 1;
+
+/**
+ * @brief Spells the pitch class semitones above the root as a random scale degree other than the
+ * root, at most max_accidentals away from it.
+ *
+ */
+Scale::scale_degree spell_pitch_class(int semitones, int max_accidentals, RandomEngine& gen)
+{
+    std::array<Scale::scale_degree, NUMBER_OF_SCALE_DEGREES> spellings;
+    size_t number_of_spellings = 0;
+    for (scale_degree_value base = 1; base < NUMBER_OF_SCALE_DEGREES; ++base)
+    {
+        int accidentals = semitones - scale_degree_to_midi_diff[base];
+        if (std::abs(accidentals) <= max_accidentals)
+        {
+            // Scale degrees count from 1
+            spellings[number_of_spellings++] = {base + 1,
+                                                static_cast<accidentals_value>(accidentals)};
+        }
+    }
+    // Every pitch class is within a single accidental of a degree, so there is always one
+    return spellings[gen() % number_of_spellings];
+}
+}  // namespace
+
+ScaleCatalogue SyntheticCatalogue::generate(const Options& options)
+{
+    if (options._min_degrees < 1 || options._max_degrees > MAX_DEGREES ||
+        options._min_degrees > options._max_degrees)
+    {
+        throw std::invalid_argument(SYNTHETIC_BAD_DEGREES);
+    }
+    if (options._max_accidentals < 1 || options._max_accidentals > 2)
+    {
+        throw std::invalid_argument(SYNTHETIC_BAD_ACCIDENTALS);
+    }
+    const auto& mix = options._difficulty_mix;
+    if (std::any_of(mix.begin(), mix.end(), [](double share) { return !(share >= 0.0); }) ||
+        std::accumulate(mix.begin(), mix.end(), 0.0) <= 0.0)
+    {
+        throw std::invalid_argument(SYNTHETIC_BAD_MIX);
+    }
+
+    RandomEngine gen{options._seed};
+    WeightedSampler difficulties{mix};
+    size_t degree_choices = options._max_degrees - options._min_degrees + 1;
+
+    ScaleCatalogue catalogue;
+    std::array<int, NUMBER_OF_UPPER_PITCH_CLASSES> pitch_classes;
+    std::vector<Scale::scale_degree> degrees;
+    degrees.reserve(MAX_DEGREES);
+    std::string name{"Synthetic "};
+    size_t prefix_size = name.size();
+    for (size_t i = 0; i < options._number_of_scales; ++i)
+    {
+        size_t number_of_degrees = options._min_degrees + gen() % degree_choices;
+
+        // Partial Fisher-Yates shuffle: the first number_of_degrees - 1 are a random set of
+        // distinct pitch classes, which are then spelled from the lowest up
+        std::iota(pitch_classes.begin(), pitch_classes.end(), 1);
+        std::uint32_t chosen = 0;
+        for (size_t k = 0; k + 1 < number_of_degrees; ++k)
+        {
+            size_t pick = k + gen() % (NUMBER_OF_UPPER_PITCH_CLASSES - k);
+            std::swap(pitch_classes[k], pitch_classes[pick]);
+            chosen |= std::uint32_t{1} << pitch_classes[k];
+        }
+
+        degrees.assign(1, {1, 0});
+        for (int semitones = 1; semitones < static_cast<int>(MAX_DEGREES); ++semitones)
+        {
+            if ((chosen >> semitones & 1) == 0) continue;
+            degrees.push_back(spell_pitch_class(semitones, options._max_accidentals, gen));
+        }
+
+        name.resize(prefix_size);
+        std::format_to(std::back_inserter(name), "{}", i);
+        auto difficulty = static_cast<ScaleCatalogue::difficulty_value>(difficulties(gen));
+        catalogue.add(catalogue.intern_name(name), difficulty, degrees);
+    }
+    return catalogue;
+}
+
+void SyntheticCatalogue::write_csv(const ScaleCatalogue& catalogue, std::ostream& stream)
+{
+    std::string line;
+    stream << "Name;Difficulty;Scale\n";
+    for (size_t i = 0; i < catalogue.size(); ++i)
+    {
+        line.clear();
+        auto out = std::back_inserter(line);
+        std::format_to(out, "{}{}{}{}", catalogue.name(i), CSV_SEPERATOR,
+                       difficulty_names[catalogue.difficulty(i)], CSV_SEPERATOR);
+
+        bool first = true;
+        for (auto [degree, accidentals] : catalogue.degrees(i))
+        {
+            if (!first) line += ',';
+            first = false;
+            line.append(static_cast<size_t>(std::abs(accidentals)), accidentals < 0 ? 'b' : '#');
+            std::format_to(out, "{}", degree);
+        }
+        line += '\n';
+        stream << line;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef SYNTHETICCATALOGUE
+#define SYNTHETICCATALOGUE
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "scalecatalogue.hpp"
+#include "scalemanager.hpp"
+
+/**
+ * @brief Generates catalogues of random scales, for exercising ScaleManager with far more scales
+ * than scales.csv holds.
+ *
+ * Every scale starts on the root and adds a random set of distinct pitch classes above it, each
+ * spelled as a random scale degree that is at most _max_accidentals away from it (so e.g. the
+ * pitch class three semitones up is either b3 or #2). Scales are named "Synthetic {index}", so
+ * every name is distinct, and the same options always give the same catalogue.
+ */
+class SyntheticCatalogue
+{
+   public:
+    /**
+     * @brief The most degrees a scale can have: the root plus every other pitch class.
+     *
+     */
+    static constexpr size_t MAX_DEGREES = 12;
+
+    /**
+     * @brief Version of the generator, bumped whenever the same options generate other scales (so
+     * catalogues generated before, such as the benchmarks' cached files, are told apart).
+     *
+     */
+    static constexpr std::uint32_t VERSION = 1;
+
+    /**
+     * @brief What to generate.
+     *
+     */
+    struct Options
+    {
+        size_t _number_of_scales = 1000;
+        std::uint64_t _seed = 0;
+        // Relative share of Easy, Medium and Hard scales
+        std::array<double, ScaleManager::NUMBER_OF_DIFFICULTIES> _difficulty_mix{1.0, 1.0, 1.0};
+        // Range of the number of degrees of a scale, root included
+        size_t _min_degrees = 5;
+        size_t _max_degrees = 8;
+        // 1 allows b and #, 2 also allows bb and ##
+        int _max_accidentals = 1;
+    };
+
+    /**
+     * @brief Generates a catalogue, unsorted (scales of every difficulty are mixed, as in a
+     * hand-written file). Throws an std::invalid_argument exception if the options can't be
+     * satisfied.
+     *
+     * @param options - reference to what to generate
+     * @return ScaleCatalogue
+     */
+    static ScaleCatalogue generate(const Options& options);
+
+    /**
+     * @brief Writes a catalogue as a scales .csv file that load_scales_from_file reads back into
+     * the same scales, in the same order.
+     *
+     * @param catalogue - reference to the catalogue to write
+     * @param stream - reference to the output stream to write to
+     */
+    static void write_csv(const ScaleCatalogue& catalogue, std::ostream& stream);
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "weightedsampler.hpp"
+
+#include <numeric>
+
+WeightedSampler::WeightedSampler(std::span<const double> weights)
+{
+    std::vector<size_t> values(weights.size());
+    std::iota(values.begin(), values.end(), 0);
+    *this = WeightedSampler{values, weights};
+}
+
+// Vose's algorithm. Every weight is scaled so the average is 1, then columns with less than 1 get
+// topped up from a column with more than 1, which then becomes the alias of the smaller one.
+WeightedSampler::WeightedSampler(std::span<const size_t> values, std::span<const double> weights)
+{
+    if (values.size() != weights.size()) throw std::invalid_argument(MISMATCHED_WEIGHTS);
+
+    double total = 0;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (weights[i] < 0) throw std::invalid_argument(NEGATIVE_WEIGHT);
+        if (weights[i] == 0) continue;
+        _values.push_back(values[i]);
+        _probabilities.push_back(weights[i]);
+        total += weights[i];
+    }
+
+    size_t n = _values.size();
+    _aliases = _values;
+
+    std::vector<size_t> small;
+    std::vector<size_t> large;
+    for (size_t i = 0; i < n; ++i)
+    {
+        _probabilities[i] *= static_cast<double>(n) / total;
+        (_probabilities[i] < 1.0 ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        size_t less = small.back();
+        small.pop_back();
+        size_t more = large.back();
+
+        _aliases[less] = _values[more];
+        _probabilities[more] -= 1.0 - _probabilities[less];
+
+        if (_probabilities[more] < 1.0)
+        {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+
+    // Whatever is left is 1 up to rounding errors
+    for (auto&& i : small) _probabilities[i] = 1.0;
+    for (auto&& i : large) _probabilities[i] = 1.0;
+}
@@ -0,0 +1,96 @@
+#ifndef WEIGHTEDSAMPLER
+#define WEIGHTEDSAMPLER
+
+#include <cstdint>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "constants.hpp"
+
+/**
+ * @brief Samples values with given weights in O(1) per draw using Walker's alias method.
+ *
+ * The alias table is built once with Vose's algorithm. Every column of the table holds one value, a
+ * second 'alias' value and the probability of keeping the first one, so a draw is picking a column
+ * uniformly and then flipping a single biased coin. There is no rejection loop; values with zero
+ * weight are left out of the table entirely.
+ *
+ */
+class WeightedSampler
+{
+   private:
+    /**
+     * @brief Value returned for each column when the coin flip keeps it.
+     *
+     */
+    std::vector<size_t> _values;
+
+    /**
+     * @brief Value returned for each column when the coin flip goes to the alias.
+     *
+     */
+    std::vector<size_t> _aliases;
+
+    /**
+     * @brief Probability of keeping the column's own value.
+     *
+     */
+    std::vector<double> _probabilities;
+
+   public:
+    /**
+     * @brief Construct a new empty Weighted Sampler object; it cannot be sampled from.
+     *
+     */
+    WeightedSampler() = default;
+
+    /**
+     * @brief Construct a new Weighted Sampler object that samples the indices of the weights.
+     *
+     * @param weights - non-negative weight of each index
+     */
+    explicit WeightedSampler(std::span<const double> weights);
+
+    /**
+     * @brief Construct a new Weighted Sampler object that samples the given values.
+     *
+     * @param values - the values to sample from
+     * @param weights - non-negative weight of each value, same length as values
+     */
+    WeightedSampler(std::span<const size_t> values, std::span<const double> weights);
+
+    /**
+     * @brief Returns whether there is nothing to sample (no value has a positive weight).
+     *
+     * @return true
+     * @return false
+     */
+    inline bool empty() const { return _values.empty(); }
+
+    /**
+     * @brief Returns the amount of values with a positive weight.
+     *
+     * @return size_t
+     */
+    inline size_t size() const { return _values.size(); }
+
+    /**
+     * @brief Draws a single value. Throws an std::runtime_error exception if the sampler is empty.
+     *
+     * @tparam URBG - uniform random bit generator
+     * @param gen - reference to the random generator to draw with
+     * @return size_t
+     */
+    template <typename URBG>
+    inline size_t operator()(URBG& gen) const
+    {
+        if (empty()) throw std::runtime_error(EMPTY_SAMPLER);
+        size_t column = std::uniform_int_distribution<size_t>{0, _values.size() - 1}(gen);
+        double coin = std::generate_canonical<double, 53>(gen);
+        return coin < _probabilities[column] ? _values[column] : _aliases[column];
+    }
+};
+
+#endif